@@ -1,436 +1,1096 @@
-
-// Make comments more similar
-
-#include "../src/include/json-parser.h"
-
-/*
-	> F001
-	Loads a JsonExpr from a string and print it to the console
-
-	INFO:
-
-	This function is an example of how to load a JsonExpr object from a string
-	This function exits with 0 memory leaks
-
-	RAW OUTPUT:
-
-	--> {"name": "John", "age": 30, "hobbies": ["Swimming", "Cycling"]}
-*/
-
-void F001() {
-	// Initialize
-
-	JsonHandler* handler = JsonCreateHandler();
-	const char* source = "{\"name\": \"John\", \"age\": 30, \"hobbies\": [\"Swimming\", \"Cycling\"]}";
-
-	// Load Expr & Error Checking
-
-	JsonExpr* expr = JsonLoadString(handler, source);
-
-	if (handler->Error->Exists) {
-		printf("Error: %s\n", handler->Error->DebugStr);
-		JsonDeleteHandler(handler);
-		return;
-	}
-
-	// Print Expr to Console
-
-	char* str;
-	JsonDumpString(expr, &str);
-	printf("--> %s\n", str);
-
-	// Memory Cleanup
-
-	JsonDeleteHandler(handler);
-	JsonDeleteExpr(expr);
-	free(str);
-}
-
-/*
-	> F002
-	Create Json Expr from scratch and print it to the console
-
-	INFO:
-
-	This function is an example of how to create a JsonExpr object from scratch
-	This function exits with 0 memory leaks
-
-	RAW OUTPUT:
-
-	--> {"name": "John", "age": 30}
-*/
-
-void F002() {
-	// Initialize
-
-	JsonExpr* expr = JsonCreateExpr();
-
-	// Attach to Expr
-
-	JsonSetString(expr, "name", "John");
-	JsonSetInt(expr, "age", 30);
-
-	// Print Expr to Console
-
-	char* str;
-	JsonDumpString(expr, &str);
-	printf("--> %s\n", str);
-
-	// Memory Cleanup
-
-	JsonDeleteExpr(expr);
-	free(str);
-}
-
-/*
-	> F003
-	Add a JsonList to a JsonExpr and print it to the console
-
-	INFO:
-	
-	This function is an example of how to attach a JsonList to a JsonExpr with a key to index it
-	This function exits with 0 memory leaks
-
-	RAW OUTPUT:
-
-	--> {"list-example": ["Swimming", "Cycling"]}
-*/
-
-void F003() {
-	// Initialize
-
-	JsonExpr* expr = JsonCreateExpr();
-
-	// Create Hobbies
-
-	JsonList* hobbies = JsonCreateList();
-	JsonAppendString(hobbies, "Swimming");
-	JsonAppendString(hobbies, "Cycling");
-	
-	// Attach to Expr
-
-	JsonSetList(expr, "list-example", hobbies);
-
-	// Print Expr to Console
-
-	char* str;
-	JsonDumpString(expr, &str);
-	printf("--> %s\n", str);
-
-	// Memory Cleanup
-
-	JsonDeleteExpr(expr);
-	free(str);
-}
-
-/*
-	> F004
-	Add a JsonExpr to a JsonExpr and print it to the console
-
-	INFO:
-
-	This function is an example of how to attach a JsonExpr to a JsonExpr with a key to index it
-	This function exits with 0 memory leaks
-
-	RAW OUTPUT:
-
-	--> {"expr-example": {"John": "Head Manager", "Mike": "Manager", "Jack": "Toilet Cleaner"}}
-*/
-
-void F004() {
-	// Initialize
-
-	JsonExpr* expr = JsonCreateExpr();
-
-	// Create Grades
-
-	JsonExpr* employees = JsonCreateExpr();
-	JsonSetString(employees, "John", "Head Manager");
-	JsonSetString(employees, "Mike", "Manager");
-	JsonSetString(employees, "Jack", "Toilet Cleaner");
-
-	// Attach to Expr
-
-	JsonSetExpr(expr, "expr-example", employees);
-
-	// Print Expr to Console
-
-	char* str;
-	JsonDumpString(expr, &str);
-	printf("--> %s\n", str);
-
-	// Memory Cleanup
-
-	JsonDeleteExpr(expr);
-	free(str);
-}
-
-/*
-	> F005
-	Remove an element from a JsonList and print it to the console
-
-	INFO:
-
-	This function is an example of how to remove an element from a JsonList with an integer to index it
-	This function exits with 0 memory leaks
-
-	RAW OUTPUT:
-
-	--> {"list-example": [1000, 3000, 4000]}
-*/
-
-void F005() {
-	// Initialize
-
-	JsonExpr* expr = JsonCreateExpr();
-
-	// Create List
-
-	JsonList* list = JsonCreateList();
-	JsonAppendInt(list, 1000);
-	JsonAppendInt(list, 2000); // This will be removed
-	JsonAppendInt(list, 3000);
-	JsonAppendInt(list, 4000);
-	
-	// Remove Element
-
-	JsonRemoveElement(list, 1);
-
-	// Attach to Expr
-
-	JsonSetList(expr, "list-example", list);
-
-	// Print Expr to Console
-
-	char* str;
-	JsonDumpString(expr, &str);
-	printf("--> %s\n", str);
-
-	// Memory Cleanup
-
-	JsonDeleteExpr(expr);
-	free(str);
-}
-
-/*
-	> F006
-	Remove a pair from a JsonExpr and print it to the console
-
-	INFO:
-
-	This function is an example of how to remove a pair from a JsonExpr with a key to index it
-	This function exits with 0 memory leaks
-
-	RAW OUTPUT:
-
-	--> {"one-thousand": 1000, "three-thousand": 3000, "four-thousand": 4000}
-*/
-
-void F006() {
-	// Initialize
-
-	JsonExpr* expr = JsonCreateExpr();
-
-	// Attach to Expr
-
-	JsonSetInt(expr, "one-thousand", 1000);
-	JsonSetInt(expr, "two-thousand", 2000); // This will be removed
-	JsonSetInt(expr, "three-thousand", 3000);
-	JsonSetInt(expr, "four-thousand", 4000);
-
-	// Remove Pair
-
-	JsonRemoveKey(expr, "two-thousand");
-
-	// Print Expr to Console
-
-	char* str;
-	JsonDumpString(expr, &str);
-	printf("--> %s\n", str);
-
-	// Memory Cleanup
-
-	JsonDeleteExpr(expr);
-	free(str);
-}
-
-/*
-	> F007
-	Merge two JsonList objects into one and print it to the console
-
-	INFO:
-
-	This function will merge two JsonList objects into one, by combining both of their elements
-	This function exits with 0 memory leaks
-	
-	RAW OUTPUT:
-
-	--> {"list-example": [1000, 2000, 3000, 4000]}
-*/
-
-void F007() {
-	// Create Json Expr
-
-	JsonExpr* expr = JsonCreateExpr();
-
-	// Create First List
-
-	JsonList* list = JsonCreateList();
-	JsonAppendInt(list, 1000);
-	JsonAppendInt(list, 2000);
-
-	// Create Second List
-
-	JsonList* list2 = JsonCreateList();
-	JsonAppendInt(list2, 3000);
-	JsonAppendInt(list2, 4000);
-
-	// Combine both Lists
-
-	JsonAddRange(list, list2, FALSE);
-
-	// Attach to Expr
-
-	JsonSetList(expr, "list-example", list);
-
-	// Print Expr to Console
-
-	char* str;
-	JsonDumpString(expr, &str);
-	printf("--> %s\n", str);
-
-	// Memory Cleanup
-
-	JsonDeleteExpr(expr);
-	free(str);
-}
-
-/*
-	> F008
-	Merge two JsonExpr objects into one and print it to the console
-
-	INFO:
-
-	This function will merge two JsonExpr objects into one, by combining both of their pairs
-	This function exits with 0 memory leaks
-
-	RAW OUTPUT:
-
-	--> {"name": "John", "age": 20, "dob": "16th March 1998"}
-*/
-
-void F008() {
-	// Create First Expr
-
-	JsonExpr* expr = JsonCreateExpr();
-	JsonSetString(expr, "name", "John");
-	JsonSetInt(expr, "age", 20);
-
-	// Create Second Expr
-
-	JsonExpr* expr2 = JsonCreateExpr();
-	JsonSetString(expr2, "dob", "16th March 1998");
-
-	// Combine both Exprs
-
-	JsonMerge(expr, expr2, FALSE);
-
-	// Print Expr to Console
-
-	char* str;
-	JsonDumpString(expr, &str);
-	printf("--> %s\n", str);
-
-	// Memory Cleanup
-
-	JsonDeleteExpr(expr);
-	free(str);
-}
-
-/*
-	> F009
-	Dump a JsonExpr object to a file
-
-	INFO:
-
-	This function will create a JsonExpr object and dump it to a file
-	This function exits with 0 memory leaks
-
-	RAW OUTPUT (IN FILE):
-
-	{"name": "John", "age": 20}
-*/
-
-void F009() {
-	// Initialize
-
-	const char* filepath = "file.json";
-
-	// Create Handler
-
-	JsonHandler* handler = JsonCreateHandler();
-
-	// Create Json Expr
-
-	JsonExpr* expr = JsonCreateExpr();
-	JsonSetString(expr, "name", "John");
-	JsonSetInt(expr, "age", 20);
-
-	// Write To File
-
-	JsonDumpFile(handler, expr, filepath);
-
-	if (handler->Error->Exists) {
-		printf("Error: %s\n", handler->Error->DebugStr);
-		JsonDeleteHandler(handler);
-		return;
-	}
-	else {
-		printf("Successfully wrote to file: %s\n", filepath);
-	}
-
-	// Memory Cleanup
-
-	JsonDeleteHandler(handler);
-	JsonDeleteExpr(expr);
-}
-
-/*
-	> F010
-	Load a JsonExpr object from a file
-
-	INFO:
-	This function will load a JsonExpr object from a file
-	This function exits with 0 memory leaks
-*/
-
-void F010() {
-	// Initialize
-
-	const char* filepath = "file.json";
-
-	// Create Handler
-
-	JsonHandler* handler = JsonCreateHandler();
-
-	// Load Expr & Error Checking
-
-	JsonExpr* expr = JsonLoadFile(handler, filepath);
-
-	if (handler->Error->Exists) {
-		printf("Error: %s\n", handler->Error->DebugStr);
-		JsonDeleteHandler(handler);
-		return;
-	}
-
-	// Print Expr to Console
-
-	char* str;
-	JsonDumpString(expr, &str);
-	printf("--> %s\n", str);
-
-	// Memory Cleanup
-
-	JsonDeleteExpr(expr);
-	free(str);
-}
+
+// Make comments more similar
+
+#include <string.h>
+#include "../src/include/json-parser.h"
+
+/*
+	> F001
+	Loads a JsonExpr from a string and print it to the console
+
+	INFO:
+
+	This function is an example of how to load a JsonExpr object from a string
+	This function exits with 0 memory leaks
+
+	RAW OUTPUT:
+
+	--> {"name": "John", "age": 30, "hobbies": ["Swimming", "Cycling"]}
+*/
+
+void F001() {
+	// Initialize
+
+	JsonHandler* handler = JsonCreateHandler();
+	const char* source = "{\"name\": \"John\", \"age\": 30, \"hobbies\": [\"Swimming\", \"Cycling\"]}";
+
+	// Load Expr & Error Checking
+
+	JsonExpr* expr = JsonLoadString(handler, source);
+
+	if (handler->Error->Exists) {
+		printf("Error: %s\n", handler->Error->DebugStr);
+		JsonDeleteHandler(handler);
+		return;
+	}
+
+	// Print Expr to Console
+
+	char* str;
+	JsonDumpString(expr, &str);
+	printf("--> %s\n", str);
+
+	// Memory Cleanup
+
+	JsonDeleteHandler(handler);
+	JsonDeleteExpr(expr);
+	free(str);
+}
+
+/*
+	> F002
+	Create Json Expr from scratch and print it to the console
+
+	INFO:
+
+	This function is an example of how to create a JsonExpr object from scratch
+	This function exits with 0 memory leaks
+
+	RAW OUTPUT:
+
+	--> {"name": "John", "age": 30}
+*/
+
+void F002() {
+	// Initialize
+
+	JsonExpr* expr = JsonCreateExpr();
+
+	// Attach to Expr
+
+	JsonSetString(expr, "name", "John");
+	JsonSetInt(expr, "age", 30);
+
+	// Print Expr to Console
+
+	char* str;
+	JsonDumpString(expr, &str);
+	printf("--> %s\n", str);
+
+	// Memory Cleanup
+
+	JsonDeleteExpr(expr);
+	free(str);
+}
+
+/*
+	> F003
+	Add a JsonList to a JsonExpr and print it to the console
+
+	INFO:
+	
+	This function is an example of how to attach a JsonList to a JsonExpr with a key to index it
+	This function exits with 0 memory leaks
+
+	RAW OUTPUT:
+
+	--> {"list-example": ["Swimming", "Cycling"]}
+*/
+
+void F003() {
+	// Initialize
+
+	JsonExpr* expr = JsonCreateExpr();
+
+	// Create Hobbies
+
+	JsonList* hobbies = JsonCreateList();
+	JsonAppendString(hobbies, "Swimming");
+	JsonAppendString(hobbies, "Cycling");
+	
+	// Attach to Expr
+
+	JsonSetList(expr, "list-example", hobbies);
+
+	// Print Expr to Console
+
+	char* str;
+	JsonDumpString(expr, &str);
+	printf("--> %s\n", str);
+
+	// Memory Cleanup
+
+	JsonDeleteExpr(expr);
+	free(str);
+}
+
+/*
+	> F004
+	Add a JsonExpr to a JsonExpr and print it to the console
+
+	INFO:
+
+	This function is an example of how to attach a JsonExpr to a JsonExpr with a key to index it
+	This function exits with 0 memory leaks
+
+	RAW OUTPUT:
+
+	--> {"expr-example": {"John": "Head Manager", "Mike": "Manager", "Jack": "Toilet Cleaner"}}
+*/
+
+void F004() {
+	// Initialize
+
+	JsonExpr* expr = JsonCreateExpr();
+
+	// Create Grades
+
+	JsonExpr* employees = JsonCreateExpr();
+	JsonSetString(employees, "John", "Head Manager");
+	JsonSetString(employees, "Mike", "Manager");
+	JsonSetString(employees, "Jack", "Toilet Cleaner");
+
+	// Attach to Expr
+
+	JsonSetExpr(expr, "expr-example", employees);
+
+	// Print Expr to Console
+
+	char* str;
+	JsonDumpString(expr, &str);
+	printf("--> %s\n", str);
+
+	// Memory Cleanup
+
+	JsonDeleteExpr(expr);
+	free(str);
+}
+
+/*
+	> F005
+	Remove an element from a JsonList and print it to the console
+
+	INFO:
+
+	This function is an example of how to remove an element from a JsonList with an integer to index it
+	This function exits with 0 memory leaks
+
+	RAW OUTPUT:
+
+	--> {"list-example": [1000, 3000, 4000]}
+*/
+
+void F005() {
+	// Initialize
+
+	JsonExpr* expr = JsonCreateExpr();
+
+	// Create List
+
+	JsonList* list = JsonCreateList();
+	JsonAppendInt(list, 1000);
+	JsonAppendInt(list, 2000); // This will be removed
+	JsonAppendInt(list, 3000);
+	JsonAppendInt(list, 4000);
+	
+	// Remove Element
+
+	JsonRemoveElement(list, 1);
+
+	// Attach to Expr
+
+	JsonSetList(expr, "list-example", list);
+
+	// Print Expr to Console
+
+	char* str;
+	JsonDumpString(expr, &str);
+	printf("--> %s\n", str);
+
+	// Memory Cleanup
+
+	JsonDeleteExpr(expr);
+	free(str);
+}
+
+/*
+	> F006
+	Remove a pair from a JsonExpr and print it to the console
+
+	INFO:
+
+	This function is an example of how to remove a pair from a JsonExpr with a key to index it
+	This function exits with 0 memory leaks
+
+	RAW OUTPUT:
+
+	--> {"one-thousand": 1000, "three-thousand": 3000, "four-thousand": 4000}
+*/
+
+void F006() {
+	// Initialize
+
+	JsonExpr* expr = JsonCreateExpr();
+
+	// Attach to Expr
+
+	JsonSetInt(expr, "one-thousand", 1000);
+	JsonSetInt(expr, "two-thousand", 2000); // This will be removed
+	JsonSetInt(expr, "three-thousand", 3000);
+	JsonSetInt(expr, "four-thousand", 4000);
+
+	// Remove Pair
+
+	JsonRemoveKey(expr, "two-thousand");
+
+	// Print Expr to Console
+
+	char* str;
+	JsonDumpString(expr, &str);
+	printf("--> %s\n", str);
+
+	// Memory Cleanup
+
+	JsonDeleteExpr(expr);
+	free(str);
+}
+
+/*
+	> F007
+	Merge two JsonList objects into one and print it to the console
+
+	INFO:
+
+	This function will merge two JsonList objects into one, by combining both of their elements
+	This function exits with 0 memory leaks
+	
+	RAW OUTPUT:
+
+	--> {"list-example": [1000, 2000, 3000, 4000]}
+*/
+
+void F007() {
+	// Create Json Expr
+
+	JsonExpr* expr = JsonCreateExpr();
+
+	// Create First List
+
+	JsonList* list = JsonCreateList();
+	JsonAppendInt(list, 1000);
+	JsonAppendInt(list, 2000);
+
+	// Create Second List
+
+	JsonList* list2 = JsonCreateList();
+	JsonAppendInt(list2, 3000);
+	JsonAppendInt(list2, 4000);
+
+	// Combine both Lists
+
+	JsonAddRange(list, list2, FALSE);
+
+	// Attach to Expr
+
+	JsonSetList(expr, "list-example", list);
+
+	// Print Expr to Console
+
+	char* str;
+	JsonDumpString(expr, &str);
+	printf("--> %s\n", str);
+
+	// Memory Cleanup
+
+	JsonDeleteExpr(expr);
+	free(str);
+}
+
+/*
+	> F008
+	Merge two JsonExpr objects into one and print it to the console
+
+	INFO:
+
+	This function will merge two JsonExpr objects into one, by combining both of their pairs
+	This function exits with 0 memory leaks
+
+	RAW OUTPUT:
+
+	--> {"name": "John", "age": 20, "dob": "16th March 1998"}
+*/
+
+void F008() {
+	// Create First Expr
+
+	JsonExpr* expr = JsonCreateExpr();
+	JsonSetString(expr, "name", "John");
+	JsonSetInt(expr, "age", 20);
+
+	// Create Second Expr
+
+	JsonExpr* expr2 = JsonCreateExpr();
+	JsonSetString(expr2, "dob", "16th March 1998");
+
+	// Combine both Exprs
+
+	JsonMerge(expr, expr2, FALSE);
+
+	// Print Expr to Console
+
+	char* str;
+	JsonDumpString(expr, &str);
+	printf("--> %s\n", str);
+
+	// Memory Cleanup
+
+	JsonDeleteExpr(expr);
+	free(str);
+}
+
+/*
+	> F009
+	Dump a JsonExpr object to a file
+
+	INFO:
+
+	This function will create a JsonExpr object and dump it to a file
+	This function exits with 0 memory leaks
+
+	RAW OUTPUT (IN FILE):
+
+	{"name": "John", "age": 20}
+*/
+
+void F009() {
+	// Initialize
+
+	const char* filepath = "file.json";
+
+	// Create Handler
+
+	JsonHandler* handler = JsonCreateHandler();
+
+	// Create Json Expr
+
+	JsonExpr* expr = JsonCreateExpr();
+	JsonSetString(expr, "name", "John");
+	JsonSetInt(expr, "age", 20);
+
+	// Write To File
+
+	JsonDumpFile(handler, expr, filepath);
+
+	if (handler->Error->Exists) {
+		printf("Error: %s\n", handler->Error->DebugStr);
+		JsonDeleteHandler(handler);
+		return;
+	}
+	else {
+		printf("Successfully wrote to file: %s\n", filepath);
+	}
+
+	// Memory Cleanup
+
+	JsonDeleteHandler(handler);
+	JsonDeleteExpr(expr);
+}
+
+/*
+	> F010
+	Load a JsonExpr object from a file
+
+	INFO:
+	This function will load a JsonExpr object from a file
+	This function exits with 0 memory leaks
+*/
+
+void F010() {
+	// Initialize
+
+	const char* filepath = "file.json";
+
+	// Create Handler
+
+	JsonHandler* handler = JsonCreateHandler();
+
+	// Load Expr & Error Checking
+
+	JsonExpr* expr = JsonLoadFile(handler, filepath);
+
+	if (handler->Error->Exists) {
+		printf("Error: %s\n", handler->Error->DebugStr);
+		JsonDeleteHandler(handler);
+		return;
+	}
+
+	// Print Expr to Console
+
+	char* str;
+	JsonDumpString(expr, &str);
+	printf("--> %s\n", str);
+
+	// Memory Cleanup
+
+	JsonDeleteExpr(expr);
+	free(str);
+}
+
+/*
+	> F011
+	Dump a JsonExpr loaded from a string and load the dump back in
+
+	INFO:
+
+	This function checks that dumping and loading again gives back the same document, escapes included. The \u0000
+	and \u00e9 escapes are read into the strings and written back out as \u0000 and as the UTF-8 of 'é'
+	This function exits with 0 memory leaks
+
+	RAW OUTPUT:
+
+	--> {"text": "tab\t quote\" nul\u0000 é", "numbers": [1, -2, 3.5], "nested": {"empty": [], "null": null}}
+	--> Same document: yes
+	--> Same string: yes
+*/
+
+void F011() {
+	// Initialize
+
+	JsonHandler* handler = JsonCreateHandler();
+	const char* source = "{\"text\": \"tab\\t quote\\\" nul\\u0000 \\u00e9\", \"numbers\": [1, -2, 3.5], \"nested\": {\"empty\": [], \"null\": null}}";
+
+	// Load Expr & Error Checking
+
+	JsonExpr* expr = JsonLoadString(handler, source);
+
+	if (handler->Error->Exists) {
+		printf("Error: %s\n", handler->Error->DebugStr);
+		JsonDeleteHandler(handler);
+		return;
+	}
+
+	// Dump Expr & Load It Back
+
+	const char* str;
+	JsonDumpString(expr, &str);
+	printf("--> %s\n", str);
+
+	JsonExpr* copy = JsonLoadString(handler, str);
+
+	if (handler->Error->Exists) {
+		printf("Error: %s\n", handler->Error->DebugStr);
+		JsonDeleteHandler(handler);
+		JsonDeleteExpr(expr);
+		free((char*)str);
+		return;
+	}
+
+	// Compare Both Exprs & Both Dumps
+
+	const char* str2;
+	JsonDumpString(copy, &str2);
+
+	printf("--> Same document: %s\n", JsonCompareExprs(expr, copy) ? "yes" : "no");
+	printf("--> Same string: %s\n", strcmp(str, str2) == 0 ? "yes" : "no");
+
+	// Memory Cleanup
+
+	JsonDeleteHandler(handler);
+	JsonDeleteExpr(expr);
+	JsonDeleteExpr(copy);
+	free((char*)str);
+	free((char*)str2);
+}
+
+/*
+	> F012
+	Dump a JsonExpr with sorted keys, compact and pretty printed
+
+	INFO:
+
+	This function is an example of how to dump with JsonDumpOptions. Sorting the keys does not change the order the
+	pairs are stored in, and dumping on several threads gives the same string as dumping on one
+	This function exits with 0 memory leaks
+
+	RAW OUTPUT:
+
+	--> {"alpha":{"x":1,"y":2},"beta":[3,4],"gamma":"g"}
+	--> {
+	-->   "alpha": {
+	-->     "x": 1,
+	-->     "y": 2
+	-->   },
+	-->   "beta": [
+	-->     3,
+	-->     4
+	-->   ],
+	-->   "gamma": "g"
+	--> }
+	--> Same on 4 threads: yes
+*/
+
+void F012() {
+	// Initialize
+
+	JsonHandler* handler = JsonCreateHandler();
+	const char* source = "{\"gamma\": \"g\", \"alpha\": {\"y\": 2, \"x\": 1}, \"beta\": [3, 4]}";
+
+	// Load Expr & Error Checking
+
+	JsonExpr* expr = JsonLoadString(handler, source);
+
+	if (handler->Error->Exists) {
+		printf("Error: %s\n", handler->Error->DebugStr);
+		JsonDeleteHandler(handler);
+		return;
+	}
+
+	// Dump Compact With Sorted Keys
+
+	JsonDumpOptions options = { 0 };
+	options.Compact = TRUE;
+	options.SortKeys = TRUE;
+
+	const char* str;
+	JsonDumpStringEx(expr, &options, &str);
+	printf("--> %s\n", str);
+	free((char*)str);
+
+	// Dump Pretty Printed With Sorted Keys
+
+	options.Compact = FALSE;
+	options.Indent = 2;
+
+	JsonDumpStringEx(expr, &options, &str);
+
+	for (const char* line = str; line != NULL; ) {
+		const char* end = strchr(line, '\n');
+		printf("--> %.*s\n", (int)(end != NULL ? end - line : strlen(line)), line);
+		line = end != NULL ? end + 1 : NULL;
+	}
+
+	// Dump On Several Threads
+
+	const char* str2;
+	JsonDumpStringParallel(expr, &options, 4, &str2);
+	printf("--> Same on 4 threads: %s\n", strcmp(str, str2) == 0 ? "yes" : "no");
+
+	// Memory Cleanup
+
+	JsonDeleteHandler(handler);
+	JsonDeleteExpr(expr);
+	free((char*)str);
+	free((char*)str2);
+}
+
+/*
+	> F013
+	Dump two equal JsonExprs in canonical form and hash them
+
+	INFO:
+
+	This function is an example of canonical output (RFC 8785). The two sources hold the same data with their keys
+	in a different order and their numbers and strings written differently, so their canonical dumps and canonical
+	hashes are the same. Canonical keys are sorted by UTF-16 code units, so "😀" (surrogates 0xD83D 0xDE00) comes
+	before "ｚ" (0xFF5A) even though its code point is bigger
+	This function exits with 0 memory leaks
+
+	RAW OUTPUT:
+
+	--> {"a":100,"😀":2.5,"ｚ":1}
+	--> {"a":100,"😀":2.5,"ｚ":1}
+	--> Same hash: yes
+*/
+
+void F013() {
+	// Initialize
+
+	JsonHandler* handler = JsonCreateHandler();
+	const char* source = "{\"\xef\xbd\x9a\": 1, \"\xf0\x9f\x98\x80\": 2.50, \"a\": 100.0}";
+	const char* source2 = "{\"a\": 100, \"\\ud83d\\ude00\": 2.5, \"\\uff5a\": 1.0}";
+
+	// Load Exprs & Error Checking
+
+	JsonExpr* expr = JsonLoadString(handler, source);
+
+	if (handler->Error->Exists) {
+		printf("Error: %s\n", handler->Error->DebugStr);
+		JsonDeleteHandler(handler);
+		return;
+	}
+
+	JsonExpr* expr2 = JsonLoadString(handler, source2);
+
+	if (handler->Error->Exists) {
+		printf("Error: %s\n", handler->Error->DebugStr);
+		JsonDeleteHandler(handler);
+		JsonDeleteExpr(expr);
+		return;
+	}
+
+	// Dump Both Exprs In Canonical Form
+
+	JsonDumpOptions options = { 0 };
+	options.Canonical = TRUE;
+
+	const char* str;
+	const char* str2;
+	JsonDumpStringEx(expr, &options, &str);
+	JsonDumpStringEx(expr2, &options, &str2);
+	printf("--> %s\n", str);
+	printf("--> %s\n", str2);
+
+	// Compare Canonical Hashes
+
+	printf("--> Same hash: %s\n", JsonCanonicalHash(expr, 0) == JsonCanonicalHash(expr2, 0) ? "yes" : "no");
+
+	// Memory Cleanup
+
+	JsonDeleteHandler(handler);
+	JsonDeleteExpr(expr);
+	JsonDeleteExpr(expr2);
+	free((char*)str);
+	free((char*)str2);
+}
+
+/*
+	> F014
+	Reduce a JsonList of numbers stored as JsonValues and stored packed
+
+	INFO:
+
+	This function is an example of list reductions. The list is loaded twice, once into JsonValues and once packed
+	into a JsonInt array (see PackNumericLists), and both give the same count, sum, min, max and mean. The sum does
+	not fit in a JsonInt, so it is worked out as a JsonFloat instead of wrapping around
+	This function exits with 0 memory leaks
+
+	RAW OUTPUT:
+
+	--> Unpacked: count 4, sum 18446744073709543424, min 4611686018427379712, max 4611686018427387904, mean 4611686018427385856
+	--> Packed: count 4, sum 18446744073709543424, min 4611686018427379712, max 4611686018427387904, mean 4611686018427385856
+	--> Same reduction: yes
+*/
+
+void F014() {
+	// Initialize
+
+	JsonHandler* handler = JsonCreateHandler();
+	const char* source = "{\"values\": [4611686018427387904, 4611686018427387904, 4611686018427387904, 4611686018427379712]}";
+	JsonReduction reductions[2];
+
+	for (int packed = FALSE; packed <= TRUE; packed++) {
+		// Load Expr & Error Checking
+
+		handler->PackNumericLists = packed;
+		JsonExpr* expr = JsonLoadString(handler, source);
+
+		if (handler->Error->Exists) {
+			printf("Error: %s\n", handler->Error->DebugStr);
+			JsonDeleteHandler(handler);
+			return;
+		}
+
+		// Reduce List
+
+		JsonList* list;
+		JsonReduction* reduction = &reductions[packed];
+
+		if (JsonGetList(expr, "values", &list)) {
+			JsonListReduce(list, reduction);
+			printf(
+				"--> %s: count %llu, sum %.0Lf, min %.0Lf, max %.0Lf, mean %.0Lf\n",
+				list->Packing == JSON_PACKED_NONE ? "Unpacked" : "Packed",
+				reduction->Count,
+				(long double)reduction->Sum,
+				(long double)reduction->Min,
+				(long double)reduction->Max,
+				(long double)reduction->Mean
+			);
+		}
+
+		JsonDeleteExpr(expr);
+	}
+
+	int same = reductions[0].Count == reductions[1].Count
+		&& reductions[0].Sum == reductions[1].Sum
+		&& reductions[0].Min == reductions[1].Min
+		&& reductions[0].Max == reductions[1].Max
+		&& reductions[0].Mean == reductions[1].Mean;
+
+	printf("--> Same reduction: %s\n", same ? "yes" : "no");
+
+	// Memory Cleanup
+
+	JsonDeleteHandler(handler);
+}
+
+/*
+	> F015
+	Extract typed columns from a list of JsonExprs
+
+	INFO:
+
+	This function is an example of columnar extraction. The columns are read straight from the source with
+	JsonLoadColumns() and from a loaded JsonList with JsonListToColumns(), which give the same columns. Rows without
+	a key are null, and a key which was never given a value gives a null column
+	This function exits with 0 memory leaks
+
+	RAW OUTPUT:
+
+	--> id (int): 1, 2, 3
+	--> name (string): "ann", null, "c\u0000d"
+	--> score (float): 1.5, 2, null
+	--> active (bool): true, false, null
+	--> missing (null): null, null, null
+	--> Same columns: yes
+*/
+
+void F015() {
+	// Initialize
+
+	JsonHandler* handler = JsonCreateHandler();
+	const char* keys[] = { "id", "name", "score", "active", "missing" };
+	const char* types[] = { "null", "int", "float", "bool", "string" };
+	const char* rows = "[{\"id\": 1, \"name\": \"ann\", \"score\": 1.5, \"active\": true}, {\"id\": 2, \"score\": 2, \"active\": false}, {\"id\": 3, \"name\": \"c\\u0000d\"}]";
+	const char* source = "{\"rows\": [{\"id\": 1, \"name\": \"ann\", \"score\": 1.5, \"active\": true}, {\"id\": 2, \"score\": 2, \"active\": false}, {\"id\": 3, \"name\": \"c\\u0000d\"}]}";
+
+	// Load Columns From Source & Error Checking
+
+	JsonColumns* columns = JsonLoadColumns(handler, rows, keys, 5);
+
+	if (handler->Error->Exists) {
+		printf("Error: %s\n", handler->Error->DebugStr);
+		JsonDeleteHandler(handler);
+		return;
+	}
+
+	// Print Columns
+
+	for (ullong k = 0; k < columns->Count; k++) {
+		JsonColumn* column = &columns->Columns[k];
+		printf("--> %s (%s): ", column->Key, types[column->Type]);
+
+		for (ullong i = 0; i < column->Length; i++) {
+			printf(i > 0 ? ", " : "");
+
+			if (!(column->Validity[i / 8] & (1 << (i % 8)))) {
+				printf("null");
+			}
+			else if (column->Type == JSON_COLUMN_INT) {
+				printf("%lld", ((JsonInt*)column->Values)[i]);
+			}
+			else if (column->Type == JSON_COLUMN_FLOAT) {
+				printf("%g", ((double*)column->Values)[i]);
+			}
+			else if (column->Type == JSON_COLUMN_BOOL) {
+				printf(((unsigned char*)column->Values)[i / 8] & (1 << (i % 8)) ? "true" : "false");
+			}
+			else {
+				llong* offsets = column->Values;
+				printf("\"");
+
+				for (llong c = offsets[i]; c < offsets[i + 1]; c++) {
+					printf(column->Data[c] == '\0' ? "\\u0000" : "%c", column->Data[c]);
+				}
+
+				printf("\"");
+			}
+		}
+
+		printf("\n");
+	}
+
+	// Extract Columns From A Loaded List
+
+	JsonExpr* expr = JsonLoadString(handler, source);
+
+	if (handler->Error->Exists) {
+		printf("Error: %s\n", handler->Error->DebugStr);
+		JsonDeleteHandler(handler);
+		JsonColumnsDelete(columns);
+		return;
+	}
+
+	JsonList* list;
+	int same = FALSE;
+
+	if (JsonGetList(expr, "rows", &list)) {
+		JsonColumns* columns2 = JsonListToColumns(list, keys, 5);
+		same = columns2->Length == columns->Length;
+
+		for (ullong k = 0; same && k < columns->Count; k++) {
+			JsonColumn* column = &columns->Columns[k];
+			JsonColumn* column2 = &columns2->Columns[k];
+			ullong values = column->Type == JSON_COLUMN_BOOL
+				? (column->Length + 7) / 8
+				: 8 * (column->Length + (column->Type == JSON_COLUMN_STRING));
+
+			same = column->Type == column2->Type
+				&& column->NullCount == column2->NullCount
+				&& memcmp(column->Validity, column2->Validity, (column->Length + 7) / 8) == 0
+				&& (column->Type == JSON_COLUMN_NULL || memcmp(column->Values, column2->Values, values) == 0)
+				&& column->DataLength == column2->DataLength
+				&& (column->DataLength == 0 || memcmp(column->Data, column2->Data, column->DataLength) == 0);
+		}
+
+		JsonColumnsDelete(columns2);
+	}
+
+	printf("--> Same columns: %s\n", same ? "yes" : "no");
+
+	// Memory Cleanup
+
+	JsonDeleteHandler(handler);
+	JsonDeleteExpr(expr);
+	JsonColumnsDelete(columns);
+}
+
+/*
+	> F016
+	Dump a list of JsonExprs to an Arrow IPC file
+
+	INFO:
+
+	This function will dump the "id", "name" and "score" keys of a list of records to an Apache Arrow IPC file
+	(Feather v2), which can be read with e.g. pyarrow.feather.read_table("records.arrow"). The file is read back
+	in to check that it starts and ends with the Arrow magic bytes
+	This function exits with 0 memory leaks
+
+	RAW OUTPUT:
+
+	--> Successfully wrote to file: records.arrow
+	--> Arrow magic at start and end: yes
+*/
+
+void F016() {
+	// Initialize
+
+	const char* filepath = "records.arrow";
+	const char* keys[] = { "id", "name", "score" };
+	const char* source = "{\"rows\": [{\"id\": 1, \"name\": \"ann\", \"score\": 1.5}, {\"id\": 2, \"name\": \"bob\"}, {\"id\": 3, \"score\": 4}]}";
+
+	// Create Handler
+
+	JsonHandler* handler = JsonCreateHandler();
+
+	// Load Expr & Error Checking
+
+	JsonExpr* expr = JsonLoadString(handler, source);
+
+	if (handler->Error->Exists) {
+		printf("Error: %s\n", handler->Error->DebugStr);
+		JsonDeleteHandler(handler);
+		return;
+	}
+
+	// Write To File
+
+	JsonList* list;
+
+	if (JsonGetList(expr, "rows", &list)) {
+		JsonDumpArrow(handler, list, keys, 3, filepath);
+	}
+
+	if (handler->Error->Exists) {
+		printf("Error: %s\n", handler->Error->DebugStr);
+		JsonDeleteHandler(handler);
+		JsonDeleteExpr(expr);
+		return;
+	}
+	else {
+		printf("--> Successfully wrote to file: %s\n", filepath);
+	}
+
+	// Check Magic Bytes
+
+	FILE* file = fopen(filepath, "rb");
+	int magic = FALSE;
+
+	if (file != NULL) {
+		char start[6];
+		char end[6];
+
+		magic = fread(start, 1, sizeof(start), file) == sizeof(start)
+			&& fseek(file, -(long)sizeof(end), SEEK_END) == 0
+			&& fread(end, 1, sizeof(end), file) == sizeof(end)
+			&& memcmp(start, "ARROW1", 6) == 0
+			&& memcmp(end, "ARROW1", 6) == 0;
+
+		fclose(file);
+	}
+
+	printf("--> Arrow magic at start and end: %s\n", magic ? "yes" : "no");
+
+	// Memory Cleanup
+
+	JsonDeleteHandler(handler);
+	JsonDeleteExpr(expr);
+}
+
+/*
+	> F017
+	Write a document with a JsonWriter and make the calls it rejects
+
+	INFO:
+
+	This function is an example of how to write JSON piece by piece with a JsonWriter, without building a JsonExpr.
+	A call which does not fit where the JsonWriter is in the document returns FAILURE and raises an error, after
+	which the JsonWriter writes nothing more and JsonWriterFinish() returns NULL
+	This function exits with 0 memory leaks
+
+	RAW OUTPUT:
+
+	--> {"name": "ann", "tags": ["a", 2, null]}
+	--> Key inside of a list: cannot write a key here
+	--> End of a list inside of an expr: cannot write the end of a list here
+	--> Value after the document: cannot write a value here
+	--> Unfinished document: NULL
+*/
+
+void F017() {
+	// Write A Document
+
+	JsonWriter* writer = JsonWriterInit(NULL);
+
+	JsonWriterBeginExpr(writer);
+	JsonWriterKey(writer, "name");
+	JsonWriterString(writer, "ann");
+	JsonWriterKey(writer, "tags");
+	JsonWriterBeginList(writer);
+	JsonWriterString(writer, "a");
+	JsonWriterInt(writer, 2);
+	JsonWriterNull(writer);
+	JsonWriterEndList(writer);
+	JsonWriterEndExpr(writer);
+
+	char* str = JsonWriterFinish(writer);
+	printf("--> %s\n", str);
+	JsonFree(str);
+
+	// Write A Key Inside Of A List
+
+	writer = JsonWriterInit(NULL);
+	JsonWriterBeginList(writer);
+
+	if (!JsonWriterKey(writer, "key")) {
+		printf("--> Key inside of a list: %s\n", writer->Error->DebugStr);
+	}
+
+	JsonFree(JsonWriterFinish(writer));
+
+	// End A List Inside Of An Expr
+
+	writer = JsonWriterInit(NULL);
+	JsonWriterBeginExpr(writer);
+
+	if (!JsonWriterEndList(writer)) {
+		printf("--> End of a list inside of an expr: %s\n", writer->Error->DebugStr);
+	}
+
+	JsonFree(JsonWriterFinish(writer));
+
+	// Write A Value After The Document
+
+	writer = JsonWriterInit(NULL);
+	JsonWriterInt(writer, 1);
+
+	if (!JsonWriterInt(writer, 2)) {
+		printf("--> Value after the document: %s\n", writer->Error->DebugStr);
+	}
+
+	JsonFree(JsonWriterFinish(writer));
+
+	// Finish An Unfinished Document
+
+	writer = JsonWriterInit(NULL);
+	JsonWriterBeginList(writer);
+	JsonWriterInt(writer, 1);
+
+	str = JsonWriterFinish(writer);
+	printf("--> Unfinished document: %s\n", str != NULL ? str : "NULL");
+	JsonFree(str);
+}
+
+/*
+	> F018
+	Copy a JsonExpr and edit the lists and exprs nested inside of the copy
+
+	INFO:
+
+	This function is an example of copying a document and editing the copy without changing the original. The
+	nested JsonExpr is reached through a JsonList of the copy, edited, and the same is done through a copy of the
+	JsonList on its own. The original is printed after each edit and stays the same
+	This function exits with 0 memory leaks
+
+	RAW OUTPUT:
+
+	--> Copy: {"items": [{"a": 99}, {"a": 2}]}
+	--> Original: {"items": [{"a": 1}, {"a": 2}]}
+	--> List copy: [{"a": 1}, {"a": 42}]
+	--> Original: {"items": [{"a": 1}, {"a": 2}]}
+	--> Original unchanged: yes
+*/
+
+void F018() {
+	// Initialize
+
+	JsonHandler* handler = JsonCreateHandler();
+	const char* source = "{\"items\": [{\"a\": 1}, {\"a\": 2}]}";
+
+	// Load Expr & Error Checking
+
+	JsonExpr* expr = JsonLoadString(handler, source);
+
+	if (handler->Error->Exists) {
+		printf("Error: %s\n", handler->Error->DebugStr);
+		JsonDeleteHandler(handler);
+		return;
+	}
+
+	JsonExpr* original = JsonLoadString(handler, source);
+
+	// Edit A Nested Expr Through A Copy
+
+	JsonExpr* copy = JsonExprCopy(expr);
+	JsonList* list;
+
+	if (JsonGetList(copy, "items", &list)) {
+		JsonSetInt(list->Buffer[0].Data->Expr, "a", 99);
+	}
+
+	const char* str;
+	JsonDumpString(copy, &str);
+	printf("--> Copy: %s\n", str);
+	free((char*)str);
+
+	JsonDumpString(expr, &str);
+	printf("--> Original: %s\n", str);
+	free((char*)str);
+
+	// Edit A Nested Expr Through A Copy Of A List
+
+	if (JsonGetList(expr, "items", &list)) {
+		JsonList* listCopy = JsonListCopy(list);
+		JsonSetInt(listCopy->Buffer[1].Data->Expr, "a", 42);
+
+		str = SerialiseJsonList(listCopy);
+		printf("--> List copy: %s\n", str);
+		free((char*)str);
+		JsonListDelete(listCopy);
+	}
+
+	JsonDumpString(expr, &str);
+	printf("--> Original: %s\n", str);
+	free((char*)str);
+
+	// Compare With The Original
+
+	printf("--> Original unchanged: %s\n", JsonCompareExprs(expr, original) ? "yes" : "no");
+
+	// Memory Cleanup
+
+	JsonDeleteHandler(handler);
+	JsonDeleteExpr(expr);
+	JsonDeleteExpr(copy);
+	JsonDeleteExpr(original);
+}
@@ -0,0 +1,486 @@
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "include/allocator.h"
+
+#ifdef _MSC_VER
+#include <windows.h>
+#else
+#include <stdatomic.h>
+#endif
+
+#define TRUE 1
+#define FALSE 0
+
+/*
+	Default Allocator
+
+	FUNCTIONS:
+
+	> DefaultAlloc(), DefaultRealloc(), DefaultFree()
+	Forward to malloc(), realloc() and free() from the C standard library
+
+	NOTES:
+
+	DefaultAllocator is used by every thread until JsonUseAllocator() is called on it, so the library behaves the
+	same as the C standard library unless an allocator is set
+*/
+
+static void* DefaultAlloc(void* user, ullong size) {
+	(void)user;
+	return malloc(size);
+}
+
+static void* DefaultRealloc(void* user, void* ptr, ullong size) {
+	(void)user;
+	return realloc(ptr, size);
+}
+
+static void DefaultFree(void* user, void* ptr) {
+	(void)user;
+	free(ptr);
+}
+
+static JsonAllocator DefaultAllocator = {
+	DefaultAlloc,
+	DefaultRealloc,
+	DefaultFree,
+	NULL
+};
+
+static JSON_THREAD_LOCAL JsonAllocator* ThreadAllocator = NULL;
+static JSON_THREAD_LOCAL JsonAllocator* CurrentAllocator = NULL;
+
+/*
+	Node Pool Storage
+
+	MACROS:
+
+	> POOL_GRANULARITY
+	Size in bytes which separates two size classes
+
+	> POOL_CLASS_COUNT
+	Number of size classes, blocks larger than POOL_GRANULARITY * POOL_CLASS_COUNT bytes are never pooled
+
+	> POOL_LIMIT
+	Maximum number of free blocks kept in a single size class, blocks freed past this go back to the allocator
+
+	> PoolClass()
+	Gets the index of the size class a block of 'size' bytes belongs to
+
+	> PoolAllocator()
+	Gets the allocator the calling thread's free lists hold blocks of, which is the one set with JsonUseAllocator()
+
+	NOTES:
+
+	Each size class is a singly linked free list threaded through the free blocks themselves, so it takes no memory
+	beyond the blocks. There is one set of free lists per thread and they are never locked
+*/
+
+#define POOL_GRANULARITY 8
+#define POOL_CLASS_COUNT 8
+#define POOL_LIMIT 4096
+
+#define PoolClass(size) (((size) + POOL_GRANULARITY - 1) / POOL_GRANULARITY - 1)
+#define PoolAllocator() (ThreadAllocator != NULL ? ThreadAllocator : &DefaultAllocator)
+
+typedef struct PoolBlock_t {
+	struct PoolBlock_t* Next;
+} PoolBlock;
+
+typedef struct {
+	PoolBlock* Head;
+	ullong Length;
+} Pool;
+
+static JSON_THREAD_LOCAL Pool Pools[POOL_CLASS_COUNT];
+
+/*
+	Region Storage
+
+	MACROS:
+
+	> RegionIncrement(), RegionDecrement()
+	Atomically add one to or remove one from a JsonRegion's Live count, RegionDecrement() gives the new count
+
+	> RegionContains()
+	Checks whether 'ptr' is one of the blocks a JsonRegion handed out
+
+	> IsRegion()
+	Checks whether an allocator is the Interface of a JsonRegion
+*/
+
+#ifdef _MSC_VER
+#define RegionIncrement(region) InterlockedIncrement64((volatile LONG64*)&(region)->Live)
+#define RegionDecrement(region) ((ullong)InterlockedDecrement64((volatile LONG64*)&(region)->Live))
+#else
+#define RegionIncrement(region) atomic_fetch_add(&(region)->Live, 1)
+#define RegionDecrement(region) (atomic_fetch_sub(&(region)->Live, 1) - 1)
+#endif
+
+#define RegionContains(region, ptr) \
+	((const char*)(ptr) >= (region)->Buffer && (const char*)(ptr) < (region)->Buffer + (region)->Capacity)
+
+#define IsRegion(allocator) ((allocator)->Alloc == RegionAlloc)
+
+static void* RegionAlloc(void* user, ullong size);
+
+/*
+	Selecting Allocators
+
+	FUNCTIONS:
+
+	> JsonUseAllocator()
+	Sets the allocator used by the library on the calling thread and returns the one which was used before, so that
+	it can be restored. Passing NULL selects the default allocator
+
+	> JsonSelectAllocator()
+	Selects an allocator on the calling thread for the length of one operation and returns the one which was
+	selected before, which has to be selected again once the operation is done. Unlike JsonUseAllocator() it leaves
+	the node pools alone, so it is cheap enough to call around every function which works on a document
+	Functions which take a JsonHandler select the handler's allocator, and functions which take a JsonList or
+	JsonExpr select the allocator it was created with (see JsonValueArray.Allocator)
+
+	> JsonGetAllocator()
+	Returns the allocator used by the library on the calling thread
+
+	NOTES:
+
+	Switching to a different allocator with JsonUseAllocator() releases the calling thread's node pools to the
+	allocator which was in use. The pools only hand out and take back blocks while that same allocator is selected,
+	so a pooled block is always handed out by the allocator which allocated it
+
+	Every JsonList and JsonExpr remembers the allocator which was selected when it was created, so a document loaded
+	with a handler's allocator is modified, copied and deleted with that allocator whichever one the calling thread
+	uses. JsonValues passed to JsonSet() or JsonAppend() have to be created while the document's allocator is
+	selected, as they become part of the document. Lists and exprs passed to JsonSetList(), JsonSetExpr(),
+	JsonAppendList() and JsonAppendExpr() keep their own allocator
+
+	WARNING:
+
+	Memory has to be freed by the allocator which allocated it, and an allocator has to stay alive until every
+	document created with it is deleted
+*/
+
+JsonAllocator* JsonUseAllocator(JsonAllocator* allocator) {
+	JsonAllocator* previous = JsonGetAllocator();
+
+	if ((allocator != NULL ? allocator : &DefaultAllocator) != PoolAllocator()) {
+		JsonPoolTrim();
+	}
+
+	ThreadAllocator = allocator;
+	CurrentAllocator = allocator;
+
+	return previous;
+}
+
+JsonAllocator* JsonSelectAllocator(JsonAllocator* allocator) {
+	JsonAllocator* previous = JsonGetAllocator();
+	CurrentAllocator = allocator;
+
+	return previous;
+}
+
+JsonAllocator* JsonGetAllocator() {
+	return CurrentAllocator != NULL ? CurrentAllocator : &DefaultAllocator;
+}
+
+/*
+	Allocating Memory
+
+	FUNCTIONS:
+
+	> JsonMalloc()
+	Allocates memory using the calling thread's allocator
+
+	> JsonCalloc()
+	Allocates zeroed memory for 'count' objects of 'size' bytes using the calling thread's allocator
+	Returns NULL if 'count' * 'size' does not fit in a size_t
+
+	> JsonRealloc()
+	Resizes memory using the calling thread's allocator
+
+	> JsonFree()
+	Frees memory using the calling thread's allocator
+	Strings returned by the library (e.g., from JsonDumpString()) should be freed with this function when an
+	allocator other than the default one is in use
+*/
+
+void* JsonMalloc(ullong size) {
+	JsonAllocator* allocator = JsonGetAllocator();
+	return allocator->Alloc(allocator->User, size);
+}
+
+void* JsonCalloc(ullong count, ullong size) {
+	if (size != 0 && count > SIZE_MAX / size) {
+		return NULL;
+	}
+
+	JsonAllocator* allocator = JsonGetAllocator();
+	void* ptr = allocator->Alloc(allocator->User, count * size);
+
+	if (ptr != NULL) {
+		memset(ptr, 0, count * size);
+	}
+
+	return ptr;
+}
+
+void* JsonRealloc(void* ptr, ullong size) {
+	JsonAllocator* allocator = JsonGetAllocator();
+	return allocator->Realloc(allocator->User, ptr, size);
+}
+
+void JsonFree(void* ptr) {
+	JsonAllocator* allocator = JsonGetAllocator();
+	allocator->Free(allocator->User, ptr);
+}
+
+/*
+	Node Pools
+
+	FUNCTIONS:
+
+	> JsonPoolAlloc()
+	Allocates a small fixed size block (e.g., a JsonValue, JsonData or JsonPair) from the calling thread's free list
+	for its size class. Falls back to JsonMalloc() when the free list is empty, the block is too large to pool or an
+	allocator other than the pools' one is selected (see JsonSelectAllocator())
+
+	> JsonPoolCalloc()
+	Same as JsonPoolAlloc() but the block is zeroed
+
+	> JsonPoolFree()
+	Returns a block to the calling thread's free list for its size class. 'size' has to be the size the block was
+	allocated with. 'ptr' may be NULL
+	A block freed while an allocator other than the pools' one is selected (e.g., a JsonRegion's) is freed with
+	JsonFree()
+
+	> JsonPoolTrim()
+	Frees every block in the calling thread's free lists using the allocator they came from
+	Should be called by a thread before it exits, otherwise the blocks in its free lists are leaked
+
+	NOTES:
+
+	Documents which are modified in place create and delete a constant stream of tiny nodes. Recycling them through
+	per-thread free lists means most of them never reach the allocator, so threads working on separate documents do
+	not contend on the allocator's lock.
+
+	Every pooled block is a separate allocation made by JsonMalloc() and rounded up to its size class, so a block
+	from JsonPoolAlloc() can safely be freed with JsonFree() (e.g., by code which predates the pools). A block freed
+	on a different thread than the one which allocated it joins the free list of the thread which freed it
+*/
+
+void* JsonPoolAlloc(ullong size) {
+	if (size == 0 || size > POOL_GRANULARITY * POOL_CLASS_COUNT) {
+		return JsonMalloc(size);
+	}
+
+	Pool* pool = &Pools[PoolClass(size)];
+
+	if (pool->Head == NULL || JsonGetAllocator() != PoolAllocator()) {
+		return JsonMalloc(PoolClass(size) * POOL_GRANULARITY + POOL_GRANULARITY);
+	}
+
+	PoolBlock* block = pool->Head;
+	pool->Head = block->Next;
+	pool->Length--;
+
+	return block;
+}
+
+void* JsonPoolCalloc(ullong size) {
+	void* ptr = JsonPoolAlloc(size);
+
+	if (ptr != NULL) {
+		memset(ptr, 0, size);
+	}
+
+	return ptr;
+}
+
+void JsonPoolFree(void* ptr, ullong size) {
+	if (ptr == NULL) {
+		return;
+	}
+
+	if (size == 0 || size > POOL_GRANULARITY * POOL_CLASS_COUNT || JsonGetAllocator() != PoolAllocator()) {
+		JsonFree(ptr);
+		return;
+	}
+
+	Pool* pool = &Pools[PoolClass(size)];
+
+	if (pool->Length >= POOL_LIMIT) {
+		JsonFree(ptr);
+		return;
+	}
+
+	PoolBlock* block = ptr;
+	block->Next = pool->Head;
+	pool->Head = block;
+	pool->Length++;
+}
+
+void JsonPoolTrim() {
+	JsonAllocator* allocator = PoolAllocator();
+
+	for (int i = 0; i < POOL_CLASS_COUNT; i++) {
+		Pool* pool = &Pools[i];
+
+		while (pool->Head != NULL) {
+			PoolBlock* block = pool->Head;
+			pool->Head = block->Next;
+			allocator->Free(allocator->User, block);
+		}
+
+		pool->Length = 0;
+	}
+}
+
+/*
+	Regions
+
+	FUNCTIONS:
+
+	> JsonRegionInit()
+	Allocates a JsonRegion which can hand out 'capacity' bytes using the calling thread's allocator, which becomes
+	its Parent and is kept alive by it (see JsonAllocatorRetain())
+
+	> JsonRegionAlloc()
+	Hands out the next 'size' bytes of a JsonRegion, rounded up to JSON_REGION_ALIGNMENT. Falls back to JsonMalloc()
+	once the region is full
+
+	> JsonRegionRelease()
+	Drops the reference the caller of JsonRegionInit() holds on a JsonRegion
+
+	> JsonAllocatorRetain()
+	Adds the reference a JsonList or JsonExpr holds on the allocator it uses and returns the allocator. Only a
+	JsonRegion's Interface counts references, any other allocator is returned as it is
+
+	> JsonAllocatorRelease()
+	Removes the reference a JsonList or JsonExpr held on its allocator once it has been deleted
+
+	> JsonAllocatorOwner()
+	Gets the allocator 'ptr' has to be freed with when it was allocated through 'allocator': the Interface of the
+	JsonRegion which handed it out, or else the first allocator underneath the regions
+
+	> RegionDrop()
+	Removes one reference from a JsonRegion and frees it with its Parent if that was the last one
+
+	> RegionAlloc(), RegionRealloc(), RegionFree()
+	The functions of a JsonRegion's Interface. New memory always comes from the Parent. Freeing a block the region
+	handed out drops a reference from the region, anything else is freed by the Parent. Resizing a block of the
+	region moves it into a new allocation from the Parent
+
+	NOTES:
+
+	A JsonRegion is one allocation which many small blocks are carved out of back to back, so that a whole document
+	can live in contiguous memory (see JsonCompact()). Each block can still be freed and resized on its own, which
+	is what lets a compacted document be edited and deleted like any other. The region counts its blocks and the
+	containers which use it, and is freed once every one of them is gone
+
+	Whether memory belongs to a region is only ever asked of the region which the document uses, through its
+	Interface, so freeing memory outside of a compacted document never looks at a region. The Live count is atomic,
+	a region is filled by a single thread but its blocks can be freed on any thread
+
+	WARNING:
+
+	The Parent has to stay alive until the region is freed
+*/
+
+static void RegionDrop(JsonRegion* region) {
+	if (RegionDecrement(region) == 0) {
+		JsonAllocator* parent = region->Parent;
+		parent->Free(parent->User, region);
+		JsonAllocatorRelease(parent);
+	}
+}
+
+static void* RegionAlloc(void* user, ullong size) {
+	JsonRegion* region = user;
+	return region->Parent->Alloc(region->Parent->User, size);
+}
+
+static void* RegionRealloc(void* user, void* ptr, ullong size) {
+	JsonRegion* region = user;
+
+	if (!RegionContains(region, ptr)) {
+		return region->Parent->Realloc(region->Parent->User, ptr, size);
+	}
+
+	ullong available = region->Buffer + region->Capacity - (char*)ptr;
+	void* output = region->Parent->Alloc(region->Parent->User, size);
+	memcpy(output, ptr, size < available ? size : available);
+	RegionDrop(region);
+
+	return output;
+}
+
+static void RegionFree(void* user, void* ptr) {
+	JsonRegion* region = user;
+
+	if (!RegionContains(region, ptr)) {
+		region->Parent->Free(region->Parent->User, ptr);
+		return;
+	}
+
+	RegionDrop(region);
+}
+
+JsonRegion* JsonRegionInit(ullong capacity) {
+	JsonAllocator* parent = JsonAllocatorRetain(JsonGetAllocator());
+	JsonRegion* region = parent->Alloc(parent->User, JsonRegionSize(sizeof(JsonRegion)) + capacity);
+	region->Buffer = (char*)region + JsonRegionSize(sizeof(JsonRegion));
+	region->Length = 0;
+	region->Capacity = capacity;
+	region->Live = 1;
+	region->Parent = parent;
+	region->Interface.Alloc = RegionAlloc;
+	region->Interface.Realloc = RegionRealloc;
+	region->Interface.Free = RegionFree;
+	region->Interface.User = region;
+
+	return region;
+}
+
+void* JsonRegionAlloc(JsonRegion* region, ullong size) {
+	size = JsonRegionSize(size);
+
+	if (region->Length + size > region->Capacity) {
+		return JsonMalloc(size);
+	}
+
+	void* ptr = region->Buffer + region->Length;
+	region->Length += size;
+	RegionIncrement(region);
+
+	return ptr;
+}
+
+void JsonRegionRelease(JsonRegion* region) {
+	RegionDrop(region);
+}
+
+JsonAllocator* JsonAllocatorRetain(JsonAllocator* allocator) {
+	if (allocator != NULL && IsRegion(allocator)) {
+		RegionIncrement((JsonRegion*)allocator->User);
+	}
+
+	return allocator;
+}
+
+void JsonAllocatorRelease(JsonAllocator* allocator) {
+	if (allocator != NULL && IsRegion(allocator)) {
+		RegionDrop(allocator->User);
+	}
+}
+
+JsonAllocator* JsonAllocatorOwner(JsonAllocator* allocator, const void* ptr) {
+	while (allocator != NULL && IsRegion(allocator) && !RegionContains((JsonRegion*)allocator->User, ptr)) {
+		allocator = ((JsonRegion*)allocator->User)->Parent;
+	}
+
+	return allocator;
+}
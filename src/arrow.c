@@ -0,0 +1,614 @@
+#include <stdlib.h>
+#include <string.h>
+#include "include/arrow.h"
+#include "include/file-io.h"
+
+#define TRUE 1
+#define FALSE 0
+
+/*
+	Arrow Constants
+
+	MACROS:
+
+	> ARROW_MAGIC
+	Written at the start and at the end of every Arrow IPC file, the start is padded to 8 bytes
+
+	> ARROW_CONTINUATION
+	Written in front of the size of every encapsulated message
+
+	> ARROW_ALIGNMENT
+	Alignment of every message and every buffer in a message body
+
+	> ARROW_VERSION_V5
+	MetadataVersion written in every message and the footer
+
+	> ARROW_HEADER_SCHEMA, ARROW_HEADER_RECORD_BATCH
+	Values of the MessageHeader union
+
+	> ARROW_TYPE_NULL, ARROW_TYPE_INT, ARROW_TYPE_FLOAT, ARROW_TYPE_BOOL, ARROW_TYPE_LARGE_UTF8
+	Values of the Type union used for the JSON_COLUMN types
+
+	> ARROW_PRECISION_DOUBLE
+	Value of the Precision enum for 64 bit floats
+*/
+
+#define ARROW_MAGIC "ARROW1\0\0"
+#define ARROW_CONTINUATION 0xFFFFFFFF
+#define ARROW_ALIGNMENT 8
+#define ARROW_VERSION_V5 4
+
+#define ARROW_HEADER_SCHEMA 1
+#define ARROW_HEADER_RECORD_BATCH 3
+
+#define ARROW_TYPE_NULL 1
+#define ARROW_TYPE_INT 2
+#define ARROW_TYPE_FLOAT 3
+#define ARROW_TYPE_BOOL 6
+#define ARROW_TYPE_LARGE_UTF8 20
+
+#define ARROW_PRECISION_DOUBLE 2
+
+#define FLAT_MAX_FIELDS 8
+
+/*
+	Flatbuffer Builder
+
+	FUNCTIONS:
+
+	> FlatInit()
+	Initialize an empty FlatBuilder
+
+	> FlatReserve()
+	Makes sure there is room for 'size' more bytes. The buffer grows downwards, so the bytes already written are
+	moved to the end of the new buffer
+
+	> FlatPad()
+	Writes zeros so that the buffer is aligned to 'alignment' once 'size' more bytes are written
+
+	> FlatPush()
+	Writes bytes in front of everything written so far
+
+	> FlatAddField()
+	Writes a scalar field of the table being built
+
+	> FlatAddOffset()
+	Writes a field of the table being built which refers to a string, vector or table written before
+
+	> FlatString()
+	Writes a null terminated string and returns its offset
+
+	> FlatStructVector()
+	Writes a vector of structs, 'data' is the structs in order. Returns the offset of the vector
+
+	> FlatOffsetVector()
+	Writes a vector of offsets to strings, vectors or tables written before. Returns the offset of the vector
+
+	> FlatStartTable()
+	Starts a table. Every string, vector and table it refers to has to be written before this is called
+
+	> FlatEndTable()
+	Writes the vtable of the table being built and returns the offset of the table
+
+	> FlatFinish()
+	Writes the offset of the root table and returns the finished flatbuffer
+
+	NOTES:
+
+	A FlatBuilder writes a flatbuffer back to front, the same way the flatbuffers library does. Offsets are counted
+	from the end of the buffer, so they stay the same while it grows
+
+	Scalars are written in host byte order, the file is only valid Arrow on little endian machines
+*/
+
+typedef struct {
+	unsigned char* Buffer;
+	ullong Capacity;
+	ullong Size;
+	ullong MinAlign;
+	ullong TableStart;
+	ullong Fields[FLAT_MAX_FIELDS];
+} FlatBuilder;
+
+static void FlatInit(FlatBuilder* builder) {
+	memset(builder, 0, sizeof(FlatBuilder));
+	builder->MinAlign = 1;
+}
+
+static void FlatReserve(FlatBuilder* builder, ullong size) {
+	if (builder->Capacity - builder->Size >= size) {
+		return;
+	}
+
+	ullong capacity = builder->Capacity > 0 ? builder->Capacity * 2 : 256;
+
+	while (capacity - builder->Size < size) {
+		capacity *= 2;
+	}
+
+	unsigned char* buffer = JsonMalloc(capacity);
+
+	if (builder->Size > 0) {
+		memcpy(buffer + capacity - builder->Size, builder->Buffer + builder->Capacity - builder->Size, builder->Size);
+	}
+
+	JsonFree(builder->Buffer);
+
+	builder->Buffer = buffer;
+	builder->Capacity = capacity;
+}
+
+static void FlatPush(FlatBuilder* builder, const void* data, ullong size) {
+	if (size == 0) {
+		return;
+	}
+
+	FlatReserve(builder, size);
+	builder->Size += size;
+	memcpy(builder->Buffer + builder->Capacity - builder->Size, data, size);
+}
+
+static void FlatPad(FlatBuilder* builder, ullong size, ullong alignment) {
+	ullong padding = (0 - (builder->Size + size)) & (alignment - 1);
+
+	if (padding > 0) {
+		FlatReserve(builder, padding);
+		builder->Size += padding;
+		memset(builder->Buffer + builder->Capacity - builder->Size, 0, padding);
+	}
+
+	if (alignment > builder->MinAlign) {
+		builder->MinAlign = alignment;
+	}
+}
+
+static void FlatAddField(FlatBuilder* builder, int slot, const void* value, ullong size) {
+	FlatPad(builder, size, size);
+	FlatPush(builder, value, size);
+	builder->Fields[slot] = builder->Size;
+}
+
+static void FlatAddOffset(FlatBuilder* builder, int slot, ullong target) {
+	FlatPad(builder, sizeof(uint), sizeof(uint));
+	uint offset = (uint)(builder->Size + sizeof(uint) - target);
+	FlatPush(builder, &offset, sizeof(uint));
+	builder->Fields[slot] = builder->Size;
+}
+
+static ullong FlatString(FlatBuilder* builder, const char* string, ullong length) {
+	uint prefix = (uint)length;
+
+	FlatPad(builder, length + 1, sizeof(uint));
+	FlatPush(builder, "", 1);
+	FlatPush(builder, string, length);
+	FlatPush(builder, &prefix, sizeof(uint));
+
+	return builder->Size;
+}
+
+static ullong FlatStructVector(FlatBuilder* builder, const void* data, ullong count, ullong size, ullong alignment) {
+	uint prefix = (uint)count;
+
+	FlatPad(builder, count * size, alignment > sizeof(uint) ? alignment : sizeof(uint));
+	FlatPush(builder, data, count * size);
+	FlatPush(builder, &prefix, sizeof(uint));
+
+	return builder->Size;
+}
+
+static ullong FlatOffsetVector(FlatBuilder* builder, ullong* targets, ullong count) {
+	uint prefix = (uint)count;
+
+	FlatPad(builder, count * sizeof(uint), sizeof(uint));
+
+	for (ullong i = count; i-- > 0;) {
+		uint offset = (uint)(builder->Size + sizeof(uint) - targets[i]);
+		FlatPush(builder, &offset, sizeof(uint));
+	}
+
+	FlatPush(builder, &prefix, sizeof(uint));
+	return builder->Size;
+}
+
+static void FlatStartTable(FlatBuilder* builder) {
+	memset(builder->Fields, 0, sizeof(builder->Fields));
+	builder->TableStart = builder->Size;
+}
+
+static ullong FlatEndTable(FlatBuilder* builder) {
+	int placeholder = 0;
+	FlatPad(builder, sizeof(int), sizeof(int));
+	FlatPush(builder, &placeholder, sizeof(int));
+
+	ullong table = builder->Size;
+	int count = FLAT_MAX_FIELDS;
+
+	while (count > 0 && builder->Fields[count - 1] == 0) {
+		count--;
+	}
+
+	for (int slot = count; slot-- > 0;) {
+		unsigned short offset = builder->Fields[slot] != 0 ? (unsigned short)(table - builder->Fields[slot]) : 0;
+		FlatPush(builder, &offset, sizeof(unsigned short));
+	}
+
+	unsigned short tableSize = (unsigned short)(table - builder->TableStart);
+	unsigned short vtableSize = (unsigned short)(sizeof(unsigned short) * (count + 2));
+	FlatPush(builder, &tableSize, sizeof(unsigned short));
+	FlatPush(builder, &vtableSize, sizeof(unsigned short));
+
+	int vtable = (int)(builder->Size - table);
+	memcpy(builder->Buffer + builder->Capacity - table, &vtable, sizeof(int));
+
+	return table;
+}
+
+static unsigned char* FlatFinish(FlatBuilder* builder, ullong root, ullong* size) {
+	FlatPad(builder, sizeof(uint), builder->MinAlign > ARROW_ALIGNMENT ? builder->MinAlign : ARROW_ALIGNMENT);
+	uint offset = (uint)(builder->Size + sizeof(uint) - root);
+	FlatPush(builder, &offset, sizeof(uint));
+
+	*size = builder->Size;
+	return builder->Buffer + builder->Capacity - builder->Size;
+}
+
+/*
+	Arrow Metadata
+
+	FUNCTIONS:
+
+	> ArrowType()
+	Gets the Type union value of a JsonColumn
+
+	> ArrowBufferCount()
+	Gets the number of buffers a JsonColumn has in a record batch body
+
+	> ArrowBuffers()
+	Gets the buffers of a JsonColumn in the order Arrow expects them (validity, then values or offsets, then data)
+	A validity buffer of length 0 is used when the column has no nulls
+
+	> ArrowWriteSchema()
+	Writes a Schema table with one nullable Field for every JsonColumn and returns its offset
+
+	> ArrowWriteMessage()
+	Writes a Message table around a Schema or RecordBatch and returns the finished flatbuffer
+
+	> ArrowWriteRecordBatch()
+	Writes a RecordBatch table describing every buffer of the body and returns its offset
+	Also gives the length of the body
+
+	> ArrowWriteFooter()
+	Writes the Footer table, which repeats the schema and points at the record batch, and returns the finished
+	flatbuffer
+*/
+
+typedef struct {
+	const void* Data;
+	ullong Length;
+} ArrowBuffer;
+
+typedef struct {
+	llong Length;
+	llong NullCount;
+} ArrowFieldNode;
+
+typedef struct {
+	llong Offset;
+	llong Length;
+} ArrowBufferSpec;
+
+typedef struct {
+	llong Offset;
+	int MetaDataLength;
+	int Padding;
+	llong BodyLength;
+} ArrowBlock;
+
+static unsigned char ArrowType(JsonColumn* column) {
+	switch (column->Type) {
+		case JSON_COLUMN_INT:
+			return ARROW_TYPE_INT;
+		case JSON_COLUMN_FLOAT:
+			return ARROW_TYPE_FLOAT;
+		case JSON_COLUMN_BOOL:
+			return ARROW_TYPE_BOOL;
+		case JSON_COLUMN_STRING:
+			return ARROW_TYPE_LARGE_UTF8;
+	}
+
+	return ARROW_TYPE_NULL;
+}
+
+static int ArrowBufferCount(JsonColumn* column) {
+	switch (column->Type) {
+		case JSON_COLUMN_NULL:
+			return 0;
+		case JSON_COLUMN_STRING:
+			return 3;
+	}
+
+	return 2;
+}
+
+static int ArrowBuffers(JsonColumn* column, ArrowBuffer* buffers) {
+	ullong bitmap = (column->Length + 7) / 8;
+
+	buffers[0].Data = column->Validity;
+	buffers[0].Length = column->NullCount > 0 ? bitmap : 0;
+
+	switch (column->Type) {
+		case JSON_COLUMN_INT:
+			buffers[1].Data = column->Values;
+			buffers[1].Length = sizeof(JsonInt) * column->Length;
+			break;
+		case JSON_COLUMN_FLOAT:
+			buffers[1].Data = column->Values;
+			buffers[1].Length = sizeof(double) * column->Length;
+			break;
+		case JSON_COLUMN_BOOL:
+			buffers[1].Data = column->Values;
+			buffers[1].Length = bitmap;
+			break;
+		case JSON_COLUMN_STRING:
+			buffers[1].Data = column->Values;
+			buffers[1].Length = sizeof(llong) * (column->Length + 1);
+			buffers[2].Data = column->Data;
+			buffers[2].Length = column->DataLength;
+			break;
+	}
+
+	return ArrowBufferCount(column);
+}
+
+static ullong ArrowWriteSchema(FlatBuilder* builder, JsonColumns* columns) {
+	ullong* fields = JsonMalloc(sizeof(ullong) * (columns->Count + 1));
+
+	for (ullong k = 0; k < columns->Count; k++) {
+		JsonColumn* column = &columns->Columns[k];
+		unsigned char type = ArrowType(column);
+		unsigned char nullable = TRUE;
+
+		ullong name = FlatString(builder, column->Key, strlen(column->Key));
+		ullong children = FlatOffsetVector(builder, NULL, 0);
+
+		FlatStartTable(builder);
+
+		if (type == ARROW_TYPE_INT) {
+			int bitWidth = sizeof(JsonInt) * 8;
+			unsigned char isSigned = TRUE;
+			FlatAddField(builder, 0, &bitWidth, sizeof(int));
+			FlatAddField(builder, 1, &isSigned, sizeof(unsigned char));
+		}
+		else if (type == ARROW_TYPE_FLOAT) {
+			short precision = ARROW_PRECISION_DOUBLE;
+			FlatAddField(builder, 0, &precision, sizeof(short));
+		}
+
+		ullong typeTable = FlatEndTable(builder);
+
+		FlatStartTable(builder);
+		FlatAddOffset(builder, 0, name);
+		FlatAddField(builder, 1, &nullable, sizeof(unsigned char));
+		FlatAddField(builder, 2, &type, sizeof(unsigned char));
+		FlatAddOffset(builder, 3, typeTable);
+		FlatAddOffset(builder, 5, children);
+		fields[k] = FlatEndTable(builder);
+	}
+
+	ullong vector = FlatOffsetVector(builder, fields, columns->Count);
+	short endianness = 0;
+
+	FlatStartTable(builder);
+	FlatAddField(builder, 0, &endianness, sizeof(short));
+	FlatAddOffset(builder, 1, vector);
+
+	JsonFree(fields);
+	return FlatEndTable(builder);
+}
+
+static unsigned char* ArrowWriteMessage(FlatBuilder* builder, unsigned char type, ullong header, llong length, ullong* size) {
+	short version = ARROW_VERSION_V5;
+
+	FlatStartTable(builder);
+	FlatAddField(builder, 3, &length, sizeof(llong));
+	FlatAddOffset(builder, 2, header);
+	FlatAddField(builder, 0, &version, sizeof(short));
+	FlatAddField(builder, 1, &type, sizeof(unsigned char));
+
+	return FlatFinish(builder, FlatEndTable(builder), size);
+}
+
+static ullong ArrowWriteRecordBatch(FlatBuilder* builder, JsonColumns* columns, llong* bodyLength) {
+	ArrowFieldNode* nodes = JsonMalloc(sizeof(ArrowFieldNode) * (columns->Count + 1));
+	ArrowBufferSpec* specs = JsonMalloc(sizeof(ArrowBufferSpec) * (columns->Count * 3 + 1));
+	ullong count = 0;
+	llong offset = 0;
+
+	for (ullong k = 0; k < columns->Count; k++) {
+		JsonColumn* column = &columns->Columns[k];
+		ArrowBuffer buffers[3];
+		int length = ArrowBuffers(column, buffers);
+
+		nodes[k].Length = column->Length;
+		nodes[k].NullCount = column->NullCount;
+
+		for (int i = 0; i < length; i++) {
+			specs[count].Offset = offset;
+			specs[count].Length = buffers[i].Length;
+			offset += (buffers[i].Length + ARROW_ALIGNMENT - 1) & ~(llong)(ARROW_ALIGNMENT - 1);
+			count++;
+		}
+	}
+
+	ullong nodeVector = FlatStructVector(builder, nodes, columns->Count, sizeof(ArrowFieldNode), sizeof(llong));
+	ullong bufferVector = FlatStructVector(builder, specs, count, sizeof(ArrowBufferSpec), sizeof(llong));
+	llong length = columns->Length;
+
+	FlatStartTable(builder);
+	FlatAddField(builder, 0, &length, sizeof(llong));
+	FlatAddOffset(builder, 1, nodeVector);
+	FlatAddOffset(builder, 2, bufferVector);
+
+	JsonFree(nodes);
+	JsonFree(specs);
+
+	*bodyLength = offset;
+	return FlatEndTable(builder);
+}
+
+static unsigned char* ArrowWriteFooter(FlatBuilder* builder, JsonColumns* columns, ArrowBlock* block, ullong* size) {
+	ullong schema = ArrowWriteSchema(builder, columns);
+	ullong dictionaries = FlatStructVector(builder, NULL, 0, sizeof(ArrowBlock), sizeof(llong));
+	ullong batches = FlatStructVector(builder, block, 1, sizeof(ArrowBlock), sizeof(llong));
+	short version = ARROW_VERSION_V5;
+
+	FlatStartTable(builder);
+	FlatAddOffset(builder, 1, schema);
+	FlatAddOffset(builder, 2, dictionaries);
+	FlatAddOffset(builder, 3, batches);
+	FlatAddField(builder, 0, &version, sizeof(short));
+
+	return FlatFinish(builder, FlatEndTable(builder), size);
+}
+
+/*
+	Writing Arrow Files
+
+	FUNCTIONS:
+
+	> ArrowWriteFile()
+	Writes JsonColumns to an Arrow IPC file (Feather v2) as a schema and a single record batch
+	INT columns are written as int64, FLOAT columns as float64, BOOL columns as bool, STRING columns as large_utf8
+	and columns which never held a value as null
+	Error will be raised if the file failed to write
+
+	> ArrowWriteBytes()
+	Queues bytes to be written to the file and keeps track of the file offset. The bytes are not copied, so they
+	have to stay alive until the file is written
+
+	> ArrowWriteWord()
+	Same as ArrowWriteBytes() but for a 32 bit word, which is kept in the ArrowFile itself
+
+	> ArrowWritePadding()
+	Writes zeros up to the next multiple of ARROW_ALIGNMENT
+
+	> ArrowWriteEncapsulated()
+	Writes a flatbuffer as an encapsulated message (continuation marker, size, flatbuffer, padding) and returns the
+	number of bytes written
+
+	NOTES:
+
+	Nothing is written until the whole file has been laid out, then every piece is written with one
+	FileWriteVector() call (writev() where it exists). The buffers of a record batch are written straight from the
+	JsonColumns and the flatbuffers straight from their builders, nothing is copied into an intermediate buffer
+*/
+
+#define ARROW_FILE_WORDS 8
+
+typedef struct {
+	const char** Buffers;
+	ullong* Lengths;
+	ullong Count;
+	ullong Capacity;
+	uint Words[ARROW_FILE_WORDS];
+	ullong WordCount;
+	ullong Offset;
+} ArrowFile;
+
+static void ArrowWriteBytes(ArrowFile* file, const void* data, ullong size) {
+	if (size == 0) {
+		return;
+	}
+
+	if (file->Count == file->Capacity) {
+		file->Capacity = file->Capacity > 0 ? file->Capacity * 2 : 32;
+		file->Buffers = JsonRealloc(file->Buffers, sizeof(const char*) * file->Capacity);
+		file->Lengths = JsonRealloc(file->Lengths, sizeof(ullong) * file->Capacity);
+	}
+
+	file->Buffers[file->Count] = data;
+	file->Lengths[file->Count] = size;
+	file->Count++;
+	file->Offset += size;
+}
+
+static void ArrowWriteWord(ArrowFile* file, uint word) {
+	file->Words[file->WordCount] = word;
+	ArrowWriteBytes(file, &file->Words[file->WordCount++], sizeof(uint));
+}
+
+static void ArrowWritePadding(ArrowFile* file) {
+	static const unsigned char zeros[ARROW_ALIGNMENT] = { 0 };
+	ArrowWriteBytes(file, zeros, (0 - file->Offset) & (ARROW_ALIGNMENT - 1));
+}
+
+static ullong ArrowWriteEncapsulated(ArrowFile* file, const unsigned char* data, ullong size) {
+	uint length = (uint)((size + ARROW_ALIGNMENT - 1) & ~(ullong)(ARROW_ALIGNMENT - 1));
+	ullong start = file->Offset;
+
+	ArrowWriteWord(file, ARROW_CONTINUATION);
+	ArrowWriteWord(file, length);
+	ArrowWriteBytes(file, data, size);
+	ArrowWritePadding(file);
+
+	return file->Offset - start;
+}
+
+Error* ArrowWriteFile(JsonColumns* columns, const char* path) {
+	ArrowFile file = { 0 };
+	FlatBuilder schemaBuilder, batchBuilder, footerBuilder;
+	ullong size;
+	llong bodyLength;
+	ArrowBlock block = { 0 };
+
+	ArrowWriteBytes(&file, ARROW_MAGIC, ARROW_ALIGNMENT);
+
+	// Schema
+
+	FlatInit(&schemaBuilder);
+	ullong schema = ArrowWriteSchema(&schemaBuilder, columns);
+	unsigned char* message = ArrowWriteMessage(&schemaBuilder, ARROW_HEADER_SCHEMA, schema, 0, &size);
+	ArrowWriteEncapsulated(&file, message, size);
+
+	// Record Batch
+
+	FlatInit(&batchBuilder);
+	ullong batch = ArrowWriteRecordBatch(&batchBuilder, columns, &bodyLength);
+	message = ArrowWriteMessage(&batchBuilder, ARROW_HEADER_RECORD_BATCH, batch, bodyLength, &size);
+
+	block.Offset = file.Offset;
+	block.MetaDataLength = (int)ArrowWriteEncapsulated(&file, message, size);
+	block.BodyLength = bodyLength;
+
+	for (ullong k = 0; k < columns->Count; k++) {
+		ArrowBuffer buffers[3];
+		int length = ArrowBuffers(&columns->Columns[k], buffers);
+
+		for (int i = 0; i < length; i++) {
+			ArrowWriteBytes(&file, buffers[i].Data, buffers[i].Length);
+			ArrowWritePadding(&file);
+		}
+	}
+
+	// End Of Stream & Footer
+
+	ArrowWriteWord(&file, ARROW_CONTINUATION);
+	ArrowWriteWord(&file, 0);
+
+	FlatInit(&footerBuilder);
+	unsigned char* footer = ArrowWriteFooter(&footerBuilder, columns, &block, &size);
+
+	ArrowWriteBytes(&file, footer, size);
+	ArrowWriteWord(&file, (uint)size);
+	ArrowWriteBytes(&file, ARROW_MAGIC, 6);
+
+	Error* error = FileWriteVector(path, file.Buffers, file.Lengths, file.Count);
+
+	JsonFree(schemaBuilder.Buffer);
+	JsonFree(batchBuilder.Buffer);
+	JsonFree(footerBuilder.Buffer);
+	JsonFree(file.Buffers);
+	JsonFree(file.Lengths);
+
+	return error;
+}
@@ -0,0 +1,676 @@
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "include/columns.h"
+#include "include/json-parser.h"
+
+#define PAIR_INDEX_NOT_FOUND -1
+#define TRUE 1
+#define FALSE 0
+
+/*
+	Building Columns
+
+	FUNCTIONS:
+
+	> ColumnReserve()
+	Makes sure a JsonColumn can hold at least 'capacity' rows. New validity bits and values are zeroed
+
+	> ColumnGrow()
+	Makes room for one more row. Capacities double each time, starting at 16
+
+	> ColumnSetType()
+	Gives a JSON_COLUMN_NULL column a type and allocates its values buffer, every row before it stays null
+
+	> ColumnPromoteToFloat()
+	Turns a JSON_COLUMN_INT column into a JSON_COLUMN_FLOAT column, used when a float shows up after ints
+
+	> ColumnAppendValid()
+	Marks the row being appended as valid and moves on to the next row
+
+	> ColumnAppendNull()
+	Appends a row which does not hold a value
+
+	> ColumnAppendInt(), ColumnAppendFloat(), ColumnAppendBool(), ColumnAppendString()
+	Appends a row holding a value. A float in a JSON_COLUMN_INT column promotes the column, an int in a
+	JSON_COLUMN_FLOAT column is converted. Any other value which does not match the column's type is appended as
+	null
+
+	> ColumnDecodeNul()
+	Turns every stored U+0000 (JSON_NUL_LEAD followed by JSON_NUL_TRAIL, see JsonString) in a string back into a
+	'\0' in place and returns the string's new length. String columns hold lengths so they can keep the '\0'
+
+	> ColumnAppendValue()
+	Appends a JsonValue, or null if 'value' is NULL or holds a list, expr or null
+*/
+
+static void ColumnReserve(JsonColumn* column, ullong capacity) {
+	if (capacity <= column->Capacity) {
+		return;
+	}
+
+	ullong bytes = (column->Capacity + 7) / 8;
+	ullong size = (capacity + 7) / 8;
+
+	column->Validity = JsonRealloc(column->Validity, size);
+	memset(column->Validity + bytes, 0, size - bytes);
+
+	switch (column->Type) {
+		case JSON_COLUMN_INT:
+			column->Values = JsonRealloc(column->Values, sizeof(JsonInt) * capacity);
+			memset((JsonInt*)column->Values + column->Capacity, 0, sizeof(JsonInt) * (capacity - column->Capacity));
+			break;
+		case JSON_COLUMN_FLOAT:
+			column->Values = JsonRealloc(column->Values, sizeof(double) * capacity);
+			memset((double*)column->Values + column->Capacity, 0, sizeof(double) * (capacity - column->Capacity));
+			break;
+		case JSON_COLUMN_BOOL:
+			column->Values = JsonRealloc(column->Values, size);
+			memset((unsigned char*)column->Values + bytes, 0, size - bytes);
+			break;
+		case JSON_COLUMN_STRING:
+			column->Values = JsonRealloc(column->Values, sizeof(llong) * (capacity + 1));
+			break;
+	}
+
+	column->Capacity = capacity;
+}
+
+static void ColumnGrow(JsonColumn* column) {
+	if (column->Length >= column->Capacity) {
+		ColumnReserve(column, column->Capacity > 0 ? column->Capacity * 2 : 16);
+	}
+}
+
+static void ColumnSetType(JsonColumn* column, int type) {
+	column->Type = type;
+
+	switch (type) {
+		case JSON_COLUMN_INT:
+			column->Values = JsonCalloc(column->Capacity, sizeof(JsonInt));
+			break;
+		case JSON_COLUMN_FLOAT:
+			column->Values = JsonCalloc(column->Capacity, sizeof(double));
+			break;
+		case JSON_COLUMN_BOOL:
+			column->Values = JsonCalloc((column->Capacity + 7) / 8, 1);
+			break;
+		case JSON_COLUMN_STRING:
+			column->Values = JsonCalloc(column->Capacity + 1, sizeof(llong));
+			break;
+	}
+}
+
+static void ColumnPromoteToFloat(JsonColumn* column) {
+	double* values = JsonCalloc(column->Capacity, sizeof(double));
+
+	for (ullong i = 0; i < column->Length; i++) {
+		values[i] = (double)((JsonInt*)column->Values)[i];
+	}
+
+	JsonFree(column->Values);
+	column->Values = values;
+	column->Type = JSON_COLUMN_FLOAT;
+}
+
+static void ColumnAppendValid(JsonColumn* column) {
+	column->Validity[column->Length / 8] |= 1 << (column->Length % 8);
+	column->Length++;
+}
+
+static void ColumnAppendNull(JsonColumn* column) {
+	ColumnGrow(column);
+
+	if (column->Type == JSON_COLUMN_STRING) {
+		((llong*)column->Values)[column->Length + 1] = column->DataLength;
+	}
+
+	column->NullCount++;
+	column->Length++;
+}
+
+static void ColumnAppendFloat(JsonColumn* column, double value) {
+	ColumnGrow(column);
+
+	if (column->Type == JSON_COLUMN_NULL) {
+		ColumnSetType(column, JSON_COLUMN_FLOAT);
+	}
+	else if (column->Type == JSON_COLUMN_INT) {
+		ColumnPromoteToFloat(column);
+	}
+	else if (column->Type != JSON_COLUMN_FLOAT) {
+		ColumnAppendNull(column);
+		return;
+	}
+
+	((double*)column->Values)[column->Length] = value;
+	ColumnAppendValid(column);
+}
+
+static void ColumnAppendInt(JsonColumn* column, JsonInt value) {
+	ColumnGrow(column);
+
+	if (column->Type == JSON_COLUMN_NULL) {
+		ColumnSetType(column, JSON_COLUMN_INT);
+	}
+	else if (column->Type == JSON_COLUMN_FLOAT) {
+		ColumnAppendFloat(column, (double)value);
+		return;
+	}
+	else if (column->Type != JSON_COLUMN_INT) {
+		ColumnAppendNull(column);
+		return;
+	}
+
+	((JsonInt*)column->Values)[column->Length] = value;
+	ColumnAppendValid(column);
+}
+
+static void ColumnAppendBool(JsonColumn* column, int value) {
+	ColumnGrow(column);
+
+	if (column->Type == JSON_COLUMN_NULL) {
+		ColumnSetType(column, JSON_COLUMN_BOOL);
+	}
+	else if (column->Type != JSON_COLUMN_BOOL) {
+		ColumnAppendNull(column);
+		return;
+	}
+
+	if (value) {
+		((unsigned char*)column->Values)[column->Length / 8] |= 1 << (column->Length % 8);
+	}
+
+	ColumnAppendValid(column);
+}
+
+static ullong ColumnDecodeNul(char* string, ullong length) {
+	char* nul = memchr(string, JSON_NUL_LEAD, length);
+
+	if (nul == NULL) {
+		return length;
+	}
+
+	ullong index = nul - string;
+
+	for (ullong i = index; i < length; i++) {
+		if (i + 1 < length && JsonIsNul(string + i)) {
+			string[index++] = '\0';
+			i++;
+		}
+		else {
+			string[index++] = string[i];
+		}
+	}
+
+	return index;
+}
+
+static void ColumnAppendString(JsonColumn* column, const char* string, ullong length) {
+	ColumnGrow(column);
+
+	if (column->Type == JSON_COLUMN_NULL) {
+		ColumnSetType(column, JSON_COLUMN_STRING);
+	}
+	else if (column->Type != JSON_COLUMN_STRING) {
+		ColumnAppendNull(column);
+		return;
+	}
+
+	if (column->DataLength + length > column->DataCapacity) {
+		ullong capacity = column->DataCapacity > 0 ? column->DataCapacity * 2 : 64;
+
+		while (capacity < column->DataLength + length) {
+			capacity *= 2;
+		}
+
+		column->Data = JsonRealloc(column->Data, capacity);
+		column->DataCapacity = capacity;
+	}
+
+	if (length > 0) {
+		memcpy(column->Data + column->DataLength, string, length);
+		column->DataLength += ColumnDecodeNul(column->Data + column->DataLength, length);
+	}
+
+	((llong*)column->Values)[column->Length + 1] = column->DataLength;
+	ColumnAppendValid(column);
+}
+
+static void ColumnAppendValue(JsonColumn* column, JsonValue* value) {
+	if (value == NULL) {
+		ColumnAppendNull(column);
+		return;
+	}
+
+	switch (value->Type) {
+		case JSON_INT:
+			ColumnAppendInt(column, *value->Data->Int);
+			break;
+		case JSON_FLOAT:
+			ColumnAppendFloat(column, (double)*value->Data->Float);
+			break;
+		case JSON_TRUE:
+		case JSON_FALSE:
+			ColumnAppendBool(column, value->Type == JSON_TRUE);
+			break;
+		case JSON_STRING:
+			ColumnAppendString(column, value->Data->String, strlen(value->Data->String));
+			break;
+		default:
+			ColumnAppendNull(column);
+			break;
+	}
+}
+
+/*
+	Extracting Columns
+
+	FUNCTIONS:
+
+	> ColumnsInit()
+	Creates a JsonColumns object with an empty column for every key, each reserved for 'capacity' rows
+
+	> FindField()
+	Gets the value of a key in a JsonExpr, or NULL if the key does not exist. The slot the key was found at in the
+	previous row is checked first, so rows which keep their keys in the same order are never searched
+
+	> JsonListToColumns()
+	Extracts the values of 'count' keys from every JsonExpr in a JsonList into typed columns, one row per element,
+	in a single pass over the JsonList. Elements which are not JsonExprs, or do not have a key, give a null row
+	The JsonList is not modified
+
+	> JsonTokensToColumns()
+	Same as JsonListToColumns() but reads the rows straight from the TokenArray of a json source string whose top
+	level is a list of exprs, so no JsonList is ever built. Values of keys which are not extracted are skipped
+	without being converted. Returns NULL and sets 'error' if the source is not a list, or if anything but
+	whitespace follows the list (the same check the Parser makes)
+	Used by JsonLoadColumns() in json-parser.c
+
+	> JsonColumnsDelete()
+	Deletes a JsonColumns object and every column inside of it, with the allocator it was created with
+*/
+
+static JsonColumns* ColumnsInit(const char** keys, ullong count, ullong capacity) {
+	JsonColumns* columns = JsonCalloc(1, sizeof(JsonColumns));
+	columns->Columns = JsonCalloc(count, sizeof(JsonColumn));
+	columns->Count = count;
+	columns->Length = 0;
+	columns->Allocator = JsonGetAllocator();
+
+	for (ullong i = 0; i < count; i++) {
+		columns->Columns[i].Key = AllocJsonString(keys[i]);
+		columns->Columns[i].Type = JSON_COLUMN_NULL;
+		ColumnReserve(&columns->Columns[i], capacity);
+	}
+
+	return columns;
+}
+
+static JsonValue* FindField(JsonExpr* expr, const char* key, ullong length, ullong hash, ullong* slot) {
+	if (*slot < expr->Length) {
+		JsonPair* pair = &expr->Buffer[*slot];
+
+		if (pair->KeyHash == hash && pair->KeyLength == length && memcmp(pair->Key, key, length) == 0) {
+			return pair->Value;
+		}
+	}
+
+	ullong index = JsonGetPairIndexHashed(expr, key, length, hash);
+
+	if (index == (ullong)PAIR_INDEX_NOT_FOUND) {
+		return NULL;
+	}
+
+	*slot = index;
+	return expr->Buffer[index].Value;
+}
+
+JsonColumns* JsonListToColumns(JsonList* list, const char** keys, ullong count) {
+	JsonColumns* columns = ColumnsInit(keys, count, list->Length);
+	ullong* lengths = JsonMalloc(sizeof(ullong) * (count + 1));
+	ullong* hashes = JsonMalloc(sizeof(ullong) * (count + 1));
+	ullong* slots = JsonCalloc(count + 1, sizeof(ullong));
+
+	for (ullong k = 0; k < count; k++) {
+		lengths[k] = strlen(keys[k]);
+		hashes[k] = JsonHashKey(keys[k], lengths[k]);
+	}
+
+	for (ullong i = 0; i < list->Length; i++) {
+		JsonExpr* expr = list->Packing == JSON_PACKED_NONE && list->Buffer[i].Type == JSON_EXPR
+			? list->Buffer[i].Data->Expr
+			: NULL;
+
+		for (ullong k = 0; k < count; k++) {
+			JsonValue* value = expr != NULL
+				? FindField(expr, keys[k], lengths[k], hashes[k], &slots[k])
+				: NULL;
+
+			ColumnAppendValue(&columns->Columns[k], value);
+		}
+	}
+
+	columns->Length = list->Length;
+
+	JsonFree(lengths);
+	JsonFree(hashes);
+	JsonFree(slots);
+	return columns;
+}
+
+void JsonColumnsDelete(JsonColumns* columns) {
+	JsonAllocator* previous = JsonSelectAllocator(columns->Allocator);
+
+	for (ullong i = 0; i < columns->Count; i++) {
+		JsonColumn* column = &columns->Columns[i];
+
+		JsonFree((char*)column->Key);
+		JsonFree(column->Validity);
+		JsonFree(column->Values);
+		JsonFree(column->Data);
+	}
+
+	JsonFree(columns->Columns);
+	JsonFree(columns);
+	JsonSelectAllocator(previous);
+}
+
+/*
+	Reading Tokens
+
+	FUNCTIONS:
+
+	> ReaderAdvance()
+	Advance to the next token, asserting the type of the current one the same way the Parser does. Pass
+	ADVANCE_NO_ARGS to skip the check
+
+	> ReaderSkipValue()
+	Skips a whole value, including every token of a nested list or expr. Raises an error instead of skipping a
+	token which cannot start a value or a closing bracket with nothing open
+
+	> ReaderReadKey()
+	Reads the key of a pair and finds the column it belongs to. Returns the index of the column or 'count' if the
+	key is not extracted
+
+	> ReaderReadValue()
+	Reads a value into a column without allocating anything. Lists and exprs are skipped and appended as null
+	Integers which do not fit in 64 bits raise the same error as they do in the Parser
+
+	> ReaderReadPair()
+	Reads one pair of an expr into its column, or skips it if the key is not extracted or was already read for
+	the current row
+
+	> ReaderReadRow()
+	Reads one element of the top level list as a row. Pairs are separated by exactly one comma, the same way
+	ParseExpr() reads them. Elements which are not exprs are skipped and give a null row
+*/
+
+#define ADVANCE_NO_ARGS -1
+
+typedef struct {
+	TokenArray* Tokens;
+	Token* Token;
+	ullong Index;
+	Error* Error;
+} ColumnReader;
+
+static void ReaderAdvance(ColumnReader* reader, TokenType type) {
+	if ((int)type != ADVANCE_NO_ARGS) {
+		ASSERT(
+			reader,
+			reader->Token->Type == type,
+			ERR_UNEXPECTED_TYPE,
+			TokenTypeToString(reader->Token->Type),
+			TokenTypeToString(type)
+		);
+	}
+
+	reader->Token = reader->Tokens->Length > ++reader->Index
+		? &reader->Tokens->Buffer[reader->Index]
+		: &reader->Tokens->Buffer[reader->Tokens->Length - 1];
+}
+
+static void ReaderSkipValue(ColumnReader* reader) {
+	ullong depth = 0;
+
+	if (reader->Token->Type == TOKEN_MINUS) {
+		ReaderAdvance(reader, TOKEN_MINUS);
+	}
+
+	do {
+		switch (reader->Token->Type) {
+			case TOKEN_LCURLY:
+			case TOKEN_LBRACKET:
+				depth++;
+				break;
+			case TOKEN_RCURLY:
+			case TOKEN_RBRACKET:
+				if (depth == 0) {
+					RAISE_FATAL_ERROR(reader, ERR_INVALID_SYNTAX);
+					return;
+				}
+
+				depth--;
+				break;
+			case TOKEN_COMMA:
+			case TOKEN_COLON:
+				if (depth == 0) {
+					RAISE_FATAL_ERROR(reader, ERR_INVALID_SYNTAX);
+					return;
+				}
+
+				break;
+			case TOKEN_QUOTE:
+				ReaderAdvance(reader, TOKEN_QUOTE);
+
+				if (reader->Token->Type == TOKEN_STRING) {
+					ReaderAdvance(reader, TOKEN_STRING);
+				}
+
+				break;
+			case TOKEN_EOF:
+				return;
+			default:
+				break;
+		}
+
+		ReaderAdvance(reader, ADVANCE_NO_ARGS);
+	} while (depth > 0);
+}
+
+static ullong ReaderReadKey(ColumnReader* reader, JsonColumns* columns, ullong* lengths, ullong* hashes) {
+	ullong length = 0;
+	ullong hash = JSON_HASH_OFFSET;
+	const char* key = "";
+
+	ReaderAdvance(reader, TOKEN_QUOTE);
+
+	if (reader->Token->Type == TOKEN_STRING) {
+		key = reader->Token->Value;
+		length = reader->Token->Length;
+		hash = reader->Token->Hash;
+		ReaderAdvance(reader, TOKEN_STRING);
+	}
+
+	ReaderAdvance(reader, TOKEN_QUOTE);
+	ReaderAdvance(reader, TOKEN_COLON);
+
+	for (ullong k = 0; k < columns->Count; k++) {
+		if (hashes[k] == hash && lengths[k] == length && memcmp(columns->Columns[k].Key, key, length) == 0) {
+			return k;
+		}
+	}
+
+	return columns->Count;
+}
+
+static void ReaderReadValue(ColumnReader* reader, JsonColumn* column) {
+	int negative = FALSE;
+
+	if (reader->Token->Type == TOKEN_MINUS) {
+		negative = TRUE;
+		ReaderAdvance(reader, TOKEN_MINUS);
+	}
+
+	switch (reader->Token->Type) {
+		case TOKEN_INT: {
+			errno = 0;
+			JsonInt value = strtoll(reader->Token->Value, NULL, 10);
+
+			if (errno == ERANGE) {
+				RAISE_FATAL_ERROR(reader, ERR_INVALID_INT, reader->Token->Value);
+				return;
+			}
+
+			ColumnAppendInt(column, negative ? -value : value);
+			ReaderAdvance(reader, TOKEN_INT);
+			return;
+		}
+		case TOKEN_FLOAT: {
+			double value = strtod(reader->Token->Value, NULL);
+			ColumnAppendFloat(column, negative ? -value : value);
+			ReaderAdvance(reader, TOKEN_FLOAT);
+			return;
+		}
+		default:
+			break;
+	}
+
+	if (negative) {
+		RAISE_FATAL_ERROR(reader, ERR_INVALID_SYNTAX);
+		return;
+	}
+
+	switch (reader->Token->Type) {
+		case TOKEN_QUOTE:
+			ReaderAdvance(reader, TOKEN_QUOTE);
+
+			if (reader->Token->Type == TOKEN_STRING) {
+				ColumnAppendString(column, reader->Token->Value, reader->Token->Length);
+				ReaderAdvance(reader, TOKEN_STRING);
+			}
+			else {
+				ColumnAppendString(column, "", 0);
+			}
+
+			ReaderAdvance(reader, TOKEN_QUOTE);
+			return;
+		case TOKEN_TRUE:
+		case TOKEN_FALSE:
+			ColumnAppendBool(column, reader->Token->Type == TOKEN_TRUE);
+			ReaderAdvance(reader, ADVANCE_NO_ARGS);
+			return;
+		default:
+			break;
+	}
+
+	ColumnAppendNull(column);
+	ReaderSkipValue(reader);
+}
+
+static void ReaderReadPair(ColumnReader* reader, JsonColumns* columns, ullong* lengths, ullong* hashes) {
+	ullong k = ReaderReadKey(reader, columns, lengths, hashes);
+
+	if (k < columns->Count && columns->Columns[k].Length == columns->Length) {
+		ReaderReadValue(reader, &columns->Columns[k]);
+	}
+	else {
+		ReaderSkipValue(reader);
+	}
+}
+
+static void ReaderReadRow(ColumnReader* reader, JsonColumns* columns, ullong* lengths, ullong* hashes) {
+	if (reader->Token->Type != TOKEN_LCURLY) {
+		ReaderSkipValue(reader);
+		return;
+	}
+
+	ReaderAdvance(reader, TOKEN_LCURLY);
+
+	if (reader->Token->Type == TOKEN_RCURLY) {
+		ReaderAdvance(reader, TOKEN_RCURLY);
+		return;
+	}
+
+	ReaderReadPair(reader, columns, lengths, hashes);
+
+	while (!reader->Error->Exists && reader->Token->Type == TOKEN_COMMA) {
+		ReaderAdvance(reader, TOKEN_COMMA);
+		ReaderReadPair(reader, columns, lengths, hashes);
+	}
+
+	if (!reader->Error->Exists) {
+		ReaderAdvance(reader, TOKEN_RCURLY);
+	}
+}
+
+static void ReaderEndRow(JsonColumns* columns) {
+	columns->Length++;
+
+	for (ullong k = 0; k < columns->Count; k++) {
+		if (columns->Columns[k].Length < columns->Length) {
+			ColumnAppendNull(&columns->Columns[k]);
+		}
+	}
+}
+
+JsonColumns* JsonTokensToColumns(TokenArray* tokens, const char** keys, ullong count, Error* error) {
+	ColumnReader reader = { tokens, &tokens->Buffer[0], 0, error };
+	JsonColumns* columns = ColumnsInit(keys, count, 0);
+	ullong* lengths = JsonMalloc(sizeof(ullong) * (count + 1));
+	ullong* hashes = JsonMalloc(sizeof(ullong) * (count + 1));
+
+	for (ullong k = 0; k < count; k++) {
+		lengths[k] = strlen(keys[k]);
+		hashes[k] = JsonHashKey(keys[k], lengths[k]);
+	}
+
+	ReaderAdvance(&reader, TOKEN_LBRACKET);
+
+	if (!error->Exists && reader.Token->Type != TOKEN_RBRACKET) {
+		ReaderReadRow(&reader, columns, lengths, hashes);
+		ReaderEndRow(columns);
+
+		while (!error->Exists && reader.Token->Type == TOKEN_COMMA) {
+			ReaderAdvance(&reader, TOKEN_COMMA);
+			ReaderReadRow(&reader, columns, lengths, hashes);
+			ReaderEndRow(columns);
+		}
+	}
+
+	if (!error->Exists) {
+		ReaderAdvance(&reader, TOKEN_RBRACKET);
+	}
+
+	if (!error->Exists) {
+		ASSERT(
+			(&reader),
+			reader.Token->Type == TOKEN_EOF,
+			ERR_UNEXPECTED_EOF
+		);
+	}
+
+	JsonFree(lengths);
+	JsonFree(hashes);
+
+	if (error->Exists) {
+		JsonColumnsDelete(columns);
+		return NULL;
+	}
+
+	return columns;
+}
+
+/*
+	Reading Columns
+
+	FUNCTIONS:
+
+	> JsonColumnIsValid()
+	Returns TRUE if a row of a column holds a value and FALSE if it is null
+*/
+
+int JsonColumnIsValid(JsonColumn* column, ullong row) {
+	return (column->Validity[row / 8] >> (row % 8)) & 1;
+}
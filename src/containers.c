@@ -1,255 +1,811 @@
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include "include/containers.h"
-
-/*
-	String Builder
-
-	FUNCTIONS:
-
-	> StringBuilerAllocMore()
-	Allocates more data for a StringBuilder's buffer. Data sizes double each time (2, 4, 8, 16, 32, 64, etc.).
-	An extra byte is allocated ontop of the capacity. For the null terminator. The previous buffer is then freed to
-	prevent memory leaks and a new buffer with the copied data is set. 
-
-	> StringBuilderInit()
-	Initialize a StringBuilder object
-
-	> StringBuilderAppendChar()
-	Appends a char to a StringBuilder's buffer. If the length of the StringBuilder begins to exceed its capacity
-	the StringBuilder will allocate more memory to adjust. 
-
-	> StringBuilderAppendString()
-	Appends a string to a StringBuilder's buffer. To keep it simple the StringBuilder just pushes each char in the
-	string to StringBuilderAppendChar()
-
-	> StringBuilderAppendLLONG()
-	Appends a long long to a StringBuilder's buffer. The long long is first converted to a string using sprintf_s()
-	and is then passed to StringBuilderAppendString()
-
-	> StringBuilderAppendLDOUBLE()
-	Appends a long double to a StringBuilder's buffer. The long double is first converted to a string using sprintf_s()
-	and is then passed to StringBuilderAppendString()
-*/
-
-void StringBuilderAllocMore(StringBuilder* builder) {
-	size_t capacity = builder->Capacity > 0 ? builder->Capacity * 2 : 2;
-	char* buffer = malloc(capacity + 1);
-
-	for (size_t i = 0; i < builder->Capacity; i++) {
-		buffer[i] = builder->Buffer[i];
-	}
-
-	free(builder->Buffer);
-	builder->Buffer = buffer;
-	builder->Capacity = capacity;
-}
-
-StringBuilder* StringBuilderInit() {
-	StringBuilder* builder = calloc(1, sizeof(StringBuilder));
-	builder->Buffer = NULL;
-	builder->Length = 0;
-	builder->Capacity = 0;
-
-	return builder;
-}
-
-void StringBuilderAppendChar(StringBuilder* builder, char chr) {
-	if (builder->Length >= builder->Capacity) {
-		StringBuilderAllocMore(builder);
-	}
-
-	builder->Buffer[builder->Length++] = chr;
-	builder->Buffer[builder->Length] = '\0';
-}
-
-void StringBuilderAppendString(StringBuilder* builder, const char* str) {
-	size_t len = strlen(str);
-
-	for (size_t i = 0; i < len; i++) {
-		StringBuilderAppendChar(builder, str[i]);
-	}
-}
-
-void StringBuilderAppendLLONG(StringBuilder* builder, llong integer) {
-	static char buffer[32];
-	sprintf_s(buffer, 32, "%lld", integer);
-	StringBuilderAppendString(builder, buffer);
-}
-
-void StringBuilderAppendLDOUBLE(StringBuilder* builder, ldouble flt) {
-	static char buffer[32];
-	sprintf_s(buffer, 32, "%Lf", flt);
-	StringBuilderAppendString(builder, buffer);
-}
-
-/*
-	Token Array
-
-	FUNCTIONS:
-
-	> TokenArrayAllocMore()
-	Allocates more data for a TokenArray's buffer. Data sizes double each time (2, 4, 8, 16, 32, 64, etc.).
-	The previous buffer is then freed to prevent memory leaks and a new buffer with the copied data is set.
-
-	> TokenArrayInit()
-	Initialize a TokenArray object
-
-	> TokenArrayAppend()
-	Appends a Token to a TokenArray's buffer. If the length of the TokenAray begins to exceed its capacity the TokenArray
-	will allocate more memory to adjust. 
-*/
-
-void TokenArrayAllocMore(TokenArray* arr) {
-	ullong capacity = arr->Capacity > 0 ? arr->Capacity * 2 : 2;
-	Token* buffer = malloc(sizeof(Token) * capacity);
-
-	for (ullong i = 0; i < arr->Capacity; i++) {
-		buffer[i] = arr->Buffer[i];
-	}
-
-	free(arr->Buffer);
-	arr->Buffer = buffer;
-	arr->Capacity = capacity;
-}
-
-TokenArray* TokenArrayInit() {
-	TokenArray* arr = calloc(1, sizeof(TokenArray));
-	arr->Buffer = NULL;
-	arr->Length = 0;
-	arr->Capacity = 0;
-
-	return arr;
-}
-
-void TokenArrayAppend(TokenArray* arr, Token token) {
-	if (arr->Length >= arr->Capacity) {
-		TokenArrayAllocMore(arr);
-	}
-
-	arr->Buffer[arr->Length++] = token;
-}
-
-/*
-	JsonValue Array
-
-	FUNCTIONS:
-
-	> JsonValueArrayAllocMore()
-	Allocates more data for JsonValueArray's buffer. Data sizes double each time (2, 4, 8, 16, 32, 64, etc.).
-	The previous buffer is then freed to prevent memory leaks and a new buffer with the copied data is set.
-
-	> JsonValueArrayInit()
-	Initialize a JsonValueArray object
-
-	> JsonValueArrayAppend()
-	Appends a JsonValue to a JsonValueArray's buffer. If the length of the JsonValueArray begins to exceed its capacity
-	the JsonValueArray will allocate more memory to adjust
-*/
-
-void JsonValueArrayAllocMore(JsonValueArray* arr) {
-	ullong capacity = arr->Capacity > 0 ? arr->Capacity * 2 : 2;
-	JsonValue* buffer = malloc(sizeof(JsonValue) * capacity);
-
-	for (ullong i = 0; i < arr->Capacity; i++) {
-		buffer[i] = arr->Buffer[i];
-	}
-
-	free(arr->Buffer);
-	arr->Buffer = buffer;
-	arr->Capacity = capacity;
-}
-
-JsonValueArray* JsonValueArrayInit() {
-	JsonValueArray* arr = calloc(1, sizeof(JsonValueArray));
-	arr->Buffer = NULL;
-	arr->Length = 0;
-	arr->Capacity = 0;
-
-	return arr;
-}
-
-void JsonValueArrayAppend(JsonValueArray* arr, JsonValue value) {
-	if (arr->Length >= arr->Capacity) {
-		JsonValueArrayAllocMore(arr);
-	}
-
-	arr->Buffer[arr->Length++] = value;
-}
-
-void JsonValueArrayRemove(JsonValueArray* arr, ullong index) {
-	JsonValue* buffer = malloc(sizeof(JsonValue) * arr->Capacity);
-
-	for (ullong i = 0, x = 0; i < arr->Length; i++) {
-		if (i != index) {
-			buffer[x++] = arr->Buffer[i];
-		}
-	}
-
-	free(arr->Buffer);
-	arr->Buffer = buffer;
-	arr->Length--;
-}
-
-/*
-	JsonPair Array
-
-	FUNCTIONS:
-
-	> JsonPairArrayAllocMore()
-	Allocates more data for a JsonPairArray's buffer. Data sizes double each time (2, 4, 8, 16, 32, 64, etc.).
-	The previous buffer is then freed to prefvent memory leaks and a new buffer with the copied data i sset.
-
-	> JsonPairArrayInit()
-	Initialize a JsonPairArray object
-
-	> JsonPairArrayAllocMore()
-	Appends a JsonPair to a JsonPairArray's buffer. If the length of the JsonPairArray begins to exceed its capacity the
-	JsonPairArray will allocate more memory to adjust. 
-*/
-
-void JsonPairArrayAllocMore(JsonPairArray* arr) {
-	ullong capacity = arr->Capacity > 0 ? arr->Capacity * 2 : 2;
-	JsonPair* buffer = malloc(sizeof(JsonPair) * capacity);
-
-	for (ullong i = 0; i < arr->Capacity; i++) {
-		buffer[i] = arr->Buffer[i];
-	}
-
-	free(arr->Buffer);
-	arr->Buffer = buffer;
-	arr->Capacity = capacity;
-}
-
-JsonPairArray* JsonPairArrayInit() {
-	JsonPairArray* arr = calloc(1, sizeof(JsonPairArray));
-	arr->Buffer = NULL;
-	arr->Length = 0;
-	arr->Capacity = 0;
-
-	return arr;
-}
-
-void JsonPairArrayAppend(JsonPairArray* arr, JsonPair pair) {
-	if (arr->Length >= arr->Capacity) {
-		JsonPairArrayAllocMore(arr);
-	}
-
-	arr->Buffer[arr->Length++] = pair;
-}
-
-void JsonPairArrayRemove(JsonPairArray* arr, ullong index) {
-	JsonPair* buffer = malloc(sizeof(JsonPair) * arr->Capacity);
-
-	for (ullong i = 0, x = 0; i < arr->Length; i++) {
-		if (i != index) {
-			buffer[x++] = arr->Buffer[i];
-		}
-	}
-
-	free(arr->Buffer);
-	arr->Buffer = buffer;
-	arr->Length--;
-}
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "include/containers.h"
+#include "include/converters.h"
+#include "include/shapes.h"
+#include "include/interning.h"
+
+#define SUCCESS 1
+#define FAILURE 0
+
+#define TRUE 1
+#define FALSE 0
+
+/*
+	String Builder
+
+	MACROS:
+
+	> STRING_BUILDER_MIN_CAPACITY
+	Capacity a StringBuilder starts at the first time it has to grow
+
+	FUNCTIONS:
+
+	> StringBuilderGrow()
+	Makes sure a StringBuilder can take 'length' more chars. The capacity at least doubles each time it grows, so
+	appending n chars only reallocates O(log n) times. An extra byte is always allocated ontop of the capacity for
+	the null terminator
+
+	> StringBuilderReserve()
+	Makes sure a StringBuilder can hold at least 'capacity' chars (plus the null terminator) without growing again
+
+	> StringBuilderShrinkToFit()
+	Shrinks a StringBuilder's buffer so that its capacity matches its length
+
+	> StringBuilderInit()
+	Initialize a StringBuilder object
+
+	> StringBuilderInitSink()
+	Initialize a StringBuilder object which streams its contents to a sink (e.g., FileWriteSink()) instead of growing.
+	The buffer is allocated once with the given capacity and is flushed to the sink whenever it fills up
+
+	> SinkWrite()
+	Passes chars to a StringBuilder's sink. Once the sink has failed nothing else is passed to it
+
+	> StringBuilderFlush()
+	Passes everything in a StringBuilder's buffer to its sink and empties the buffer. Returns FAILURE if the sink has
+	failed at any point, does nothing for StringBuilders without a sink
+
+	> StringBuilderFinish()
+	Null terminates a StringBuilder's buffer, frees the StringBuilder and returns the buffer, which belongs to the
+	caller from then on. Returns an empty string if nothing was appended
+
+	> StringBuilderAppendChar()
+	Appends a char to a StringBuilder's buffer. If the length of the StringBuilder begins to exceed its capacity
+	the StringBuilder will allocate more memory to adjust. 
+
+	> StringBuilderAppendString()
+	Appends a null terminated string to a StringBuilder's buffer (see StringBuilderAppendBytes())
+
+	> StringBuilderAppendBytes()
+	Appends 'length' chars to a StringBuilder's buffer in one copy. Used when the length is already known (e.g., a
+	key's KeyLength), so the chars do not have to be measured. Chunks bigger than a sink StringBuilder's whole buffer
+	are passed straight to the sink
+
+	> StringBuilderAppendLLONG()
+	Appends a long long to a StringBuilder's buffer. The long long is first converted to a string using IntToString()
+	and is then passed to StringBuilderAppendBytes()
+
+	> StringBuilderAppendDOUBLE()
+	Appends a double to a StringBuilder's buffer. The double is first converted to the shortest string which reads
+	back as the same double using DoubleToString() and is then passed to StringBuilderAppendBytes()
+
+	> StringBuilderAppendLDOUBLE()
+	Appends a long double to a StringBuilder's buffer. The long double is first converted to the shortest string which
+	reads back as the same long double using LDoubleToString() and is then passed to StringBuilderAppendBytes()
+
+	NOTES:
+
+	The buffer is only null terminated by StringBuilderFinish(), appending never writes a terminator. Code which
+	reads builder->Buffer before that has to use builder->Length
+
+	A StringBuilder with a sink never holds more than its capacity, so it uses the same amount of memory no matter
+	how much is written through it. Its buffer only holds what has not been flushed yet, so it should be flushed and
+	deleted with StringBuilderDelete() rather than finished
+*/
+
+#define STRING_BUILDER_MIN_CAPACITY 64
+
+void StringBuilderGrow(StringBuilder* builder, ullong length) {
+	if (builder->Length + length <= builder->Capacity) {
+		return;
+	}
+
+	if (builder->Sink != NULL) {
+		StringBuilderFlush(builder);
+
+		if (length <= builder->Capacity) {
+			return;
+		}
+	}
+
+	ullong capacity = builder->Capacity > 0 ? builder->Capacity * 2 : STRING_BUILDER_MIN_CAPACITY;
+
+	while (capacity < builder->Length + length) {
+		capacity *= 2;
+	}
+
+	StringBuilderReserve(builder, capacity);
+}
+
+void StringBuilderReserve(StringBuilder* builder, ullong capacity) {
+	if (capacity <= builder->Capacity) {
+		return;
+	}
+
+	builder->Buffer = JsonRealloc(builder->Buffer, capacity + 1);
+	builder->Capacity = capacity;
+}
+
+void StringBuilderShrinkToFit(StringBuilder* builder) {
+	if (builder->Buffer == NULL) {
+		return;
+	}
+
+	builder->Buffer = JsonRealloc(builder->Buffer, builder->Length + 1);
+	builder->Capacity = builder->Length;
+}
+
+StringBuilder* StringBuilderInit() {
+	StringBuilder* builder = JsonCalloc(1, sizeof(StringBuilder));
+	builder->Buffer = NULL;
+	builder->Length = 0;
+	builder->Capacity = 0;
+	builder->Sink = NULL;
+	builder->SinkData = NULL;
+	builder->Failed = FALSE;
+
+	return builder;
+}
+
+StringBuilder* StringBuilderInitSink(StringBuilderSink sink, void* data, ullong capacity) {
+	StringBuilder* builder = StringBuilderInit();
+	StringBuilderReserve(builder, capacity > 0 ? capacity : STRING_BUILDER_MIN_CAPACITY);
+	builder->Sink = sink;
+	builder->SinkData = data;
+
+	return builder;
+}
+
+static void SinkWrite(StringBuilder* builder, const char* data, ullong length) {
+	if (!builder->Failed && length > 0 && builder->Sink(builder->SinkData, data, length) == FAILURE) {
+		builder->Failed = TRUE;
+	}
+}
+
+int StringBuilderFlush(StringBuilder* builder) {
+	if (builder->Sink == NULL) {
+		return SUCCESS;
+	}
+
+	SinkWrite(builder, builder->Buffer, builder->Length);
+	builder->Length = 0;
+
+	return builder->Failed ? FAILURE : SUCCESS;
+}
+
+char* StringBuilderFinish(StringBuilder* builder) {
+	if (builder->Buffer == NULL) {
+		builder->Buffer = JsonMalloc(1);
+	}
+
+	char* buffer = builder->Buffer;
+	buffer[builder->Length] = '\0';
+	JsonFree(builder);
+
+	return buffer;
+}
+
+void StringBuilderAppendChar(StringBuilder* builder, char chr) {
+	if (builder->Length >= builder->Capacity) {
+		StringBuilderGrow(builder, 1);
+	}
+
+	builder->Buffer[builder->Length++] = chr;
+}
+
+void StringBuilderAppendString(StringBuilder* builder, const char* str) {
+	StringBuilderAppendBytes(builder, str, strlen(str));
+}
+
+void StringBuilderAppendBytes(StringBuilder* builder, const char* data, ullong length) {
+	if (builder->Sink != NULL && builder->Length + length > builder->Capacity) {
+		StringBuilderFlush(builder);
+
+		if (length > builder->Capacity) {
+			SinkWrite(builder, data, length);
+			return;
+		}
+	}
+
+	StringBuilderGrow(builder, length);
+	memcpy(builder->Buffer + builder->Length, data, length);
+	builder->Length += length;
+}
+
+void StringBuilderAppendLLONG(StringBuilder* builder, llong integer) {
+	char buffer[LLONG_STRING_SIZE];
+	ullong length = IntToString(buffer, integer);
+	StringBuilderAppendBytes(builder, buffer, length);
+}
+
+void StringBuilderAppendDOUBLE(StringBuilder* builder, double flt) {
+	char buffer[DOUBLE_STRING_SIZE];
+	ullong length = DoubleToString(buffer, flt);
+	StringBuilderAppendBytes(builder, buffer, length);
+}
+
+void StringBuilderAppendLDOUBLE(StringBuilder* builder, ldouble flt) {
+	char buffer[LDOUBLE_STRING_SIZE];
+	ullong length = LDoubleToString(buffer, flt);
+	StringBuilderAppendBytes(builder, buffer, length);
+}
+
+/*
+	Token Array
+
+	FUNCTIONS:
+
+	> TokenArrayAllocMore()
+	Allocates more data for a TokenArray's buffer. Data sizes double each time (2, 4, 8, 16, 32, 64, etc.).
+	The buffer is grown with realloc() so the existing data does not have to be copied by hand
+
+	> TokenArrayReserve()
+	Makes sure a TokenArray can hold at least 'capacity' Tokens without growing again
+
+	> TokenArrayShrinkToFit()
+	Shrinks a TokenArray's buffer so that its capacity matches its length
+
+	> TokenArrayInit()
+	Initialize a TokenArray object
+
+	> TokenArrayAppend()
+	Appends a Token to a TokenArray's buffer. If the length of the TokenAray begins to exceed its capacity the TokenArray
+	will allocate more memory to adjust. 
+*/
+
+void TokenArrayAllocMore(TokenArray* arr) {
+	TokenArrayReserve(arr, arr->Capacity > 0 ? arr->Capacity * 2 : 2);
+}
+
+void TokenArrayReserve(TokenArray* arr, ullong capacity) {
+	if (capacity <= arr->Capacity) {
+		return;
+	}
+
+	arr->Buffer = JsonRealloc(arr->Buffer, sizeof(Token) * capacity);
+	arr->Capacity = capacity;
+}
+
+void TokenArrayShrinkToFit(TokenArray* arr) {
+	if (arr->Length == 0) {
+		JsonFree(arr->Buffer);
+		arr->Buffer = NULL;
+		arr->Capacity = 0;
+		return;
+	}
+
+	arr->Buffer = JsonRealloc(arr->Buffer, sizeof(Token) * arr->Length);
+	arr->Capacity = arr->Length;
+}
+
+TokenArray* TokenArrayInit() {
+	TokenArray* arr = JsonCalloc(1, sizeof(TokenArray));
+	arr->Buffer = NULL;
+	arr->Length = 0;
+	arr->Capacity = 0;
+
+	return arr;
+}
+
+void TokenArrayAppend(TokenArray* arr, Token token) {
+	if (arr->Length >= arr->Capacity) {
+		TokenArrayAllocMore(arr);
+	}
+
+	arr->Buffer[arr->Length++] = token;
+}
+
+/*
+	JsonValue Array
+
+	FUNCTIONS:
+
+	> JsonValueArrayAllocMore()
+	Allocates more data for JsonValueArray's buffer. Data sizes double each time (2, 4, 8, 16, 32, 64, etc.).
+	The buffer is grown with realloc() so the existing data does not have to be copied by hand
+
+	> JsonValueArrayReserve()
+	Makes sure a JsonValueArray can hold at least 'capacity' JsonValues without growing again
+
+	> JsonValueArrayShrinkToFit()
+	Shrinks a JsonValueArray's buffer so that its capacity matches its length
+
+	> JsonValueArrayInit()
+	Initialize a JsonValueArray object
+
+	> JsonValueArrayMakeUnique()
+	Gives a JsonValueArray its own buffer if the buffer is shared with copies (see JsonListCopy()). The elements are
+	copied with JsonValueCopy(), which copies nested lists and exprs the same way (see JsonListCopy()). Every
+	function below which modifies a JsonValueArray calls this first
+
+	> JsonValueArrayPack()
+	Moves the elements of a JsonValueArray into a packed JsonInt or JsonFloat array (see JSON_PACKED_INT and
+	JSON_PACKED_FLOAT) and frees their JsonValues. Fails without changing anything if an element has another type
+
+	> JsonValueArrayUnpack()
+	Moves the elements of a packed JsonValueArray back into JsonValues
+
+	> JsonValueArrayAppend()
+	Appends a JsonValue to a JsonValueArray's buffer. If the length of the JsonValueArray begins to exceed its capacity
+	the JsonValueArray will allocate more memory to adjust
+	When the JsonValueArray is packed a matching number is stored in the packed array and its JsonData is freed,
+	anything else unpacks the JsonValueArray first
+
+	> JsonValueArrayRemove()
+	Removes the JsonValue at an index. The elements after it are moved down in place with memmove()
+
+	> JsonValueArraySwapRemove()
+	Removes the JsonValue at an index by moving the last element into its place. Does not keep the order of the
+	elements but never moves more than one element
+
+	> JsonValueArrayRemoveRange()
+	Removes 'count' JsonValues starting at an index with a single memmove()
+
+	> JsonValueArrayRemoveIf()
+	Removes every JsonValue that the predicate returns true for. The remaining elements are compacted in one pass and
+	keep their order. Returns the number of elements which were removed
+
+	> PackedElementSize()
+	Gets the size of one element of a JsonValueArray, which depends on how the JsonValueArray is packed
+
+	> PackedStorage()
+	Gets the buffer which holds the elements of a JsonValueArray (Buffer, or Numbers when it is packed)
+
+	> ValueArrayCopyBuffer()
+	Replaces a JsonValueArray's shared buffer with a copy of its own (see JsonValueArrayMakeUnique())
+
+	NOTES:
+
+	None of the removal functions free the data inside of the removed JsonValues, this is left to the caller
+	(see JsonRemoveElement() in json-parser.c). Indexes are not bounds checked
+
+	Every function which allocates or frees selects the JsonValueArray's own allocator while it does so (see
+	JsonSelectAllocator()), the same goes for the JsonPairArray functions below
+
+	A packed JsonValueArray stores a number in 8 bytes (or sizeof(JsonFloat)), where a JsonValue with its JsonData
+	and boxed number takes around 50. The removal, reserve and copy functions work on packed arrays directly.
+	JsonValueArrayRemoveIf() unpacks first as its predicate takes JsonValues
+*/
+
+static ullong PackedElementSize(JsonValueArray* arr) {
+	switch (arr->Packing) {
+		case JSON_PACKED_INT:
+			return sizeof(JsonInt);
+		case JSON_PACKED_FLOAT:
+			return sizeof(JsonFloat);
+	}
+
+	return sizeof(JsonValue);
+}
+
+static void** PackedStorage(JsonValueArray* arr) {
+	return arr->Packing != JSON_PACKED_NONE
+		? &arr->Numbers
+		: (void**)&arr->Buffer;
+}
+
+void JsonValueArrayAllocMore(JsonValueArray* arr) {
+	JsonValueArrayReserve(arr, arr->Capacity > 0 ? arr->Capacity * 2 : 2);
+}
+
+void JsonValueArrayReserve(JsonValueArray* arr, ullong capacity) {
+	JsonValueArrayMakeUnique(arr);
+
+	if (capacity <= arr->Capacity) {
+		return;
+	}
+
+	JsonAllocator* previous = JsonSelectAllocator(arr->Allocator);
+	void** storage = PackedStorage(arr);
+	*storage = JsonRealloc(*storage, PackedElementSize(arr) * capacity);
+	arr->Capacity = capacity;
+	JsonSelectAllocator(previous);
+}
+
+void JsonValueArrayShrinkToFit(JsonValueArray* arr) {
+	JsonValueArrayMakeUnique(arr);
+
+	JsonAllocator* previous = JsonSelectAllocator(arr->Allocator);
+	void** storage = PackedStorage(arr);
+
+	if (arr->Length == 0) {
+		JsonFree(*storage);
+		*storage = NULL;
+	}
+	else {
+		*storage = JsonRealloc(*storage, PackedElementSize(arr) * arr->Length);
+	}
+
+	arr->Capacity = arr->Length;
+	JsonSelectAllocator(previous);
+}
+
+JsonValueArray* JsonValueArrayInit() {
+	JsonValueArray* arr = JsonPoolCalloc(sizeof(JsonValueArray));
+	arr->Buffer = NULL;
+	arr->Length = 0;
+	arr->Capacity = 0;
+	arr->Allocator = JsonAllocatorRetain(JsonGetAllocator());
+
+	return arr;
+}
+
+static void ValueArrayCopyBuffer(JsonValueArray* arr) {
+	if (arr->Packing != JSON_PACKED_NONE) {
+		void* numbers = JsonMalloc(PackedElementSize(arr) * arr->Capacity);
+		memcpy(numbers, arr->Numbers, PackedElementSize(arr) * arr->Length);
+		arr->Numbers = numbers;
+		return;
+	}
+
+	JsonValue* buffer = JsonMalloc(sizeof(JsonValue) * arr->Capacity);
+
+	for (ullong i = 0; i < arr->Length; i++) {
+		JsonValue* copy = JsonValueCopy(&arr->Buffer[i]);
+		buffer[i] = *copy;
+		JsonPoolFree(copy, sizeof(JsonValue));
+	}
+
+	arr->Buffer = buffer;
+}
+
+void JsonValueArrayMakeUnique(JsonValueArray* arr) {
+	if (arr->RefCount == NULL) {
+		return;
+	}
+
+	JsonAllocator* previous = JsonSelectAllocator(arr->Allocator);
+
+	if (*arr->RefCount == 1) {
+		JsonPoolFree(arr->RefCount, sizeof(ullong));
+	}
+	else {
+		(*arr->RefCount)--;
+		ValueArrayCopyBuffer(arr);
+	}
+
+	arr->RefCount = NULL;
+	JsonSelectAllocator(previous);
+}
+
+int JsonValueArrayPack(JsonValueArray* arr, int packing) {
+	if (arr->Packing == packing) {
+		return SUCCESS;
+	}
+
+	if (arr->Packing != JSON_PACKED_NONE) {
+		return FAILURE;
+	}
+
+	JsonType type = packing == JSON_PACKED_INT ? JSON_INT : JSON_FLOAT;
+
+	for (ullong i = 0; i < arr->Length; i++) {
+		if (arr->Buffer[i].Type != type) {
+			return FAILURE;
+		}
+	}
+
+	JsonValueArrayMakeUnique(arr);
+
+	JsonAllocator* previous = JsonSelectAllocator(arr->Allocator);
+	arr->Packing = packing;
+	arr->Numbers = arr->Capacity > 0 ? JsonMalloc(PackedElementSize(arr) * arr->Capacity) : NULL;
+
+	for (ullong i = 0; i < arr->Length; i++) {
+		if (packing == JSON_PACKED_INT) {
+			((JsonInt*)arr->Numbers)[i] = *arr->Buffer[i].Data->Int;
+		}
+		else {
+			((JsonFloat*)arr->Numbers)[i] = *arr->Buffer[i].Data->Float;
+		}
+
+		JsonDataDelete(&arr->Buffer[i]);
+	}
+
+	JsonFree(arr->Buffer);
+	arr->Buffer = NULL;
+	JsonSelectAllocator(previous);
+
+	return SUCCESS;
+}
+
+void JsonValueArrayUnpack(JsonValueArray* arr) {
+	if (arr->Packing == JSON_PACKED_NONE) {
+		return;
+	}
+
+	JsonValueArrayMakeUnique(arr);
+
+	JsonAllocator* previous = JsonSelectAllocator(arr->Allocator);
+	JsonValue* buffer = arr->Capacity > 0 ? JsonMalloc(sizeof(JsonValue) * arr->Capacity) : NULL;
+
+	for (ullong i = 0; i < arr->Length; i++) {
+		JsonValue* value = arr->Packing == JSON_PACKED_INT
+			? JsonValueInit(AllocJsonInt(((JsonInt*)arr->Numbers)[i]), JSON_INT)
+			: JsonValueInit(AllocJsonFloat(((JsonFloat*)arr->Numbers)[i]), JSON_FLOAT);
+
+		buffer[i] = *value;
+		JsonPoolFree(value, sizeof(JsonValue));
+	}
+
+	JsonFree(arr->Numbers);
+	arr->Numbers = NULL;
+	arr->Packing = JSON_PACKED_NONE;
+	arr->Buffer = buffer;
+	JsonSelectAllocator(previous);
+}
+
+void JsonValueArrayAppend(JsonValueArray* arr, JsonValue value) {
+	JsonValueArrayMakeUnique(arr);
+
+	if ((arr->Packing == JSON_PACKED_INT && value.Type != JSON_INT) ||
+		(arr->Packing == JSON_PACKED_FLOAT && value.Type != JSON_FLOAT)) {
+		JsonValueArrayUnpack(arr);
+	}
+
+	if (arr->Length >= arr->Capacity) {
+		JsonValueArrayAllocMore(arr);
+	}
+
+	if (arr->Packing == JSON_PACKED_NONE) {
+		arr->Buffer[arr->Length++] = value;
+		return;
+	}
+
+	if (arr->Packing == JSON_PACKED_INT) {
+		((JsonInt*)arr->Numbers)[arr->Length++] = *value.Data->Int;
+	}
+	else {
+		((JsonFloat*)arr->Numbers)[arr->Length++] = *value.Data->Float;
+	}
+
+	JsonAllocator* previous = JsonSelectAllocator(arr->Allocator);
+	JsonDataDelete(&value);
+	JsonSelectAllocator(previous);
+}
+
+void JsonValueArrayRemove(JsonValueArray* arr, ullong index) {
+	JsonValueArrayRemoveRange(arr, index, 1);
+}
+
+void JsonValueArraySwapRemove(JsonValueArray* arr, ullong index) {
+	JsonValueArrayMakeUnique(arr);
+
+	char* storage = *PackedStorage(arr);
+	ullong size = PackedElementSize(arr);
+	arr->Length--;
+
+	memmove(storage + size * index, storage + size * arr->Length, size);
+}
+
+void JsonValueArrayRemoveRange(JsonValueArray* arr, ullong index, ullong count) {
+	JsonValueArrayMakeUnique(arr);
+
+	char* storage = *PackedStorage(arr);
+	ullong size = PackedElementSize(arr);
+
+	memmove(
+		storage + size * index,
+		storage + size * (index + count),
+		size * (arr->Length - index - count)
+	);
+
+	arr->Length -= count;
+}
+
+ullong JsonValueArrayRemoveIf(JsonValueArray* arr, JsonValuePredicate predicate, void* data) {
+	JsonValueArrayUnpack(arr);
+	JsonValueArrayMakeUnique(arr);
+
+	ullong x = 0;
+
+	for (ullong i = 0; i < arr->Length; i++) {
+		if (!predicate(&arr->Buffer[i], data)) {
+			arr->Buffer[x++] = arr->Buffer[i];
+		}
+	}
+
+	ullong removed = arr->Length - x;
+	arr->Length = x;
+	return removed;
+}
+
+/*
+	JsonPair Array
+
+	FUNCTIONS:
+
+	> JsonPairArrayAllocMore()
+	Allocates more data for a JsonPairArray's buffer. Data sizes double each time (2, 4, 8, 16, 32, 64, etc.).
+	The buffer is grown with realloc() so the existing data does not have to be copied by hand
+
+	> JsonPairArrayReserve()
+	Makes sure a JsonPairArray can hold at least 'capacity' JsonPairs without growing again
+
+	> JsonPairArrayShrinkToFit()
+	Shrinks a JsonPairArray's buffer so that its capacity matches its length
+
+	> JsonPairArrayInit()
+	Initialize a JsonPairArray object
+
+	> JsonPairArrayMakeUnique()
+	Gives a JsonPairArray its own buffer if the buffer is shared with copies (see JsonExprCopy()). The pairs are
+	copied with JsonPairCopy(), which copies nested lists and exprs the same way (see JsonExprCopy()). Every
+	function below which modifies a JsonPairArray calls this first
+	A JsonPairArray which uses a shape keeps using it, only the values are copied
+
+	> PairArrayCopyBuffer()
+	Replaces a JsonPairArray's shared buffer with a copy of its own (see JsonPairArrayMakeUnique())
+
+	> JsonPairArrayUnshape()
+	Gives a JsonPairArray which uses a shape (see shapes.c) its own copy of every key, or its own reference for keys
+	which are interned, and stops it from using the shape. Every function below which adds or removes pairs calls
+	this first, as the pairs of a JsonPairArray which uses a shape have to match the shape's keys
+
+	> JsonPairArrayAppend()
+	Appends a JsonPair to a JsonPairArray's buffer. If the length of the JsonPairArray begins to exceed its capacity the
+	JsonPairArray will allocate more memory to adjust. 
+
+	> JsonPairArrayRemove()
+	Removes the JsonPair at an index. The pairs after it are moved down in place with memmove()
+
+	> JsonPairArraySwapRemove()
+	Removes the JsonPair at an index by moving the last pair into its place. Does not keep the order of the pairs
+
+	> JsonPairArrayRemoveRange()
+	Removes 'count' JsonPairs starting at an index with a single memmove()
+
+	> JsonPairArrayRemoveIf()
+	Removes every JsonPair that the predicate returns true for. The remaining pairs are compacted in one pass and keep
+	their order. Returns the number of pairs which were removed
+
+	NOTES:
+
+	None of the removal functions free the keys or values of the removed JsonPairs, this is left to the caller
+	(see JsonRemoveKey() in json-parser.c). Indexes are not bounds checked
+*/
+
+void JsonPairArrayAllocMore(JsonPairArray* arr) {
+	JsonPairArrayReserve(arr, arr->Capacity > 0 ? arr->Capacity * 2 : 2);
+}
+
+void JsonPairArrayReserve(JsonPairArray* arr, ullong capacity) {
+	JsonPairArrayMakeUnique(arr);
+
+	if (capacity <= arr->Capacity) {
+		return;
+	}
+
+	JsonAllocator* previous = JsonSelectAllocator(arr->Allocator);
+	arr->Buffer = JsonRealloc(arr->Buffer, sizeof(JsonPair) * capacity);
+	arr->Capacity = capacity;
+	JsonSelectAllocator(previous);
+}
+
+void JsonPairArrayShrinkToFit(JsonPairArray* arr) {
+	JsonPairArrayMakeUnique(arr);
+
+	JsonAllocator* previous = JsonSelectAllocator(arr->Allocator);
+
+	if (arr->Length == 0) {
+		JsonFree(arr->Buffer);
+		arr->Buffer = NULL;
+	}
+	else {
+		arr->Buffer = JsonRealloc(arr->Buffer, sizeof(JsonPair) * arr->Length);
+	}
+
+	arr->Capacity = arr->Length;
+	JsonSelectAllocator(previous);
+}
+
+JsonPairArray* JsonPairArrayInit() {
+	JsonPairArray* arr = JsonPoolCalloc(sizeof(JsonPairArray));
+	arr->Buffer = NULL;
+	arr->Length = 0;
+	arr->Capacity = 0;
+	arr->Allocator = JsonAllocatorRetain(JsonGetAllocator());
+
+	return arr;
+}
+
+static void PairArrayCopyBuffer(JsonPairArray* arr) {
+	JsonPair* buffer = JsonMalloc(sizeof(JsonPair) * arr->Capacity);
+
+	for (ullong i = 0; i < arr->Length; i++) {
+		if (arr->Shape != NULL) {
+			buffer[i] = arr->Buffer[i];
+			buffer[i].Value = JsonValueCopy(arr->Buffer[i].Value);
+			continue;
+		}
+
+		JsonPair* copy = JsonPairCopy(&arr->Buffer[i]);
+		buffer[i] = *copy;
+		JsonPoolFree(copy, sizeof(JsonPair));
+	}
+
+	arr->Buffer = buffer;
+}
+
+void JsonPairArrayMakeUnique(JsonPairArray* arr) {
+	if (arr->RefCount == NULL) {
+		return;
+	}
+
+	JsonAllocator* previous = JsonSelectAllocator(arr->Allocator);
+
+	if (*arr->RefCount == 1) {
+		JsonPoolFree(arr->RefCount, sizeof(ullong));
+	}
+	else {
+		(*arr->RefCount)--;
+		PairArrayCopyBuffer(arr);
+	}
+
+	arr->RefCount = NULL;
+	JsonSelectAllocator(previous);
+}
+
+void JsonPairArrayUnshape(JsonPairArray* arr) {
+	if (arr->Shape == NULL) {
+		return;
+	}
+
+	JsonPairArrayMakeUnique(arr);
+
+	JsonAllocator* previous = JsonSelectAllocator(arr->Allocator);
+
+	for (ullong i = 0; i < arr->Length; i++) {
+		JsonPair* pair = &arr->Buffer[i];
+		pair->Key = pair->KeyInterned ? JsonStringRetain(pair->Key) : AllocJsonString(pair->Key);
+	}
+
+	JsonShapeRelease(arr->Shape);
+	arr->Shape = NULL;
+	JsonSelectAllocator(previous);
+}
+
+void JsonPairArrayAppend(JsonPairArray* arr, JsonPair pair) {
+	JsonPairArrayUnshape(arr);
+	JsonPairArrayMakeUnique(arr);
+
+	if (arr->Length >= arr->Capacity) {
+		JsonPairArrayAllocMore(arr);
+	}
+
+	arr->Buffer[arr->Length++] = pair;
+}
+
+void JsonPairArrayRemove(JsonPairArray* arr, ullong index) {
+	JsonPairArrayRemoveRange(arr, index, 1);
+}
+
+void JsonPairArraySwapRemove(JsonPairArray* arr, ullong index) {
+	JsonPairArrayUnshape(arr);
+	JsonPairArrayMakeUnique(arr);
+
+	arr->Buffer[index] = arr->Buffer[--arr->Length];
+}
+
+void JsonPairArrayRemoveRange(JsonPairArray* arr, ullong index, ullong count) {
+	JsonPairArrayUnshape(arr);
+	JsonPairArrayMakeUnique(arr);
+
+	memmove(
+		&arr->Buffer[index],
+		&arr->Buffer[index + count],
+		sizeof(JsonPair) * (arr->Length - index - count)
+	);
+
+	arr->Length -= count;
+}
+
+ullong JsonPairArrayRemoveIf(JsonPairArray* arr, JsonPairPredicate predicate, void* data) {
+	JsonPairArrayUnshape(arr);
+	JsonPairArrayMakeUnique(arr);
+
+	ullong x = 0;
+
+	for (ullong i = 0; i < arr->Length; i++) {
+		if (!predicate(&arr->Buffer[i], data)) {
+			arr->Buffer[x++] = arr->Buffer[i];
+		}
+	}
+
+	ullong removed = arr->Length - x;
+	arr->Length = x;
+	return removed;
+}
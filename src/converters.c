@@ -1,39 +1,755 @@
-
-#include <stdlib.h>
-#include <string.h>
-#include <ctype.h>
-#include "include/converters.h"
-
-int StringToInt(const char* str, JsonInt** integer) {
-	char* extra;
-	JsonInt ret = strtoll(str, &extra, 10);
-
-	if ((ret == LLONG_MAX || ret == LLONG_MIN) && errno == ERANGE) {
-		return FAILURE;
-	}
-
-	size_t i = 0;
-	for (size_t i = 0; i < strlen(extra); i++) {
-		if (!isspace(extra[i])) {
-			return FAILURE;
-		}
-	}
-
-	*integer = AllocJsonInt(ret);
-	return SUCCESS;
-}
-
-int StringToFloat(const char* str, JsonFloat** flt) {
-	char* extra;
-	JsonFloat ret = strtold(str, &extra);
-
-	size_t i = 0;
-	for (size_t i = 0; i < strlen(extra); i++) {
-		if (!isspace(extra[i])) {
-			return FAILURE;
-		}
-	}
-
-	*flt = AllocJsonFloat(ret);
-	return SUCCESS;
-}
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <float.h>
+#include "include/converters.h"
+
+#define TRUE 1
+#define FALSE 0
+
+int StringToInt(const char* str, JsonInt** integer) {
+	char* extra;
+	JsonInt ret = strtoll(str, &extra, 10);
+
+	if ((ret == LLONG_MAX || ret == LLONG_MIN) && errno == ERANGE) {
+		return FAILURE;
+	}
+
+	size_t i = 0;
+	for (size_t i = 0; i < strlen(extra); i++) {
+		if (!isspace(extra[i])) {
+			return FAILURE;
+		}
+	}
+
+	*integer = AllocJsonInt(ret);
+	return SUCCESS;
+}
+
+int StringToFloat(const char* str, JsonFloat** flt) {
+	char* extra;
+#ifdef JSON_FLOAT_DOUBLE
+	JsonFloat ret = strtod(str, &extra);
+#else
+	JsonFloat ret = strtold(str, &extra);
+#endif
+
+	size_t i = 0;
+	for (size_t i = 0; i < strlen(extra); i++) {
+		if (!isspace(extra[i])) {
+			return FAILURE;
+		}
+	}
+
+	*flt = AllocJsonFloat(ret);
+	return SUCCESS;
+}
+
+/*
+	Converting Integers To Strings
+
+	FUNCTIONS:
+
+	> IntToString()
+	Writes the decimal digits of an integer to a buffer of at least LLONG_STRING_SIZE chars and returns how many
+	chars were written. The digits are produced two at a time from the DigitPairs table, so a 19 digit integer only
+	takes 10 divisions. The buffer is not null terminated
+*/
+
+static const char DigitPairs[201] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+ullong IntToString(char* buffer, llong integer) {
+	unsigned long long value = integer < 0 ? 0ull - (unsigned long long)integer : (unsigned long long)integer;
+	char digits[LLONG_STRING_SIZE];
+	int index = LLONG_STRING_SIZE;
+
+	while (value >= 100) {
+		unsigned int pair = (unsigned int)(value % 100);
+		value /= 100;
+		index -= 2;
+		memcpy(digits + index, DigitPairs + pair * 2, 2);
+	}
+
+	if (value >= 10) {
+		index -= 2;
+		memcpy(digits + index, DigitPairs + value * 2, 2);
+	}
+	else {
+		digits[--index] = (char)('0' + value);
+	}
+
+	ullong length = 0;
+
+	if (integer < 0) {
+		buffer[length++] = '-';
+	}
+
+	memcpy(buffer + length, digits + index, LLONG_STRING_SIZE - index);
+	return length + LLONG_STRING_SIZE - index;
+}
+
+/*
+	Converting Floats To Strings
+
+	FUNCTIONS:
+
+	> DiyFpFromDouble()
+	Splits a finite double into its significand and binary exponent, so that the double equals f * 2^e
+
+	> DiyFpNormalize()
+	Shifts a DiyFp's significand left until its top bit is set
+
+	> DiyFpBoundaries()
+	Gets the two points halfway between a double and its neighbours, normalized to the same exponent. Every number
+	strictly between them reads back as the same double
+
+	> DiyFpMultiply()
+	Multiplies two DiyFps, keeping the (rounded) top 64 bits of the product
+
+	> CachedPower()
+	Gets the cached power of ten which brings a DiyFp with the binary exponent 'e' into the range DigitGen() works
+	in, and the decimal exponent 'k' it undoes
+
+	> GrisuRound()
+	Moves the last generated digit closer to the exact value while it stays inside the boundaries
+
+	> DigitGen()
+	Generates the fewest digits that still fall between the boundaries of a double
+
+	> Grisu2()
+	Writes the shortest digits of a positive double which read back as the same double, and the decimal exponent to
+	put after them (the double is about digits * 10^exponent)
+
+	> WriteFixed()
+	Writes digits and a decimal exponent in fixed notation (e.g., 0.0012, 3.5, 1200.0). There is always a decimal
+	point with at least one digit after it, so the number is read back as a JsonFloat rather than a JsonInt
+
+	> DoubleToString()
+	Writes the shortest string that reads back as the same double to a buffer of at least DOUBLE_STRING_SIZE chars
+	and returns how many chars were written. The buffer is not null terminated
+
+	> SplitScientific()
+	Turns the output of printf("%e") (d.ddddde[+-]x) into its significant digits without trailing zeros and the
+	decimal exponent to put after them, in place
+
+	> ReadsBackAs()
+	Checks whether digits * 10^k read back as the given long double. When the power of ten is exact in a long double
+	the one correctly rounded multiplication or division gives the same long double strtold() would, so strtold()
+	is only needed for very big and very small numbers (LDOUBLE_EXACT_DIGITS and LDOUBLE_EXACT_POW10 are the most
+	digits and the biggest power of ten a long double holds exactly)
+
+	> ReadsBackShorter()
+	Checks whether the digits rounded down or up to one digit less read back as the given long double, and if so
+	replaces the digits with them
+
+	> LDoubleToString()
+	Writes the shortest string that reads back as the same long double to a buffer of at least LDOUBLE_STRING_SIZE
+	chars and returns how many chars were written. The buffer is not null terminated
+
+	NOTES:
+
+	Doubles are converted with Grisu2 (Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with
+	Integers"), which only uses 64 bit integer arithmetic. Its output always reads back as the same double, and is
+	the shortest possible for all but a tiny fraction of doubles, where it is one digit longer
+
+	Long doubles which came from a JSON document are almost always the nearest long double to a number with 17
+	significant digits or less, so LDoubleToString() first tries the digits Grisu2 gives for the nearest double, and
+	the same digits rounded to one digit less (in case Grisu2 gave one digit too many). If those do not read back as
+	the same long double it prints DOUBLE_ROUND_TRIP_DIGITS significant digits, which finds the numbers that had 17
+	digits in the document. Only a long double which was computed rather than read falls back to
+	LDOUBLE_ROUND_TRIP_DIGITS significant digits, which are always enough for a 64 bit significand but may be a few
+	more than needed
+
+	Numbers are never written with an exponent as the Lexer does not read them. Not a number and infinity have no
+	JSON representation, they are written as null (the same as DoubleToCanonicalString()) so that the output can
+	always be parsed again
+*/
+
+#define DP_SIGNIFICAND_SIZE 52
+#define DP_EXPONENT_BIAS (0x3FF + DP_SIGNIFICAND_SIZE)
+#define DP_MIN_EXPONENT (-DP_EXPONENT_BIAS)
+#define DP_EXPONENT_MASK 0x7FF0000000000000ull
+#define DP_SIGNIFICAND_MASK 0x000FFFFFFFFFFFFFull
+#define DP_HIDDEN_BIT 0x0010000000000000ull
+
+#define DOUBLE_ROUND_TRIP_DIGITS 17
+#define LDOUBLE_ROUND_TRIP_DIGITS 21
+
+#if LDBL_MANT_DIG >= 64
+#define LDOUBLE_EXACT_DIGITS 19
+#define LDOUBLE_EXACT_POW10 27
+#else
+#define LDOUBLE_EXACT_DIGITS 15
+#define LDOUBLE_EXACT_POW10 22
+#endif
+
+#define CACHED_POWER_MIN_EXPONENT (-348)
+#define CACHED_POWER_STEP 8
+
+typedef struct {
+	unsigned long long f;
+	int e;
+} DiyFp;
+
+static const unsigned long long CachedPowersF[] = {
+	0xfa8fd5a0081c0288ull, 0xbaaee17fa23ebf76ull, 0x8b16fb203055ac76ull,
+	0xcf42894a5dce35eaull, 0x9a6bb0aa55653b2dull, 0xe61acf033d1a45dfull,
+	0xab70fe17c79ac6caull, 0xff77b1fcbebcdc4full, 0xbe5691ef416bd60cull,
+	0x8dd01fad907ffc3cull, 0xd3515c2831559a83ull, 0x9d71ac8fada6c9b5ull,
+	0xea9c227723ee8bcbull, 0xaecc49914078536dull, 0x823c12795db6ce57ull,
+	0xc21094364dfb5637ull, 0x9096ea6f3848984full, 0xd77485cb25823ac7ull,
+	0xa086cfcd97bf97f4ull, 0xef340a98172aace5ull, 0xb23867fb2a35b28eull,
+	0x84c8d4dfd2c63f3bull, 0xc5dd44271ad3cdbaull, 0x936b9fcebb25c996ull,
+	0xdbac6c247d62a584ull, 0xa3ab66580d5fdaf6ull, 0xf3e2f893dec3f126ull,
+	0xb5b5ada8aaff80b8ull, 0x87625f056c7c4a8bull, 0xc9bcff6034c13053ull,
+	0x964e858c91ba2655ull, 0xdff9772470297ebdull, 0xa6dfbd9fb8e5b88full,
+	0xf8a95fcf88747d94ull, 0xb94470938fa89bcfull, 0x8a08f0f8bf0f156bull,
+	0xcdb02555653131b6ull, 0x993fe2c6d07b7facull, 0xe45c10c42a2b3b06ull,
+	0xaa242499697392d3ull, 0xfd87b5f28300ca0eull, 0xbce5086492111aebull,
+	0x8cbccc096f5088ccull, 0xd1b71758e219652cull, 0x9c40000000000000ull,
+	0xe8d4a51000000000ull, 0xad78ebc5ac620000ull, 0x813f3978f8940984ull,
+	0xc097ce7bc90715b3ull, 0x8f7e32ce7bea5c70ull, 0xd5d238a4abe98068ull,
+	0x9f4f2726179a2245ull, 0xed63a231d4c4fb27ull, 0xb0de65388cc8ada8ull,
+	0x83c7088e1aab65dbull, 0xc45d1df942711d9aull, 0x924d692ca61be758ull,
+	0xda01ee641a708deaull, 0xa26da3999aef774aull, 0xf209787bb47d6b85ull,
+	0xb454e4a179dd1877ull, 0x865b86925b9bc5c2ull, 0xc83553c5c8965d3dull,
+	0x952ab45cfa97a0b3ull, 0xde469fbd99a05fe3ull, 0xa59bc234db398c25ull,
+	0xf6c69a72a3989f5cull, 0xb7dcbf5354e9beceull, 0x88fcf317f22241e2ull,
+	0xcc20ce9bd35c78a5ull, 0x98165af37b2153dfull, 0xe2a0b5dc971f303aull,
+	0xa8d9d1535ce3b396ull, 0xfb9b7cd9a4a7443cull, 0xbb764c4ca7a44410ull,
+	0x8bab8eefb6409c1aull, 0xd01fef10a657842cull, 0x9b10a4e5e9913129ull,
+	0xe7109bfba19c0c9dull, 0xac2820d9623bf429ull, 0x80444b5e7aa7cf85ull,
+	0xbf21e44003acdd2dull, 0x8e679c2f5e44ff8full, 0xd433179d9c8cb841ull,
+	0x9e19db92b4e31ba9ull, 0xeb96bf6ebadf77d9ull, 0xaf87023b9bf0ee6bull,
+};
+
+static const short CachedPowersE[] = {
+	-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+	-901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+	-582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+	-263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+	56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+	375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+	694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+	1013, 1039, 1066,
+};
+
+static const unsigned long long Pow10[] = {
+	1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull,
+	10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull, 100000000000000ull,
+	1000000000000000ull, 10000000000000000ull, 100000000000000000ull, 1000000000000000000ull,
+	10000000000000000000ull
+};
+
+static DiyFp DiyFpFromDouble(double value) {
+	unsigned long long bits;
+	memcpy(&bits, &value, sizeof(double));
+
+	int biased = (int)((bits & DP_EXPONENT_MASK) >> DP_SIGNIFICAND_SIZE);
+	unsigned long long significand = bits & DP_SIGNIFICAND_MASK;
+	DiyFp fp;
+
+	if (biased != 0) {
+		fp.f = significand + DP_HIDDEN_BIT;
+		fp.e = biased - DP_EXPONENT_BIAS;
+	}
+	else {
+		fp.f = significand;
+		fp.e = DP_MIN_EXPONENT + 1;
+	}
+
+	return fp;
+}
+
+static DiyFp DiyFpNormalize(DiyFp fp) {
+	while (!(fp.f & (1ull << 63))) {
+		fp.f <<= 1;
+		fp.e--;
+	}
+
+	return fp;
+}
+
+static void DiyFpBoundaries(DiyFp fp, DiyFp* minus, DiyFp* plus) {
+	DiyFp upper = { (fp.f << 1) + 1, fp.e - 1 };
+	upper = DiyFpNormalize(upper);
+
+	DiyFp lower = fp.f == DP_HIDDEN_BIT
+		? (DiyFp) { (fp.f << 2) - 1, fp.e - 2 }
+		: (DiyFp) { (fp.f << 1) - 1, fp.e - 1 };
+
+	lower.f <<= lower.e - upper.e;
+	lower.e = upper.e;
+
+	*minus = lower;
+	*plus = upper;
+}
+
+static DiyFp DiyFpMultiply(DiyFp x, DiyFp y) {
+	const unsigned long long mask = 0xFFFFFFFFull;
+	unsigned long long a = x.f >> 32, b = x.f & mask;
+	unsigned long long c = y.f >> 32, d = y.f & mask;
+	unsigned long long ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+	unsigned long long middle = (bd >> 32) + (ad & mask) + (bc & mask) + (1ull << 31);
+
+	DiyFp product = { ac + (ad >> 32) + (bc >> 32) + (middle >> 32), x.e + y.e + 64 };
+	return product;
+}
+
+static DiyFp CachedPower(int e, int* k) {
+	double dk = (-61 - e) * 0.30102999566398114 + 347;
+	int power = (int)dk;
+
+	if (dk - power > 0.0) {
+		power++;
+	}
+
+	int index = (power >> 3) + 1;
+	*k = -(CACHED_POWER_MIN_EXPONENT + index * CACHED_POWER_STEP);
+
+	DiyFp cached = { CachedPowersF[index], CachedPowersE[index] };
+	return cached;
+}
+
+static void GrisuRound(char* digits, int length, unsigned long long delta, unsigned long long rest,
+	unsigned long long tenKappa, unsigned long long distance) {
+	while (rest < distance && delta - rest >= tenKappa &&
+		(rest + tenKappa < distance || distance - rest > rest + tenKappa - distance)) {
+		digits[length - 1]--;
+		rest += tenKappa;
+	}
+}
+
+static void DigitGen(DiyFp w, DiyFp upper, unsigned long long delta, char* digits, int* length, int* k) {
+	DiyFp one = { 1ull << -upper.e, upper.e };
+	unsigned long long distance = upper.f - w.f;
+	unsigned int integral = (unsigned int)(upper.f >> -one.e);
+	unsigned long long fraction = upper.f & (one.f - 1);
+	int kappa = 1;
+
+	while (kappa < 10 && integral >= Pow10[kappa]) {
+		kappa++;
+	}
+
+	*length = 0;
+
+	while (kappa > 0) {
+		unsigned int digit = (unsigned int)(integral / Pow10[kappa - 1]);
+		integral %= Pow10[kappa - 1];
+
+		if (digit || *length) {
+			digits[(*length)++] = (char)('0' + digit);
+		}
+
+		kappa--;
+		unsigned long long rest = ((unsigned long long)integral << -one.e) + fraction;
+
+		if (rest <= delta) {
+			*k += kappa;
+			GrisuRound(digits, *length, delta, rest, Pow10[kappa] << -one.e, distance);
+			return;
+		}
+	}
+
+	for (;;) {
+		fraction *= 10;
+		delta *= 10;
+
+		char digit = (char)(fraction >> -one.e);
+
+		if (digit || *length) {
+			digits[(*length)++] = (char)('0' + digit);
+		}
+
+		fraction &= one.f - 1;
+		kappa--;
+
+		if (fraction < delta) {
+			*k += kappa;
+			GrisuRound(digits, *length, delta, fraction, one.f, -kappa < 20 ? distance * Pow10[-kappa] : 0);
+			return;
+		}
+	}
+}
+
+static void Grisu2(double value, char* digits, int* length, int* k) {
+	DiyFp fp = DiyFpFromDouble(value);
+	DiyFp minus, plus;
+	DiyFpBoundaries(fp, &minus, &plus);
+
+	DiyFp cached = CachedPower(plus.e, k);
+	DiyFp w = DiyFpMultiply(DiyFpNormalize(fp), cached);
+	DiyFp upper = DiyFpMultiply(plus, cached);
+	DiyFp lower = DiyFpMultiply(minus, cached);
+
+	lower.f++;
+	upper.f--;
+	DigitGen(w, upper, upper.f - lower.f, digits, length, k);
+}
+
+static ullong WriteFixed(char* buffer, int negative, const char* digits, int length, int k) {
+	int point = length + k;
+	ullong index = 0;
+
+	if (negative) {
+		buffer[index++] = '-';
+	}
+
+	if (point <= 0) {
+		buffer[index++] = '0';
+		buffer[index++] = '.';
+		memset(buffer + index, '0', -point);
+		index += -point;
+		memcpy(buffer + index, digits, length);
+		index += length;
+	}
+	else if (point < length) {
+		memcpy(buffer + index, digits, point);
+		index += point;
+		buffer[index++] = '.';
+		memcpy(buffer + index, digits + point, length - point);
+		index += length - point;
+	}
+	else {
+		memcpy(buffer + index, digits, length);
+		index += length;
+		memset(buffer + index, '0', point - length);
+		index += point - length;
+		buffer[index++] = '.';
+		buffer[index++] = '0';
+	}
+
+	return index;
+}
+
+ullong DoubleToString(char* buffer, double flt) {
+	if (isnan(flt) || isinf(flt)) {
+		memcpy(buffer, "null", 4);
+		return 4;
+	}
+
+	if (flt == 0.0) {
+		return WriteFixed(buffer, signbit(flt) != 0, "0", 1, 0);
+	}
+
+	char digits[32];
+	int length, k;
+	Grisu2(fabs(flt), digits, &length, &k);
+
+	return WriteFixed(buffer, flt < 0, digits, length, k);
+}
+
+static void SplitScientific(char* digits, int* length, int* k) {
+	char* exponent = strchr(digits, 'e');
+	*k = atoi(exponent + 1);
+	*length = 0;
+
+	for (char* chr = digits; chr < exponent; chr++) {
+		if (*chr != '.') {
+			digits[(*length)++] = *chr;
+		}
+	}
+
+	while (*length > 1 && digits[*length - 1] == '0') {
+		(*length)--;
+	}
+
+	*k -= *length - 1;
+}
+
+static int ReadsBackAs(char* digits, int length, int k, ldouble value) {
+	if (length > LDOUBLE_EXACT_DIGITS || k < -LDOUBLE_EXACT_POW10 || k > LDOUBLE_EXACT_POW10) {
+		sprintf_s(digits + length, 40 - length, "e%d", k);
+		return strtold(digits, NULL) == value;
+	}
+
+	unsigned long long integer = 0;
+
+	for (int i = 0; i < length; i++) {
+		integer = integer * 10 + (digits[i] - '0');
+	}
+
+	int exponent = k < 0 ? -k : k;
+	ldouble power = exponent < 20
+		? (ldouble)Pow10[exponent]
+		: (ldouble)Pow10[19] * (ldouble)Pow10[exponent - 19];
+
+	return (k < 0 ? (ldouble)integer / power : (ldouble)integer * power) == value;
+}
+
+static int ReadsBackShorter(char* digits, int* length, int* k, ldouble value) {
+	char shorter[40];
+	int count = *length - 1;
+
+	if (count < 1) {
+		return FALSE;
+	}
+
+	memcpy(shorter, digits, count);
+
+	for (int up = 0; up < 2; up++) {
+		int size = count;
+		int exponent = *k + 1;
+
+		if (up) {
+			int i = count - 1;
+
+			while (i >= 0 && shorter[i] == '9') {
+				shorter[i--] = '0';
+			}
+
+			if (i < 0) {
+				shorter[0] = '1';
+				size = 1;
+				exponent += count;
+			}
+			else {
+				shorter[i]++;
+			}
+		}
+
+		while (size > 1 && shorter[size - 1] == '0') {
+			size--;
+			exponent++;
+		}
+
+		if (ReadsBackAs(shorter, size, exponent, value)) {
+			memcpy(digits, shorter, size);
+			*length = size;
+			*k = exponent;
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+ullong LDoubleToString(char* buffer, ldouble flt) {
+	if (isnan(flt) || isinf(flt)) {
+		memcpy(buffer, "null", 4);
+		return 4;
+	}
+
+	if (flt == 0.0L) {
+		return WriteFixed(buffer, signbit(flt) != 0, "0", 1, 0);
+	}
+
+	ldouble magnitude = fabsl(flt);
+	double nearest = (double)magnitude;
+	char digits[40];
+	int length, k;
+
+	if (nearest > 0.0 && !isinf(nearest)) {
+		Grisu2(nearest, digits, &length, &k);
+
+		if (ReadsBackAs(digits, length, k, magnitude) || ReadsBackShorter(digits, &length, &k, magnitude)) {
+			return WriteFixed(buffer, flt < 0, digits, length, k);
+		}
+	}
+
+	for (int precision = DOUBLE_ROUND_TRIP_DIGITS; ; precision = LDOUBLE_ROUND_TRIP_DIGITS) {
+		sprintf_s(digits, sizeof(digits), "%.*Le", precision - 1, magnitude);
+		SplitScientific(digits, &length, &k);
+
+		if (precision == LDOUBLE_ROUND_TRIP_DIGITS || ReadsBackAs(digits, length, k, magnitude)) {
+			return WriteFixed(buffer, flt < 0, digits, length, k);
+		}
+	}
+}
+
+/*
+	Converting Floats To Canonical Strings
+
+	MACROS:
+
+	> ECMASCRIPT_FIXED_LIMIT
+	Doubles below 10^ECMASCRIPT_FIXED_LIMIT are written in fixed notation, bigger ones with an exponent
+
+	> ECMASCRIPT_FIXED_ZEROS
+	Most zeros written between the decimal point and the first digit before an exponent is used instead
+
+	FUNCTIONS:
+
+	> ReadsBackAsDouble()
+	Checks whether digits * 10^k read back as the given double using strtod()
+
+	> IncrementDigits()
+	Adds one to the last of 'length' digits, carrying into the digits before it. Returns FALSE if every digit was a
+	nine, which would need one digit more
+
+	> ShortestDigits()
+	Finds the digits ECMAScript picks for a double: the fewest digits which read back as the double and, of those,
+	the ones closest to it. Tries DBL_DIG, DBL_DIG + 1 and DOUBLE_ROUND_TRIP_DIGITS significant digits rounded
+	correctly by printf()
+
+	> WriteECMAScript()
+	Writes digits and a decimal exponent the way ECMAScript's Number.prototype.toString() does (e.g., 1, 0.5,
+	1e+21, 1.5e-7)
+
+	> DoubleToCanonicalString()
+	Writes a double in the form RFC 8785 (JSON Canonicalization Scheme) requires to a buffer of at least
+	CANONICAL_STRING_SIZE chars and returns how many chars were written. The buffer is not null terminated
+
+	NOTES:
+
+	Any decimal of DBL_DIG significant digits or less reads back as a different double than every other decimal of
+	that many digits, so when Grisu2 gives DBL_DIG digits or less they are the only ones of that length which read
+	back as the double, and there can be no shorter ones (they would be the same digits with zeros after them). Only
+	longer digits have to be checked with ShortestDigits(), which is where Grisu2 is sometimes one digit too long
+
+	The digits closest to a double read back as it whenever any digits of the same length do, except for a power of
+	two, which is twice as far from the double below it as from the double above it. There the closest digits can
+	fall below the double while digits one step up still read back as it, so those are tried as well
+
+	Negative zero is written as 0. Not a number and infinity have no canonical form, they are written as null like
+	JSON.stringify() does
+*/
+
+#define ECMASCRIPT_FIXED_LIMIT 21
+#define ECMASCRIPT_FIXED_ZEROS 6
+
+static int ReadsBackAsDouble(char* digits, int length, int k, double value) {
+	char number[48];
+	memcpy(number, digits, length);
+	sprintf_s(number + length, sizeof(number) - length, "e%d", k);
+
+	return strtod(number, NULL) == value;
+}
+
+static int IncrementDigits(char* digits, int length) {
+	for (int i = length - 1; i >= 0; i--) {
+		if (digits[i] != '9') {
+			digits[i]++;
+			return TRUE;
+		}
+
+		digits[i] = '0';
+	}
+
+	return FALSE;
+}
+
+static void ShortestDigits(double value, char* digits, int* length, int* k) {
+	for (int precision = DBL_DIG; precision < DOUBLE_ROUND_TRIP_DIGITS; precision++) {
+		char candidate[48];
+		int candidateLength, candidateK;
+
+		sprintf_s(candidate, sizeof(candidate), "%.*e", precision - 1, value);
+		SplitScientific(candidate, &candidateLength, &candidateK);
+
+		if (!ReadsBackAsDouble(candidate, candidateLength, candidateK, value)) {
+			// Only a power of two can be read back by digits one step further from it (see NOTES)
+
+			int padded = precision - candidateLength;
+			memset(candidate + candidateLength, '0', padded);
+
+			if (!IncrementDigits(candidate, precision)) {
+				continue;
+			}
+
+			candidateLength = precision;
+			candidateK -= padded;
+
+			if (!ReadsBackAsDouble(candidate, candidateLength, candidateK, value)) {
+				continue;
+			}
+
+			while (candidateLength > 1 && candidate[candidateLength - 1] == '0') {
+				candidateLength--;
+				candidateK++;
+			}
+		}
+
+		memcpy(digits, candidate, candidateLength);
+		*length = candidateLength;
+		*k = candidateK;
+
+		return;
+	}
+
+	sprintf_s(digits, 48, "%.*e", DOUBLE_ROUND_TRIP_DIGITS - 1, value);
+	SplitScientific(digits, length, k);
+}
+
+static ullong WriteECMAScript(char* buffer, int negative, const char* digits, int length, int k) {
+	int point = length + k;
+	ullong index = 0;
+
+	if (negative) {
+		buffer[index++] = '-';
+	}
+
+	if (point >= length && point <= ECMASCRIPT_FIXED_LIMIT) {
+		memcpy(buffer + index, digits, length);
+		index += length;
+		memset(buffer + index, '0', point - length);
+		index += point - length;
+	}
+	else if (point > 0 && point <= ECMASCRIPT_FIXED_LIMIT) {
+		memcpy(buffer + index, digits, point);
+		index += point;
+		buffer[index++] = '.';
+		memcpy(buffer + index, digits + point, length - point);
+		index += length - point;
+	}
+	else if (point > -ECMASCRIPT_FIXED_ZEROS && point <= 0) {
+		buffer[index++] = '0';
+		buffer[index++] = '.';
+		memset(buffer + index, '0', -point);
+		index += -point;
+		memcpy(buffer + index, digits, length);
+		index += length;
+	}
+	else {
+		buffer[index++] = digits[0];
+
+		if (length > 1) {
+			buffer[index++] = '.';
+			memcpy(buffer + index, digits + 1, length - 1);
+			index += length - 1;
+		}
+
+		index += sprintf_s(buffer + index, CANONICAL_STRING_SIZE - index, "e%+d", point - 1);
+	}
+
+	return index;
+}
+
+ullong DoubleToCanonicalString(char* buffer, double flt) {
+	if (isnan(flt) || isinf(flt)) {
+		memcpy(buffer, "null", 4);
+		return 4;
+	}
+
+	if (flt == 0.0) {
+		buffer[0] = '0';
+		return 1;
+	}
+
+	char digits[48];
+	int length, k;
+	Grisu2(fabs(flt), digits, &length, &k);
+
+	while (length > 1 && digits[length - 1] == '0') {
+		length--;
+		k++;
+	}
+
+	if (length > DBL_DIG) {
+		ShortestDigits(fabs(flt), digits, &length, &k);
+	}
+
+	return WriteECMAScript(buffer, flt < 0, digits, length, k);
+}
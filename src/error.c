@@ -1,20 +1,20 @@
-
-#include <stdlib.h>
-#include "include/error.h"
-
-/*
-	Initializing Data
-
-	FUNCTIONS:
-
-	> ErrorInit()
-	Initialize an Error object
-*/
-
-Error* ErrorInit() {
-	Error* error = calloc(1, sizeof(Error));
-	error->DebugStr = NULL;
-	error->Exists = FALSE;
-
-	return error;
-}
+
+#include <stdlib.h>
+#include "include/error.h"
+
+/*
+	Initializing Data
+
+	FUNCTIONS:
+
+	> ErrorInit()
+	Initialize an Error object
+*/
+
+Error* ErrorInit() {
+	Error* error = JsonCalloc(1, sizeof(Error));
+	error->DebugStr = NULL;
+	error->Exists = FALSE;
+
+	return error;
+}
@@ -1,68 +1,235 @@
-
-#define _CRT_SECURE_NO_WARNINGS
-
-#include <stdio.h>
-#include <stdlib.h>
-#include "include/file-io.h"
-
-/*
-	Reading From File
-
-	FUNCTIONS:
-
-	> FileReadAllText()
-	Reads all of the text contents of a file into a string
-	Error will be raised if the file failed to read
-	
-	WARNING:
-
-	Attempting to access a string generated by FileReadAllText() when the function returned an error may result
-	in a runtime error. This function should be checked when it is called for errors. 
-*/
-
-Error* FileReadAllText(const char* path, const char** text) {
-	FILE* file = fopen(path, "rb");
-
-	if (file == NULL) {
-		CREATE_ERROR(ERR_ACCESS_PATH_FAILURE, path);
-		return error;
-	}
-
-	fseek(file, 0, SEEK_END);
-	long size = ftell(file);
-	fseek(file, 0, SEEK_SET);
-
-	char* _text = malloc(size + 1);
-	fread(_text, size, 1, file);
-	fclose(file);
-
-	_text[size] = '\0';
-	*text = _text;
-	return NO_ERROR;
-}
-
-/*
-	Writing To File
-
-	FUNCTIONS:
-
-	> FileWriteAllText()
-	Writes an entire string to a file
-	Error will be raised if the file failed to write
-*/
-
-Error* FileWriteAllText(const char* path, const char* text) {
-	FILE* file = fopen(path, "w");
-
-	if (file == NULL) {
-		CREATE_ERROR(ERR_ACCESS_PATH_FAILURE, path);
-		return error;
-	}
-
-	if (file != NULL) {
-		fputs(text, file);
-		fclose(file);
-	}
-
-	return NO_ERROR;
-}
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include "include/file-io.h"
+
+#ifdef _MSC_VER
+#include <io.h>
+#define write(fd, buffer, length) _write(fd, buffer, (unsigned int)(length))
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/uio.h>
+#endif
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+/*
+	Reading From File
+
+	FUNCTIONS:
+
+	> FileReadAllText()
+	Reads all of the text contents of a file into a string
+	Error will be raised if the file failed to read
+	
+	WARNING:
+
+	Attempting to access a string generated by FileReadAllText() when the function returned an error may result
+	in a runtime error. This function should be checked when it is called for errors. 
+*/
+
+Error* FileReadAllText(const char* path, const char** text) {
+	FILE* file = fopen(path, "rb");
+
+	if (file == NULL) {
+		CREATE_ERROR(ERR_ACCESS_PATH_FAILURE, path);
+		return error;
+	}
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	char* _text = JsonMalloc(size + 1);
+	fread(_text, size, 1, file);
+	fclose(file);
+
+	_text[size] = '\0';
+	*text = _text;
+	return NO_ERROR;
+}
+
+/*
+	Writing To File
+
+	FUNCTIONS:
+
+	> FileWriteAllText()
+	Writes an entire string to a file
+	Error will be raised if the file failed to write
+*/
+
+Error* FileWriteAllText(const char* path, const char* text) {
+	FILE* file = fopen(path, "w");
+
+	if (file == NULL) {
+		CREATE_ERROR(ERR_ACCESS_PATH_FAILURE, path);
+		return error;
+	}
+
+	if (file != NULL) {
+		fputs(text, file);
+		fclose(file);
+	}
+
+	return NO_ERROR;
+}
+
+/*
+	Writing Streams
+
+	MACROS:
+
+	> FileDescriptorData()
+	Packs a file descriptor into the void* passed to a sink, FileDescriptorFromData() unpacks it again
+
+	> FILE_SINK_CHUNK
+	Most bytes FdWriteSink() passes to write() at once (_write() takes an unsigned int length)
+
+	FUNCTIONS:
+
+	> FileWriteSink()
+	Writes chars to a FILE* (passed as 'file'). Used as a StringBuilderSink
+	Returns FAILURE if the chars could not all be written
+
+	> FdWriteSink()
+	Writes chars to a file descriptor (passed as 'fd' with FileDescriptorData()). Used as a StringBuilderSink. Keeps
+	writing after partial writes and interrupted calls
+	Returns FAILURE if the chars could not all be written
+*/
+
+#define FILE_SINK_CHUNK (1ull << 30)
+
+int FileWriteSink(void* file, const char* buffer, ullong length) {
+	return fwrite(buffer, 1, length, (FILE*)file) == length ? SUCCESS : FAILURE;
+}
+
+int FdWriteSink(void* fd, const char* buffer, ullong length) {
+	while (length > 0) {
+		ullong chunk = length < FILE_SINK_CHUNK ? length : FILE_SINK_CHUNK;
+		long long written = write(FileDescriptorFromData(fd), buffer, chunk);
+
+		if (written < 0 && errno == EINTR) {
+			continue;
+		}
+
+		if (written <= 0) {
+			return FAILURE;
+		}
+
+		buffer += written;
+		length -= written;
+	}
+
+	return SUCCESS;
+}
+
+/*
+	Writing Buffers To File
+
+	FUNCTIONS:
+
+	> FdWriteVector()
+	Writes 'count' buffers to a file descriptor one after another using writev(), IOV_MAX buffers per call. Keeps
+	writing after partial writes and interrupted calls
+	Returns FAILURE if the buffers could not all be written
+
+	> FileWriteVector()
+	Writes 'count' buffers to a file one after another, without joining them into one buffer first
+	Error will be raised if the file failed to write
+
+	NOTES:
+
+	Where writev() does not exist (MSVC) the buffers are written with one fwrite() each
+*/
+
+#ifndef _MSC_VER
+static int FdWriteVector(int fd, const char** buffers, const ullong* lengths, ullong count) {
+	struct iovec vectors[IOV_MAX];
+	ullong index = 0;
+	ullong offset = 0;
+
+	while (index < count) {
+		int used = 0;
+
+		for (ullong i = index; i < count && used < IOV_MAX; i++) {
+			ullong skip = i == index ? offset : 0;
+
+			if (lengths[i] > skip) {
+				vectors[used].iov_base = (void*)(buffers[i] + skip);
+				vectors[used].iov_len = lengths[i] - skip;
+				used++;
+			}
+		}
+
+		if (used == 0) {
+			return SUCCESS;
+		}
+
+		long long written = writev(fd, vectors, used);
+
+		if (written < 0 && errno == EINTR) {
+			continue;
+		}
+
+		if (written <= 0) {
+			return FAILURE;
+		}
+
+		while (index < count && (ullong)written >= lengths[index] - offset) {
+			written -= lengths[index] - offset;
+			offset = 0;
+			index++;
+		}
+
+		offset += written;
+	}
+
+	return SUCCESS;
+}
+#endif
+
+Error* FileWriteVector(const char* path, const char** buffers, const ullong* lengths, ullong count) {
+#ifdef _MSC_VER
+	FILE* file = fopen(path, "wb");
+
+	if (file == NULL) {
+		CREATE_ERROR(ERR_ACCESS_PATH_FAILURE, path);
+		return error;
+	}
+
+	int result = SUCCESS;
+
+	for (ullong i = 0; i < count && result == SUCCESS; i++) {
+		result = FileWriteSink(file, buffers[i], lengths[i]);
+	}
+
+	if (fclose(file) != 0 || result == FAILURE) {
+		CREATE_ERROR(ERR_ACCESS_PATH_FAILURE, path);
+		return error;
+	}
+#else
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+
+	if (fd < 0) {
+		CREATE_ERROR(ERR_ACCESS_PATH_FAILURE, path);
+		return error;
+	}
+
+	int result = FdWriteVector(fd, buffers, lengths, count);
+
+	if (close(fd) != 0 || result == FAILURE) {
+		CREATE_ERROR(ERR_ACCESS_PATH_FAILURE, path);
+		return error;
+	}
+#endif
+
+	return NO_ERROR;
+}
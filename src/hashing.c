@@ -0,0 +1,184 @@
+#include <string.h>
+#include "include/hashing.h"
+
+#define SUCCESS 1
+#define FAILURE 0
+
+/*
+	Hasher
+
+	MACROS:
+
+	> HASH_PRIME1, HASH_PRIME2, HASH_PRIME3, HASH_PRIME4, HASH_PRIME5
+	The primes XXH64 mixes its input with
+
+	> RotateLeft()
+	Rotates a 64 bit integer left by 'bits' bits
+
+	FUNCTIONS:
+
+	> ReadLE32(), ReadLE64()
+	Reads 4 or 8 bytes as a little endian integer, whatever the byte order and alignment of the machine. Compilers
+	turn the shifts into a single load where the machine is little endian
+
+	> HashRound()
+	Mixes 8 bytes of input into one of the four lanes
+
+	> HashMerge()
+	Mixes a lane into the combined hash once the input has ended
+
+	> HasherInit()
+	Initialize a Hasher object with a seed
+
+	> HasherUpdate()
+	Feeds 'length' chars into a Hasher. Chars are consumed 32 at a time (8 into each lane), anything left over is
+	kept in the Hasher's buffer until more chars arrive or the hash is taken
+
+	> HasherDigest()
+	Returns the hash of every char fed into a Hasher so far. The Hasher is left as it was, so more chars can be fed
+	in afterwards
+
+	> HasherSink()
+	Feeds chars into a Hasher (passed as 'hasher'). Used as a StringBuilderSink, so anything which can be written
+	to a StringBuilder can be hashed without being held in memory (see JsonCanonicalHash()). Never fails
+
+	NOTES:
+
+	The hash is XXH64, so hashes match those of any other XXH64 implementation for the same chars and seed no matter
+	how the chars were split up between calls to HasherUpdate(). It is not a cryptographic hash
+*/
+
+#define HASH_PRIME1 0x9E3779B185EBCA87ULL
+#define HASH_PRIME2 0xC2B2AE3D27D4EB4FULL
+#define HASH_PRIME3 0x165667B19E3779F9ULL
+#define HASH_PRIME4 0x85EBCA77C2B2AE63ULL
+#define HASH_PRIME5 0x27D4EB2F165667C5ULL
+
+#define RotateLeft(value, bits) (((value) << (bits)) | ((value) >> (64 - (bits))))
+
+static ullong ReadLE32(const unsigned char* bytes) {
+	return (ullong)bytes[0] | ((ullong)bytes[1] << 8) | ((ullong)bytes[2] << 16) | ((ullong)bytes[3] << 24);
+}
+
+static ullong ReadLE64(const unsigned char* bytes) {
+	return ReadLE32(bytes) | (ReadLE32(bytes + 4) << 32);
+}
+
+static ullong HashRound(ullong lane, ullong input) {
+	lane += input * HASH_PRIME2;
+	lane = RotateLeft(lane, 31);
+	return lane * HASH_PRIME1;
+}
+
+static ullong HashMerge(ullong hash, ullong lane) {
+	hash ^= HashRound(0, lane);
+	return hash * HASH_PRIME1 + HASH_PRIME4;
+}
+
+Hasher* HasherInit(ullong seed) {
+	Hasher* hasher = JsonMalloc(sizeof(Hasher));
+	hasher->Lanes[0] = seed + HASH_PRIME1 + HASH_PRIME2;
+	hasher->Lanes[1] = seed + HASH_PRIME2;
+	hasher->Lanes[2] = seed;
+	hasher->Lanes[3] = seed - HASH_PRIME1;
+	hasher->Total = 0;
+	hasher->Seed = seed;
+	hasher->Buffered = 0;
+
+	return hasher;
+}
+
+void HasherUpdate(Hasher* hasher, const char* data, ullong length) {
+	const unsigned char* bytes = (const unsigned char*)data;
+	const unsigned char* end = bytes + length;
+	hasher->Total += length;
+
+	if (hasher->Buffered + length < sizeof(hasher->Buffer)) {
+		memcpy(hasher->Buffer + hasher->Buffered, bytes, length);
+		hasher->Buffered += length;
+		return;
+	}
+
+	if (hasher->Buffered > 0) {
+		ullong fill = sizeof(hasher->Buffer) - hasher->Buffered;
+		memcpy(hasher->Buffer + hasher->Buffered, bytes, fill);
+		bytes += fill;
+
+		for (int i = 0; i < 4; i++) {
+			hasher->Lanes[i] = HashRound(hasher->Lanes[i], ReadLE64(hasher->Buffer + i * 8));
+		}
+
+		hasher->Buffered = 0;
+	}
+
+	ullong lane0 = hasher->Lanes[0];
+	ullong lane1 = hasher->Lanes[1];
+	ullong lane2 = hasher->Lanes[2];
+	ullong lane3 = hasher->Lanes[3];
+
+	while (end - bytes >= 32) {
+		lane0 = HashRound(lane0, ReadLE64(bytes));
+		lane1 = HashRound(lane1, ReadLE64(bytes + 8));
+		lane2 = HashRound(lane2, ReadLE64(bytes + 16));
+		lane3 = HashRound(lane3, ReadLE64(bytes + 24));
+		bytes += 32;
+	}
+
+	hasher->Lanes[0] = lane0;
+	hasher->Lanes[1] = lane1;
+	hasher->Lanes[2] = lane2;
+	hasher->Lanes[3] = lane3;
+
+	hasher->Buffered = (ullong)(end - bytes);
+	memcpy(hasher->Buffer, bytes, hasher->Buffered);
+}
+
+ullong HasherDigest(Hasher* hasher) {
+	ullong hash;
+
+	if (hasher->Total >= 32) {
+		const ullong* lanes = hasher->Lanes;
+		hash = RotateLeft(lanes[0], 1) + RotateLeft(lanes[1], 7) + RotateLeft(lanes[2], 12) + RotateLeft(lanes[3], 18);
+
+		for (int i = 0; i < 4; i++) {
+			hash = HashMerge(hash, lanes[i]);
+		}
+	}
+	else {
+		hash = hasher->Seed + HASH_PRIME5;
+	}
+
+	hash += hasher->Total;
+
+	const unsigned char* bytes = hasher->Buffer;
+	const unsigned char* end = bytes + hasher->Buffered;
+
+	for (; end - bytes >= 8; bytes += 8) {
+		hash ^= HashRound(0, ReadLE64(bytes));
+		hash = RotateLeft(hash, 27) * HASH_PRIME1 + HASH_PRIME4;
+	}
+
+	if (end - bytes >= 4) {
+		hash ^= ReadLE32(bytes) * HASH_PRIME1;
+		hash = RotateLeft(hash, 23) * HASH_PRIME2 + HASH_PRIME3;
+		bytes += 4;
+	}
+
+	for (; bytes < end; bytes++) {
+		hash ^= *bytes * HASH_PRIME5;
+		hash = RotateLeft(hash, 11) * HASH_PRIME1;
+	}
+
+	hash ^= hash >> 33;
+	hash *= HASH_PRIME2;
+	hash ^= hash >> 29;
+	hash *= HASH_PRIME3;
+	hash ^= hash >> 32;
+
+	return hash;
+}
+
+int HasherSink(void* hasher, const char* buffer, ullong length) {
+	HasherUpdate((Hasher*)hasher, buffer, length);
+	return SUCCESS;
+}
@@ -0,0 +1,152 @@
+
+/*
+	> allocator.h
+	Header file for defining the allocator interface which every allocation made by the library goes through
+	Documentation about the below functions can be found in allocator.c
+*/
+
+#pragma once
+
+#include "types.h"
+
+/*
+	Thread Local Storage
+
+	MACROS:
+
+	> JSON_THREAD_LOCAL
+	Storage class for variables which have one copy per thread
+*/
+
+#ifdef _MSC_VER
+#define JSON_THREAD_LOCAL __declspec(thread)
+#else
+#define JSON_THREAD_LOCAL _Thread_local
+#endif
+
+/*
+	Atomics
+
+	MACROS:
+
+	> JSON_ATOMIC
+	Qualifier for counters which several threads update at once (see JsonRegion.Live)
+*/
+
+#ifdef _MSC_VER
+#define JSON_ATOMIC volatile
+#else
+#define JSON_ATOMIC _Atomic
+#endif
+
+/*
+	Json Allocator
+
+	FIELDS:
+
+	> Alloc
+	Allocates 'size' bytes, the memory does not have to be zeroed
+
+	> Realloc
+	Resizes a block returned by Alloc or Realloc to 'size' bytes, keeping its contents. 'ptr' may be NULL
+
+	> Free
+	Frees a block returned by Alloc or Realloc. 'ptr' may be NULL
+
+	> User
+	Pointer which is passed back to every function above (e.g., an arena, pool or accounting struct)
+*/
+
+typedef struct {
+	void* (*Alloc)(void* user, ullong size);
+	void* (*Realloc)(void* user, void* ptr, ullong size);
+	void (*Free)(void* user, void* ptr);
+	void* User;
+} JsonAllocator;
+
+/*
+	Selecting Allocators
+
+	MACROS:
+
+	> JSON_WITH_ALLOCATOR()
+	Runs the block after it with 'allocator' selected (see JsonSelectAllocator()) and selects the previous allocator
+	again once the block is done. Leaving the block with return, break or goto skips the restore
+*/
+
+#define JSON_WITH_ALLOCATOR(allocator)																\
+	for (JsonAllocator* json_previous = JsonSelectAllocator(allocator), **json_done = NULL;		\
+		json_done == NULL; json_done = &json_previous, JsonSelectAllocator(json_previous))
+
+JsonAllocator* JsonUseAllocator(JsonAllocator* allocator);
+JsonAllocator* JsonSelectAllocator(JsonAllocator* allocator);
+JsonAllocator* JsonGetAllocator();
+
+/*
+	Allocating Memory
+*/
+
+void* JsonMalloc(ullong size);
+void* JsonCalloc(ullong count, ullong size);
+void* JsonRealloc(void* ptr, ullong size);
+void JsonFree(void* ptr);
+
+/*
+	Node Pools
+*/
+
+void* JsonPoolAlloc(ullong size);
+void* JsonPoolCalloc(ullong size);
+void JsonPoolFree(void* ptr, ullong size);
+void JsonPoolTrim();
+
+/*
+	Json Region
+
+	MACROS:
+
+	> JSON_REGION_ALIGNMENT
+	Alignment of every block handed out by a JsonRegion
+
+	> JsonRegionSize()
+	Gets the number of bytes a block of 'size' bytes takes up in a JsonRegion
+
+	FIELDS:
+
+	> Buffer, Length, Capacity
+	The memory blocks are carved out of, the number of bytes handed out and the number of bytes it holds
+
+	> Live
+	Number of blocks which have not been freed and JsonLists or JsonExprs which use the region's allocator, plus
+	one until JsonRegionRelease() is called
+
+	> Parent
+	The allocator the region was allocated with and is freed with. Memory the region does not hold is passed on to it
+
+	> Interface
+	The region's own allocator. Documents which were compacted into the region use it (see JsonCompact()), so that
+	their blocks are given back to the region and everything else goes to Parent
+*/
+
+#define JSON_REGION_ALIGNMENT 8
+#define JsonRegionSize(size) (((size) + JSON_REGION_ALIGNMENT - 1) & ~(ullong)(JSON_REGION_ALIGNMENT - 1))
+
+typedef struct JsonRegion_t {
+	char* Buffer;
+	ullong Length;
+	ullong Capacity;
+	JSON_ATOMIC ullong Live;
+	JsonAllocator* Parent;
+	JsonAllocator Interface;
+} JsonRegion;
+
+/*
+	Regions
+*/
+
+JsonRegion* JsonRegionInit(ullong capacity);
+void* JsonRegionAlloc(JsonRegion* region, ullong size);
+void JsonRegionRelease(JsonRegion* region);
+JsonAllocator* JsonAllocatorRetain(JsonAllocator* allocator);
+void JsonAllocatorRelease(JsonAllocator* allocator);
+JsonAllocator* JsonAllocatorOwner(JsonAllocator* allocator, const void* ptr);
@@ -0,0 +1,17 @@
+
+/*
+	> arrow.h
+	Header file for defining functions which write JsonColumns as an Apache Arrow IPC file (Feather v2)
+	Documentation about the below functions can be found in arrow.c
+*/
+
+#pragma once
+
+#include "columns.h"
+#include "error.h"
+
+/*
+	Writing Arrow Files
+*/
+
+Error* ArrowWriteFile(JsonColumns* columns, const char* path);
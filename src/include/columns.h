@@ -0,0 +1,115 @@
+
+/*
+	> columns.h
+	Header file for defining typed columns (struct of arrays) extracted from lists of JsonExprs and functions which
+	interact with them
+	Documentation about the below functions can be found in columns.c
+*/
+
+#pragma once
+
+#include "json-types.h"
+#include "error.h"
+
+/*
+	Column Types
+
+	MACROS:
+
+	> JSON_COLUMN_NULL
+	No row of the column has held a value yet, the column has no values buffer
+
+	> JSON_COLUMN_INT
+	Values is a JsonInt array with one element per row
+
+	> JSON_COLUMN_FLOAT
+	Values is a double array with one element per row
+
+	> JSON_COLUMN_BOOL
+	Values is a bitmap with one bit per row (least significant bit first), set for true
+
+	> JSON_COLUMN_STRING
+	Values is an llong array of Length + 1 offsets into Data. Row i is the bytes between offset i and i + 1
+*/
+
+#define JSON_COLUMN_NULL 0
+#define JSON_COLUMN_INT 1
+#define JSON_COLUMN_FLOAT 2
+#define JSON_COLUMN_BOOL 3
+#define JSON_COLUMN_STRING 4
+
+/*
+	Json Column
+
+	FIELDS:
+
+	> Key
+	The key the column was extracted from, owned by the column
+
+	> Type
+	One of the JSON_COLUMN types above, decided by the first row which holds a value
+
+	> Length, Capacity
+	Number of rows in the column and number of rows its buffers can hold
+
+	> NullCount
+	Number of rows which do not hold a value
+
+	> Validity
+	Bitmap with one bit per row (least significant bit first), set when the row holds a value
+
+	> Values
+	The values of the column, see the JSON_COLUMN types above. Rows which do not hold a value are zeroed
+
+	> Data, DataLength, DataCapacity
+	Bytes of every string in a JSON_COLUMN_STRING column, back to back and not null terminated
+*/
+
+typedef struct {
+	JsonString Key;
+	int Type;
+	ullong Length;
+	ullong Capacity;
+	ullong NullCount;
+	unsigned char* Validity;
+	void* Values;
+	char* Data;
+	ullong DataLength;
+	ullong DataCapacity;
+} JsonColumn;
+
+/*
+	Json Columns
+
+	FIELDS:
+
+	> Columns, Count
+	One column per extracted key, in the order the keys were given
+
+	> Length
+	Number of rows in every column
+
+	> Allocator
+	The allocator which was selected when the columns were extracted, JsonColumnsDelete() frees them with it
+*/
+
+typedef struct {
+	JsonColumn* Columns;
+	ullong Count;
+	ullong Length;
+	JsonAllocator* Allocator;
+} JsonColumns;
+
+/*
+	Extracting Columns
+*/
+
+JsonColumns* JsonListToColumns(JsonList* list, const char** keys, ullong count);
+JsonColumns* JsonTokensToColumns(TokenArray* tokens, const char** keys, ullong count, Error* error);
+void JsonColumnsDelete(JsonColumns* columns);
+
+/*
+	Reading Columns
+*/
+
+int JsonColumnIsValid(JsonColumn* column, ullong row);
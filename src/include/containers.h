@@ -1,73 +1,145 @@
-
-#pragma once
-
-#include "token.h"
-#include "json-types.h"
-#include "types.h"
-
-/*
-	String Builder
-
-	FUNCTIONS:
-
-	> 
-*/
-
-typedef struct {
-	char* Buffer;
-	ullong Length;
-	ullong Capacity;
-} StringBuilder;
-
-StringBuilder* StringBuilderInit();
-void StringBuilderAppendChar(StringBuilder* builder, char chr);
-void StringBuilderAppendString(StringBuilder* builder, const char* str);
-void StringBuilderAppendLLONG(StringBuilder* builder, llong integer);
-void StringBuilderAppendLDOUBLE(StringBuilder* builder, ldouble flt);
-
-/*
-	Token Array
-*/
-
-#define TokenArrayDelete(arr)					\
-	free(arr->Buffer);							\
-	free(arr);
-
-typedef struct {
-	Token* Buffer;
-	ullong Length;
-	ullong Capacity;
-} TokenArray;
-
-TokenArray* TokenArrayInit();
-void TokenArrayAppend(TokenArray* arr, Token token);
-
-/*
-	JsonValue Array
-*/
-
-typedef struct JsonValueArray_t {
-	struct JsonValue_t* Buffer;
-	ullong Length;
-	ullong Capacity;
-} JsonValueArray;
-
-JsonValueArray* JsonValueArrayInit();
-void JsonValueArrayAppend(JsonValueArray* arr, struct JsonValue_t value);
-void JsonValueArrayRemove(JsonValueArray* arr, ullong index);
-
-/*
-	JsonPair Array
-*/
-
-typedef struct JsonPair_t;
-
-typedef struct JsonPairArray_t {
-	struct JsonPair_t* Buffer;
-	ullong Length;
-	ullong Capacity;
-} JsonPairArray;
-
-JsonPairArray* JsonPairArrayInit();
-void JsonPairArrayAppend(JsonPairArray* arr, struct JsonPair_t pair);
-void JsonPairArrayRemove(JsonPairArray* arr, ullong index);
+
+#pragma once
+
+#include "token.h"
+#include "json-types.h"
+#include "types.h"
+#include "allocator.h"
+
+/*
+	String Builder
+
+	FUNCTIONS:
+
+	> 
+*/
+
+#define StringBuilderDelete(builder)			\
+	JsonFree(builder->Buffer);					\
+	JsonFree(builder);
+
+typedef int (*StringBuilderSink)(void* data, const char* buffer, ullong length);
+
+typedef struct {
+	char* Buffer;
+	ullong Length;
+	ullong Capacity;
+	StringBuilderSink Sink;
+	void* SinkData;
+	int Failed;
+} StringBuilder;
+
+StringBuilder* StringBuilderInit();
+StringBuilder* StringBuilderInitSink(StringBuilderSink sink, void* data, ullong capacity);
+int StringBuilderFlush(StringBuilder* builder);
+void StringBuilderGrow(StringBuilder* builder, ullong length);
+void StringBuilderReserve(StringBuilder* builder, ullong capacity);
+void StringBuilderShrinkToFit(StringBuilder* builder);
+char* StringBuilderFinish(StringBuilder* builder);
+void StringBuilderAppendChar(StringBuilder* builder, char chr);
+void StringBuilderAppendString(StringBuilder* builder, const char* str);
+void StringBuilderAppendBytes(StringBuilder* builder, const char* data, ullong length);
+void StringBuilderAppendLLONG(StringBuilder* builder, llong integer);
+void StringBuilderAppendDOUBLE(StringBuilder* builder, double flt);
+void StringBuilderAppendLDOUBLE(StringBuilder* builder, ldouble flt);
+
+/*
+	Token Array
+*/
+
+#define TokenArrayDelete(arr)					\
+	JsonFree(arr->Buffer);							\
+	JsonFree(arr);
+
+typedef struct {
+	Token* Buffer;
+	ullong Length;
+	ullong Capacity;
+} TokenArray;
+
+TokenArray* TokenArrayInit();
+void TokenArrayReserve(TokenArray* arr, ullong capacity);
+void TokenArrayShrinkToFit(TokenArray* arr);
+void TokenArrayAppend(TokenArray* arr, Token token);
+
+/*
+	JsonValue Array
+
+	MACROS:
+
+	> JSON_PACKED_NONE
+	The JsonValueArray stores its elements as JsonValues in Buffer
+
+	> JSON_PACKED_INT
+	The JsonValueArray only holds JsonInts and stores them contiguously as a JsonInt array in Numbers
+
+	> JSON_PACKED_FLOAT
+	The JsonValueArray only holds JsonFloats and stores them contiguously as a JsonFloat array in Numbers
+
+	FIELDS:
+
+	> Allocator
+	The allocator which was selected when the JsonValueArray was created. Everything inside of it is allocated and
+	freed with this allocator, whichever one the calling thread has selected (see JsonSelectAllocator())
+*/
+
+#define JSON_PACKED_NONE 0
+#define JSON_PACKED_INT 1
+#define JSON_PACKED_FLOAT 2
+
+typedef struct JsonValueArray_t {
+	struct JsonValue_t* Buffer;
+	ullong Length;
+	ullong Capacity;
+	ullong* RefCount;
+	int Packing;
+	void* Numbers;
+	JsonAllocator* Allocator;
+} JsonValueArray;
+
+typedef int (*JsonValuePredicate)(struct JsonValue_t* value, void* data);
+
+JsonValueArray* JsonValueArrayInit();
+void JsonValueArrayMakeUnique(JsonValueArray* arr);
+int JsonValueArrayPack(JsonValueArray* arr, int packing);
+void JsonValueArrayUnpack(JsonValueArray* arr);
+void JsonValueArrayReserve(JsonValueArray* arr, ullong capacity);
+void JsonValueArrayShrinkToFit(JsonValueArray* arr);
+void JsonValueArrayAppend(JsonValueArray* arr, struct JsonValue_t value);
+void JsonValueArrayRemove(JsonValueArray* arr, ullong index);
+void JsonValueArraySwapRemove(JsonValueArray* arr, ullong index);
+void JsonValueArrayRemoveRange(JsonValueArray* arr, ullong index, ullong count);
+ullong JsonValueArrayRemoveIf(JsonValueArray* arr, JsonValuePredicate predicate, void* data);
+
+/*
+	JsonPair Array
+
+	FIELDS:
+
+	> Allocator
+	Same as JsonValueArray.Allocator
+*/
+
+struct JsonPair_t;
+
+typedef struct JsonPairArray_t {
+	struct JsonPair_t* Buffer;
+	ullong Length;
+	ullong Capacity;
+	ullong* RefCount;
+	struct JsonShape_t* Shape;
+	JsonAllocator* Allocator;
+} JsonPairArray;
+
+typedef int (*JsonPairPredicate)(struct JsonPair_t* pair, void* data);
+
+JsonPairArray* JsonPairArrayInit();
+void JsonPairArrayMakeUnique(JsonPairArray* arr);
+void JsonPairArrayUnshape(JsonPairArray* arr);
+void JsonPairArrayReserve(JsonPairArray* arr, ullong capacity);
+void JsonPairArrayShrinkToFit(JsonPairArray* arr);
+void JsonPairArrayAppend(JsonPairArray* arr, struct JsonPair_t pair);
+void JsonPairArrayRemove(JsonPairArray* arr, ullong index);
+void JsonPairArraySwapRemove(JsonPairArray* arr, ullong index);
+void JsonPairArrayRemoveRange(JsonPairArray* arr, ullong index, ullong count);
+ullong JsonPairArrayRemoveIf(JsonPairArray* arr, JsonPairPredicate predicate, void* data);
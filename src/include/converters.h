@@ -1,15 +1,30 @@
-
-/*
-	converters.h
-	- Contains features for converting between datatypes
-*/
-
-#pragma once
-
-#include "json-types.h"
-
-#define SUCCESS 1
-#define FAILURE 0
-
-int StringToInt(const char* str, JsonInt** integer);
-int StringToFloat(const char* str, JsonFloat** flt);
+
+/*
+	converters.h
+	- Contains features for converting between datatypes
+*/
+
+#pragma once
+
+#include "json-types.h"
+
+#define SUCCESS 1
+#define FAILURE 0
+
+int StringToInt(const char* str, JsonInt** integer);
+int StringToFloat(const char* str, JsonFloat** flt);
+
+/*
+	Buffer sizes for IntToString(), DoubleToString(), LDoubleToString() and DoubleToCanonicalString(), big enough for
+	the longest number each of them writes
+*/
+
+#define LLONG_STRING_SIZE 24
+#define DOUBLE_STRING_SIZE 352
+#define LDOUBLE_STRING_SIZE 5000
+#define CANONICAL_STRING_SIZE 32
+
+ullong IntToString(char* buffer, llong integer);
+ullong DoubleToString(char* buffer, double flt);
+ullong LDoubleToString(char* buffer, ldouble flt);
+ullong DoubleToCanonicalString(char* buffer, double flt);
@@ -1,25 +1,41 @@
-
-/*
-	> file-io.h
-	Header file for defining functions for interacting with the computer's filesystem
-	Documentation about the below functions can be found in file-io.c
-*/
-
-#pragma once
-
-#include "error.h"
-
-#define SUCCESS 1
-#define FAILURE 0
-
-/*
-	Reading From File
-*/
-
-Error* FileReadAllText(const char* path, const char** text);
-
-/*
-	Writing To File
-*/
-
-Error* FileWriteAllText(const char* path, const char* text);
+
+/*
+	> file-io.h
+	Header file for defining functions for interacting with the computer's filesystem
+	Documentation about the below functions can be found in file-io.c
+*/
+
+#pragma once
+
+#include "error.h"
+
+#define SUCCESS 1
+#define FAILURE 0
+
+/*
+	Reading From File
+*/
+
+Error* FileReadAllText(const char* path, const char** text);
+
+/*
+	Writing To File
+*/
+
+Error* FileWriteAllText(const char* path, const char* text);
+
+/*
+	Writing Streams
+*/
+
+#define FileDescriptorData(fd) ((void*)(long long)(fd))
+#define FileDescriptorFromData(data) ((int)(long long)(data))
+
+int FileWriteSink(void* file, const char* buffer, ullong length);
+int FdWriteSink(void* fd, const char* buffer, ullong length);
+
+/*
+	Writing Buffers To File
+*/
+
+Error* FileWriteVector(const char* path, const char** buffers, const ullong* lengths, ullong count);
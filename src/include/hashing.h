@@ -0,0 +1,30 @@
+
+/*
+	> hashing.h
+	Header file for defining a streaming hash (XXH64) which chars can be fed into a chunk at a time
+	Documentation about the below functions can be found in hashing.c
+*/
+
+#pragma once
+
+#include "types.h"
+#include "allocator.h"
+
+/*
+	Hasher
+*/
+
+#define HasherDelete(hasher) JsonFree(hasher)
+
+typedef struct {
+	ullong Lanes[4];
+	ullong Total;
+	ullong Seed;
+	unsigned char Buffer[32];
+	ullong Buffered;
+} Hasher;
+
+Hasher* HasherInit(ullong seed);
+void HasherUpdate(Hasher* hasher, const char* data, ullong length);
+ullong HasherDigest(Hasher* hasher);
+int HasherSink(void* hasher, const char* buffer, ullong length);
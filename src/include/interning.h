@@ -0,0 +1,42 @@
+
+/*
+	> interning.h
+	Header file for defining string tables (one shared copy of every distinct string value) and functions which
+	interact with them
+	Documentation about the below functions can be found in interning.c
+*/
+
+#pragma once
+
+#include "json-types.h"
+
+/*
+	Json String Table
+*/
+
+typedef struct {
+	ullong Hash;
+	ullong Length;
+	JsonString String;
+} JsonStringEntry;
+
+typedef struct JsonStringTable_t {
+	JsonStringEntry* Buffer;
+	ullong Length;
+	ullong Capacity;
+} JsonStringTable;
+
+/*
+	Interned Strings
+*/
+
+JsonString JsonStringRetain(JsonString string);
+void JsonStringRelease(JsonString string);
+
+/*
+	Interning Strings
+*/
+
+JsonStringTable* JsonStringTableInit();
+void JsonStringTableDelete(JsonStringTable* table);
+JsonString JsonStringTableIntern(JsonStringTable* table, const char* string, ullong length, ullong hash);
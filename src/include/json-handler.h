@@ -1,14 +1,56 @@
-
-#pragma once
-
-#include "error.h"
-
-#define JsonHandlerDelete(handler)			\
-	ErrorDelete(handler->Error);			\
-	free(handler);
-
-typedef struct {
-	Error* Error;
-} JsonHandler;
-
-JsonHandler* JsonHandlerInit();
+
+#pragma once
+
+#include "error.h"
+
+#define JsonHandlerDelete(handler)			\
+	ErrorDelete(handler->Error);			\
+	JsonFree(handler);
+
+/*
+	Json Handler
+
+	FIELDS:
+
+	> Error
+	The error raised by the last operation which used this handler
+
+	> PresizeContainers
+	When TRUE the Parser scans the token stream before parsing and allocates every JsonList and JsonExpr at its
+	exact final size. Off by default
+
+	> PackNumericLists
+	When TRUE every JsonList which only holds JsonInts or only holds JsonFloats is stored as a packed number array
+	(see JsonListPack()), which takes 8 bytes per element instead of around 50. Off by default, as code which reads
+	list->Buffer directly has to check list->Packing first
+
+	> ShareShapes
+	When TRUE JsonExprs which have the same keys in the same order share one key table (see shapes.c) instead of
+	every JsonExpr owning a copy of its keys, and looking up a key in them uses the table's cached slot. Off by
+	default, as code which frees or replaces expr->Buffer[i].Key directly has to check expr->Shape first
+
+	> InternStrings
+	When TRUE every key and string value of a document is interned (see interning.c), so repeated keys and values
+	share one copy instead of every JsonPair and JsonValue owning its own. Off by default, as code which frees or
+	replaces expr->Buffer[i].Key or value->Data->String directly has to check KeyInterned or Interned first
+
+	> Strings
+	JsonStringTable shared between every document loaded with this handler, which turns on interning as well.
+	Created and deleted by the caller. NULL by default, which gives every document its own table
+
+	> Allocator
+	Allocator used for every allocation made by a function which is passed this handler. When NULL the calling
+	thread's allocator is used (see JsonUseAllocator() in allocator.c)
+*/
+
+typedef struct {
+	Error* Error;
+	int PresizeContainers;
+	int PackNumericLists;
+	int ShareShapes;
+	int InternStrings;
+	struct JsonStringTable_t* Strings;
+	JsonAllocator* Allocator;
+} JsonHandler;
+
+JsonHandler* JsonHandlerInit();
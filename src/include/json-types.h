@@ -1,85 +1,207 @@
-
-/*
-	> json-types.h
-	Header file for defining JSON datatypes and functions which interact with them
-	Documentation about the below functions can be found in json-types.c
-*/
-
-#pragma once
-
-#include "containers.h"
-
-#define JsonListInit JsonValueArrayInit
-#define JsonExprInit JsonPairArrayInit
-#define JsonTrue JsonCreateKeyword(JSON_TRUE)
-#define JsonFalse JsonCreateKeyword(JSON_FALSE)
-#define JsonNull JsonCreateKeyword(JSON_NULL)
-
-typedef const char* JsonString;
-typedef long long JsonInt;
-typedef long double JsonFloat;
-typedef struct JsonValueArray_t JsonList;
-typedef struct JsonPairArray_t JsonExpr;
-
-typedef enum {
-	JSON_EXPR,
-	JSON_LIST,
-	JSON_STRING,
-	JSON_INT,
-	JSON_FLOAT,
-	JSON_TRUE,
-	JSON_FALSE,
-	JSON_NULL
-} JsonType;
-
-typedef union {
-	JsonExpr* Expr;
-	JsonList* List;
-	JsonString String;
-	JsonInt* Int;
-	JsonFloat* Float;
-} JsonData;
-
-typedef struct JsonValue_t {
-	JsonType Type;
-	JsonData* Data;
-} JsonValue;
-
-typedef struct JsonPair_t {
-	const char* Key;
-	JsonValue* Value;
-} JsonPair;
-
-/*
-	Memory Allocation
-*/
-
-JsonString* AllocJsonString(JsonString string);
-JsonInt* AllocJsonInt(JsonInt integer);
-JsonFloat* AllocJsonFloat(JsonFloat flt);
-
-/*
-	Initializing Data
-*/
-
-JsonValue* JsonValueInit(void* data, JsonType type);
-JsonPair* JsonPairInit(const char* key, JsonValue* value);
-
-/*
-	Copying Data
-*/
-
-JsonValue* JsonValueCopy(JsonValue* value);
-JsonPair* JsonPairCopy(JsonPair* pair);
-JsonList* JsonListCopy(JsonList* list);
-JsonExpr* JsonExprCopy(JsonExpr* expr);
-
-/*
-	Deleting Data
-*/
-
-void JsonDataDelete(JsonValue* value);
-void JsonValueDelete(JsonValue* value);
-void JsonPairDelete(JsonPair* pair);
-void JsonListDelete(JsonList* list);
-void JsonExprDelete(JsonExpr* expr);
+
+/*
+	> json-types.h
+	Header file for defining JSON datatypes and functions which interact with them
+	Documentation about the below functions can be found in json-types.c
+*/
+
+#pragma once
+
+#include "containers.h"
+
+#define JsonListInit JsonValueArrayInit
+#define JsonExprInit JsonPairArrayInit
+#define JsonListReserve JsonValueArrayReserve
+#define JsonExprReserve JsonPairArrayReserve
+#define JsonListShrinkToFit JsonValueArrayShrinkToFit
+#define JsonExprShrinkToFit JsonPairArrayShrinkToFit
+#define JsonListMakeUnique JsonValueArrayMakeUnique
+#define JsonExprMakeUnique JsonPairArrayMakeUnique
+#define JsonExprUnshape JsonPairArrayUnshape
+#define JsonListPack JsonValueArrayPack
+#define JsonListUnpack JsonValueArrayUnpack
+#define JsonTrue JsonCreateKeyword(JSON_TRUE)
+#define JsonFalse JsonCreateKeyword(JSON_FALSE)
+#define JsonNull JsonCreateKeyword(JSON_NULL)
+
+/*
+	Key Hashing
+
+	MACROS:
+
+	> JSON_HASH_OFFSET
+	Starting value of a key hash (FNV-1a 64 bit offset basis)
+
+	> JSON_HASH_PRIME
+	Multiplier applied to a key hash for every byte (FNV-1a 64 bit prime)
+
+	> JsonHashStep()
+	Feeds one char into a key hash. The Lexer uses this to hash strings while it builds them
+*/
+
+#define JSON_HASH_OFFSET 14695981039346656037ULL
+#define JSON_HASH_PRIME 1099511628211ULL
+#define JsonHashStep(hash, chr) (((hash) ^ (unsigned char)(chr)) * JSON_HASH_PRIME)
+
+/*
+	Strings
+
+	MACROS:
+
+	> JSON_NUL_LEAD, JSON_NUL_TRAIL
+	The two bytes a \u0000 escape is stored as (the overlong UTF-8 form of U+0000, as in Java's modified UTF-8)
+
+	> JsonIsNul()
+	Returns 1 if the two bytes at a pointer are JSON_NUL_LEAD and JSON_NUL_TRAIL
+
+	NOTES:
+
+	A JsonString is null terminated and has no stored length, so a U+0000 inside of one is kept as the two bytes
+	0xC0 0x80 rather than as a '\0' which would end it. Valid UTF-8 never holds 0xC0, so the serialiser writes the
+	pair back as \u0000 and the columns turn it back into a '\0' (Arrow strings have lengths)
+*/
+
+#define JSON_NUL_LEAD 0xC0
+#define JSON_NUL_TRAIL 0x80
+#define JsonIsNul(ptr) ((unsigned char)(ptr)[0] == JSON_NUL_LEAD && (unsigned char)(ptr)[1] == JSON_NUL_TRAIL)
+
+typedef const char* JsonString;
+typedef long long JsonInt;
+
+/*
+	Float Representation
+
+	MACROS:
+
+	> JSON_FLOAT_DOUBLE
+	When defined (e.g., with -DJSON_FLOAT_DOUBLE) JsonFloat is a double instead of a long double. Floats are then
+	parsed with strtod() and printed with StringBuilderAppendDOUBLE(), which avoids x87 code and halves the size of
+	every stored float. JSON numbers are binary64 anyway so no precision is lost when loading a document
+
+	NOTES:
+
+	Every file which uses the library has to be compiled with the same setting, as it changes the size of JsonFloat
+*/
+
+#ifdef JSON_FLOAT_DOUBLE
+typedef double JsonFloat;
+#else
+typedef long double JsonFloat;
+#endif
+
+typedef struct JsonValueArray_t JsonList;
+typedef struct JsonPairArray_t JsonExpr;
+
+typedef enum {
+	JSON_EXPR,
+	JSON_LIST,
+	JSON_STRING,
+	JSON_INT,
+	JSON_FLOAT,
+	JSON_TRUE,
+	JSON_FALSE,
+	JSON_NULL
+} JsonType;
+
+typedef union {
+	JsonExpr* Expr;
+	JsonList* List;
+	JsonString String;
+	JsonInt* Int;
+	JsonFloat* Float;
+} JsonData;
+
+/*
+	Json Value
+
+	FIELDS:
+
+	> Type, Data
+	The type of the value and the data it holds
+
+	> Interned
+	Set when Data->String is an interned string which is shared with other JsonValues (see interning.c). It is
+	released instead of freed when the JsonValue is deleted
+
+	> Plain
+	Set when Data->String is known to hold no chars which have to be escaped in JSON (quotes, backslashes and
+	control chars). The Parser sets it for strings the Lexer found no escapes or control chars in, so they are
+	serialised without being scanned. Strings without it are scanned and escaped as needed
+*/
+
+typedef struct JsonValue_t {
+	JsonType Type;
+	unsigned short Interned;
+	unsigned short Plain;
+	JsonData* Data;
+} JsonValue;
+
+/*
+	Json Pair
+
+	FIELDS:
+
+	> Key, KeyLength, KeyHash
+	The key of the pair, its length and its hash (see JsonHashKey())
+
+	> KeyInterned
+	Same as JsonValue.Interned but for the key. The Parser interns keys as well as string values
+
+	> Value
+	The value of the pair
+*/
+
+typedef struct JsonPair_t {
+	const char* Key;
+	uint KeyLength;
+	uint KeyInterned;
+	ullong KeyHash;
+	JsonValue* Value;
+} JsonPair;
+
+/*
+	Key Hashing
+*/
+
+ullong JsonHashKey(const char* key, ullong length);
+
+/*
+	Memory Allocation
+*/
+
+char* AllocJsonString(JsonString string);
+JsonInt* AllocJsonInt(JsonInt integer);
+JsonFloat* AllocJsonFloat(JsonFloat flt);
+
+/*
+	Initializing Data
+*/
+
+JsonValue* JsonValueInit(void* data, JsonType type);
+JsonPair* JsonPairInit(const char* key, JsonValue* value);
+JsonPair* JsonPairInitHashed(const char* key, ullong length, ullong hash, JsonValue* value);
+
+/*
+	Copying Data
+*/
+
+JsonValue* JsonValueCopy(JsonValue* value);
+JsonPair* JsonPairCopy(JsonPair* pair);
+JsonList* JsonListCopy(JsonList* list);
+JsonExpr* JsonExprCopy(JsonExpr* expr);
+
+/*
+	Deleting Data
+*/
+
+void JsonDataDelete(JsonValue* value);
+void JsonValueDelete(JsonValue* value);
+void JsonPairDelete(JsonPair* pair);
+void JsonListDelete(JsonList* list);
+void JsonExprDelete(JsonExpr* expr);
+
+/*
+	Compacting Data
+*/
+
+void JsonCompact(JsonExpr* expr);
@@ -1,31 +1,37 @@
-
-/*
-	> parser.h
-	Header file for defining a JSON Parser and functions which interact with it
-	Documentation about the below functions can be found in parser.c
-*/
-
-#pragma once
-
-#include "containers.h"
-#include "error.h"
-
-typedef struct {
-	TokenArray* Tokens;
-	Token* Token;
-	ullong Index;
-	Error* Error;
-} Parser;
-
-
-/*
-	Initializing Data
-*/
-
-Parser* ParserInit(TokenArray* tokens);
-
-/*
-	Get Results
-*/
-
-JsonExpr* ParserGetResult(Parser* parser);
+
+/*
+	> parser.h
+	Header file for defining a JSON Parser and functions which interact with it
+	Documentation about the below functions can be found in parser.c
+*/
+
+#pragma once
+
+#include "containers.h"
+#include "error.h"
+
+typedef struct {
+	TokenArray* Tokens;
+	Token* Token;
+	ullong Index;
+	int Presize;
+	int Pack;
+	int Share;
+	struct JsonShapeTable_t* Shapes;
+	int Intern;
+	struct JsonStringTable_t* Strings;
+	Error* Error;
+} Parser;
+
+
+/*
+	Initializing Data
+*/
+
+Parser* ParserInit(TokenArray* tokens);
+
+/*
+	Get Results
+*/
+
+JsonExpr* ParserGetResult(Parser* parser);
@@ -0,0 +1,114 @@
+
+/*
+	> persistent.h
+	Header file for defining persistent (immutable, structurally shared) JSON datatypes and functions which
+	interact with them
+	Documentation about the below functions can be found in persistent.c
+*/
+
+#pragma once
+
+#include "json-types.h"
+
+/*
+	Persistent Datatypes
+
+	TYPES:
+
+	> JsonPersistentValue
+	An immutable value. Works the same as a JsonValue but lists and exprs are persistent
+
+	> JsonPersistentExpr
+	An immutable JsonExpr stored as a hash array mapped trie (HAMT) keyed on the key hash
+
+	> JsonPersistentList
+	An immutable JsonList stored as a 32-way trie indexed by position
+
+	NOTES:
+
+	Every object is reference counted. Functions which return a new object (or version) give the caller one
+	reference which has to be released with the matching Release() function
+*/
+
+typedef struct JsonPersistentExpr_t JsonPersistentExpr;
+typedef struct JsonPersistentList_t JsonPersistentList;
+
+typedef struct JsonPersistentValue_t {
+	ullong RefCount;
+	JsonType Type;
+
+	union {
+		JsonPersistentExpr* Expr;
+		JsonPersistentList* List;
+		char* String;
+		JsonInt Int;
+		JsonFloat Float;
+	} Data;
+} JsonPersistentValue;
+
+struct JsonPersistentExpr_t {
+	ullong RefCount;
+	ullong Length;
+	struct PersistentNode_t* Root;
+};
+
+struct JsonPersistentList_t {
+	ullong RefCount;
+	ullong Length;
+	uint Shift;
+	struct PersistentVectorNode_t* Root;
+};
+
+typedef void (*JsonPersistentPairCallback)(const char* key, JsonPersistentValue* value, void* data);
+
+/*
+	Creating Values
+*/
+
+JsonPersistentValue* JsonPersistentCreateString(JsonString string);
+JsonPersistentValue* JsonPersistentCreateInt(JsonInt integer);
+JsonPersistentValue* JsonPersistentCreateFloat(JsonFloat flt);
+JsonPersistentValue* JsonPersistentCreateKeyword(JsonType keyword);
+JsonPersistentValue* JsonPersistentCreateExpr(JsonPersistentExpr* expr);
+JsonPersistentValue* JsonPersistentCreateList(JsonPersistentList* list);
+
+/*
+	Reference Counting
+*/
+
+JsonPersistentValue* JsonPersistentValueRetain(JsonPersistentValue* value);
+JsonPersistentExpr* JsonPersistentExprRetain(JsonPersistentExpr* expr);
+JsonPersistentList* JsonPersistentListRetain(JsonPersistentList* list);
+void JsonPersistentValueRelease(JsonPersistentValue* value);
+void JsonPersistentExprRelease(JsonPersistentExpr* expr);
+void JsonPersistentListRelease(JsonPersistentList* list);
+
+/*
+	Persistent Expr
+*/
+
+JsonPersistentExpr* JsonPersistentExprInit();
+int JsonPersistentGet(JsonPersistentExpr* expr, const char* key, JsonPersistentValue** value);
+int JsonPersistentGetHashed(JsonPersistentExpr* expr, const char* key, ullong length, ullong hash, JsonPersistentValue** value);
+JsonPersistentExpr* JsonPersistentSet(JsonPersistentExpr* expr, const char* key, JsonPersistentValue* value);
+JsonPersistentExpr* JsonPersistentRemoveKey(JsonPersistentExpr* expr, const char* key);
+void JsonPersistentForEach(JsonPersistentExpr* expr, JsonPersistentPairCallback callback, void* data);
+
+/*
+	Persistent List
+*/
+
+JsonPersistentList* JsonPersistentListInit();
+int JsonPersistentGetElement(JsonPersistentList* list, ullong index, JsonPersistentValue** value);
+JsonPersistentList* JsonPersistentAppend(JsonPersistentList* list, JsonPersistentValue* value);
+JsonPersistentList* JsonPersistentSetElement(JsonPersistentList* list, ullong index, JsonPersistentValue* value);
+JsonPersistentList* JsonPersistentRemoveLast(JsonPersistentList* list);
+
+/*
+	Converting Data
+*/
+
+JsonPersistentExpr* JsonExprToPersistent(JsonExpr* expr);
+JsonPersistentList* JsonListToPersistent(JsonList* list);
+JsonExpr* JsonPersistentToExpr(JsonPersistentExpr* expr);
+JsonList* JsonPersistentToList(JsonPersistentList* list);
@@ -0,0 +1,46 @@
+
+/*
+	> reductions.h
+	Header file for defining functions which aggregate the numbers inside of a JsonList
+	Documentation about the below functions can be found in reductions.c
+*/
+
+#pragma once
+
+#include "json-types.h"
+
+/*
+	Json Reduction
+
+	FIELDS:
+
+	> Count
+	Number of numbers (JsonInts and JsonFloats) which were reduced, every other value is skipped
+
+	> Sum, Min, Max, Mean
+	Aggregates of the numbers which were reduced. All of them are 0 when Count is 0
+*/
+
+typedef struct {
+	ullong Count;
+	JsonFloat Sum;
+	JsonFloat Min;
+	JsonFloat Max;
+	JsonFloat Mean;
+} JsonReduction;
+
+/*
+	Reducing Lists
+*/
+
+void JsonListReduce(JsonList* list, JsonReduction* reduction);
+JsonFloat JsonListSum(JsonList* list);
+int JsonListMinMax(JsonList* list, JsonFloat* min, JsonFloat* max);
+ullong JsonListHistogram(JsonList* list, JsonFloat min, JsonFloat max, ullong* bins, ullong count);
+
+/*
+	Reducing Fields
+*/
+
+void JsonListReduceField(JsonList* list, const char* key, JsonReduction* reduction);
+ullong JsonListHistogramField(JsonList* list, const char* key, JsonFloat min, JsonFloat max, ullong* bins, ullong count);
@@ -1,19 +1,199 @@
-
-/*
-	> serialisation.h
-	Header file for defining functions which serialise JSON datatypes
-	Documentation about the below functions can be found in serialisation.c
-*/
-
-#pragma once
-
-#include "json-types.h"
-
-/*
-	Serialising JSON Datatypes
-*/
-
-const char* SerialiseJsonValue(JsonValue* value);
-const char* SerialiseJsonPair(JsonPair* pair);
-const char* SerialiseJsonList(JsonList* list);
-const char* SerialiseJsonExpr(JsonExpr* expr);
+
+/*
+	> serialisation.h
+	Header file for defining functions which serialise JSON datatypes
+	Documentation about the below functions can be found in serialisation.c
+*/
+
+#pragma once
+
+#include "json-types.h"
+#include "containers.h"
+#include "error.h"
+
+/*
+	Json Dump Options
+
+	FIELDS:
+
+	> Compact
+	When TRUE nothing is written after the ',' between items and the ':' between keys and values, which gives the
+	smallest output. Off by default, which writes ", " and ": "
+
+	> Indent
+	When above 0 every element and pair is written on its own line, indented by this many spaces per level of
+	nesting, and ',' is written between items. Empty JsonLists and JsonExprs stay on one line. 0 by default
+
+	> SortKeys
+	When TRUE the pairs of every JsonExpr are written in key order instead of the order they are stored in. Off by
+	default
+
+	> Canonical
+	When TRUE the output follows RFC 8785 (JSON Canonicalization Scheme), so equal documents give the same bytes
+	however they were built: compact, keys sorted by their UTF-16 code units and numbers written the way ECMAScript
+	writes them. Compact, Indent and SortKeys are ignored. Off by default
+
+	NOTES:
+
+	A zeroed JsonDumpOptions gives the same output as JsonDumpString()
+*/
+
+typedef struct {
+	int Compact;
+	int Indent;
+	int SortKeys;
+	int Canonical;
+} JsonDumpOptions;
+
+/*
+	Serialiser
+
+	FIELDS:
+
+	> Builder
+	The StringBuilder the output is appended to. NULL when the Serialiser is only used for measuring
+
+	> ItemSeparator, ItemSeparatorLength
+	Written between the elements of a JsonList and the pairs of a JsonExpr
+
+	> KeySeparator, KeySeparatorLength
+	Written between the key and the value of a JsonPair
+
+	> Indent
+	Number of spaces every level of nesting is indented by. When 0 nothing is written on a new line
+
+	> Depth
+	Number of JsonLists and JsonExprs the Serialiser is currently inside of
+
+	> SortKeys
+	When TRUE the pairs of every JsonExpr are written in key order
+
+	> Canonical
+	When TRUE keys are ordered by UTF-16 code units and numbers are written in canonical form (see
+	JsonDumpOptions)
+*/
+
+typedef struct {
+	StringBuilder* Builder;
+	const char* ItemSeparator;
+	ullong ItemSeparatorLength;
+	const char* KeySeparator;
+	ullong KeySeparatorLength;
+	ullong Indent;
+	ullong Depth;
+	int SortKeys;
+	int Canonical;
+} Serialiser;
+
+/*
+	Serialising JSON Datatypes
+*/
+
+const char* SerialiseJsonValue(JsonValue* value);
+const char* SerialiseJsonPair(JsonPair* pair);
+const char* SerialiseJsonList(JsonList* list);
+const char* SerialiseJsonExpr(JsonExpr* expr);
+const char* SerialiseJsonExprEx(JsonExpr* expr, const JsonDumpOptions* options);
+ullong SerialisedJsonExprSize(JsonExpr* expr, const JsonDumpOptions* options);
+void SerialiseJsonExprTo(StringBuilder* builder, JsonExpr* expr, const JsonDumpOptions* options);
+
+/*
+	Serialised Parts
+
+	FIELDS:
+
+	> Buffers, Lengths
+	The chars of every part and how many there are in each, the parts are not null terminated
+
+	> Count
+	Number of parts
+
+	NOTES:
+
+	The parts of a parallel dump are the chars before the container which was split, one part per chunk of its
+	items, and the chars after it. Written one after another they make up the whole document
+*/
+
+typedef struct {
+	char** Buffers;
+	ullong* Lengths;
+	ullong Count;
+} SerialisedParts;
+
+/*
+	Parallel Serialising
+*/
+
+SerialisedParts* SerialiseJsonExprParts(JsonExpr* expr, const JsonDumpOptions* options, int threads);
+void SerialisedPartsDelete(SerialisedParts* parts);
+const char* SerialiseJsonExprParallel(JsonExpr* expr, const JsonDumpOptions* options, int threads);
+
+/*
+	Json Writer
+
+	MACROS:
+
+	> JSON_WRITER_MAX_DEPTH
+	Number of JsonLists and JsonExprs a JsonWriter can be inside of at once
+
+	> JsonWriterDelete()
+	Frees a JsonWriter which writes to a sink, along with its StringBuilder and Error. It should be flushed first
+
+	FIELDS:
+
+	> Serialiser
+	Formats everything the JsonWriter writes (see JsonDumpOptions), Serialiser.Depth is the current depth
+
+	> Nesting
+	One bit per depth which is set when the container at that depth is a JsonExpr and clear when it is a JsonList
+
+	> First
+	TRUE until the current container (or the document) has had something written into it
+
+	> ExpectValue
+	TRUE after a key has been written, until its value has been written
+
+	> Done
+	TRUE once a whole top level value has been written
+
+	> Error
+	The error raised by the first call which was not allowed where it was made (e.g., a key inside of a JsonList)
+*/
+
+#define JSON_WRITER_MAX_DEPTH 1024
+
+#define JsonWriterDelete(writer)					\
+	StringBuilderDelete(writer->Serialiser.Builder);\
+	ErrorDelete(writer->Error);						\
+	JsonFree(writer);
+
+typedef struct {
+	Serialiser Serialiser;
+	ullong Nesting[JSON_WRITER_MAX_DEPTH / 64];
+	int First;
+	int ExpectValue;
+	int Done;
+	Error* Error;
+} JsonWriter;
+
+JsonWriter* JsonWriterInit(const JsonDumpOptions* options);
+JsonWriter* JsonWriterInitSink(StringBuilderSink sink, void* data, const JsonDumpOptions* options);
+JsonWriter* JsonWriterInitFd(int fd, const JsonDumpOptions* options);
+int JsonWriterFlush(JsonWriter* writer);
+char* JsonWriterFinish(JsonWriter* writer);
+
+int JsonWriterBeginExpr(JsonWriter* writer);
+int JsonWriterEndExpr(JsonWriter* writer);
+int JsonWriterBeginList(JsonWriter* writer);
+int JsonWriterEndList(JsonWriter* writer);
+int JsonWriterKey(JsonWriter* writer, const char* key);
+int JsonWriterKeyBytes(JsonWriter* writer, const char* key, ullong length);
+
+int JsonWriterString(JsonWriter* writer, const char* string);
+int JsonWriterStringBytes(JsonWriter* writer, const char* string, ullong length);
+int JsonWriterInt(JsonWriter* writer, JsonInt integer);
+int JsonWriterFloat(JsonWriter* writer, JsonFloat flt);
+int JsonWriterTrue(JsonWriter* writer);
+int JsonWriterFalse(JsonWriter* writer);
+int JsonWriterNull(JsonWriter* writer);
+int JsonWriterValue(JsonWriter* writer, JsonValue* value);
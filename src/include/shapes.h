@@ -0,0 +1,76 @@
+
+/*
+	> shapes.h
+	Header file for defining shapes (key tables shared between JsonExprs with the same keys) and functions which
+	interact with them
+	Documentation about the below functions can be found in shapes.c
+*/
+
+#pragma once
+
+#include "json-types.h"
+
+#define SHAPE_SLOT_NOT_FOUND -1
+
+/*
+	Json Shape
+
+	FIELDS:
+
+	> RefCount
+	Number of JsonExprs which use the shape
+
+	> Length, Keys, KeyLengths, KeyHashes
+	The keys of the shape in order. The key strings belong to the shape, the JsonPairs of a JsonExpr which uses the
+	shape point at them instead of owning a copy
+
+	> KeysInterned
+	Set when the keys are interned strings (see JsonPair.KeyInterned), the shape then holds a reference on each of
+	them instead of owning them
+
+	> Hash
+	Hash of the whole key sequence, used to find shapes while parsing
+*/
+
+typedef struct JsonShape_t {
+	ullong RefCount;
+	ullong Length;
+	JsonString* Keys;
+	ullong* KeyLengths;
+	ullong* KeyHashes;
+	uint KeysInterned;
+	ullong Hash;
+} JsonShape;
+
+/*
+	Json Shape Table
+*/
+
+typedef struct {
+	ullong Hash;
+	JsonExpr* First;
+	JsonShape* Shape;
+} JsonShapeEntry;
+
+typedef struct JsonShapeTable_t {
+	JsonShapeEntry* Buffer;
+	ullong Length;
+	ullong Capacity;
+} JsonShapeTable;
+
+/*
+	Json Shapes
+*/
+
+JsonShape* JsonShapeInit(JsonExpr* expr);
+JsonShape* JsonShapeRetain(JsonShape* shape);
+void JsonShapeRelease(JsonShape* shape);
+ullong JsonShapeGetSlot(JsonShape* shape, const char* key, ullong length, ullong hash);
+
+/*
+	Sharing Shapes
+*/
+
+JsonShapeTable* JsonShapeTableInit();
+void JsonShapeTableDelete(JsonShapeTable* table);
+void JsonShapeTableShare(JsonShapeTable* table, JsonExpr* expr);
@@ -1,7 +1,7 @@
-
-#pragma once
-
-typedef unsigned long long ullong;
-typedef long long llong;
-typedef long double ldouble;
-typedef unsigned int uint;
+
+#pragma once
+
+typedef unsigned long long ullong;
+typedef long long llong;
+typedef long double ldouble;
+typedef unsigned int uint;
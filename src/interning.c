@@ -0,0 +1,150 @@
+#include <stdlib.h>
+#include <string.h>
+#include "include/interning.h"
+
+/*
+	Interned Strings
+
+	FUNCTIONS:
+
+	> StringHeader()
+	Gets the reference count which is stored in front of the chars of an interned string
+
+	> JsonStringRetain()
+	Adds a reference to an interned string and returns it
+
+	> JsonStringRelease()
+	Removes a reference from an interned string. The string is freed once nothing uses it
+
+	NOTES:
+
+	An interned string is allocated as a reference count followed by the null terminated chars, and the JsonString
+	points at the chars. It can be read like any other JsonString but must never be passed to JsonFree(). A
+	JsonValue which holds one has its Interned flag set, so JsonDataDelete() releases it instead of freeing it and
+	JsonValueCopy() retains it instead of copying it. A JsonPair whose key is interned has its KeyInterned flag set
+	for the same reason
+
+	The reference counts are not atomic, JsonValues which share interned strings should be used from the same thread
+*/
+
+static ullong* StringHeader(JsonString string) {
+	return (ullong*)string - 1;
+}
+
+JsonString JsonStringRetain(JsonString string) {
+	(*StringHeader(string))++;
+	return string;
+}
+
+void JsonStringRelease(JsonString string) {
+	ullong* header = StringHeader(string);
+
+	if (--*header == 0) {
+		JsonFree(header);
+	}
+}
+
+/*
+	Interning Strings
+
+	FUNCTIONS:
+
+	> JsonStringTableInit()
+	Initialize a JsonStringTable object
+
+	> JsonStringTableDelete()
+	Deletes a JsonStringTable object. The strings in it stay alive for as long as JsonValues use them
+
+	> JsonStringTableIntern()
+	Looks up the first 'length' chars of a string using a hash computed by the caller (the Lexer computes one for
+	every TOKEN_STRING, see JsonHashKey()). Returns a new reference to the table's copy of the string, creating the
+	copy the first time the string is seen
+
+	> StringTableGrow()
+	Doubles the capacity of a JsonStringTable and reinserts its entries
+
+	NOTES:
+
+	The Parser interns every key and string value it creates when JsonHandler.InternStrings is set, using a table which only
+	lives for one document, or JsonHandler.Strings when the caller provides a table which is shared between
+	documents. The table holds a reference on every string in it, so a shared table keeps every distinct string it
+	has seen alive until it is deleted
+
+	The table is an open addressing hash table keyed on the string hash, kept at most half full
+*/
+
+static void StringTableGrow(JsonStringTable* table) {
+	JsonStringEntry* entries = table->Buffer;
+	ullong capacity = table->Capacity;
+
+	table->Capacity = capacity > 0 ? capacity * 2 : 64;
+	table->Buffer = JsonCalloc(table->Capacity, sizeof(JsonStringEntry));
+
+	for (ullong i = 0; i < capacity; i++) {
+		if (entries[i].String == NULL) {
+			continue;
+		}
+
+		ullong index = entries[i].Hash & (table->Capacity - 1);
+
+		while (table->Buffer[index].String != NULL) {
+			index = (index + 1) & (table->Capacity - 1);
+		}
+
+		table->Buffer[index] = entries[i];
+	}
+
+	JsonFree(entries);
+}
+
+JsonStringTable* JsonStringTableInit() {
+	JsonStringTable* table = JsonCalloc(1, sizeof(JsonStringTable));
+	table->Buffer = NULL;
+	table->Length = 0;
+	table->Capacity = 0;
+
+	return table;
+}
+
+void JsonStringTableDelete(JsonStringTable* table) {
+	for (ullong i = 0; i < table->Capacity; i++) {
+		if (table->Buffer[i].String != NULL) {
+			JsonStringRelease(table->Buffer[i].String);
+		}
+	}
+
+	JsonFree(table->Buffer);
+	JsonFree(table);
+}
+
+JsonString JsonStringTableIntern(JsonStringTable* table, const char* string, ullong length, ullong hash) {
+	if ((table->Length + 1) * 2 > table->Capacity) {
+		StringTableGrow(table);
+	}
+
+	ullong index = hash & (table->Capacity - 1);
+
+	while (table->Buffer[index].String != NULL) {
+		JsonStringEntry* entry = &table->Buffer[index];
+
+		if (entry->Hash == hash && entry->Length == length && memcmp(entry->String, string, length) == 0) {
+			return JsonStringRetain(entry->String);
+		}
+
+		index = (index + 1) & (table->Capacity - 1);
+	}
+
+	ullong* header = JsonMalloc(sizeof(ullong) + length + 1);
+	char* chars = (char*)(header + 1);
+
+	memcpy(chars, string, length);
+	chars[length] = '\0';
+	*header = 2;
+
+	table->Buffer[index].Hash = hash;
+	table->Buffer[index].Length = length;
+	table->Buffer[index].String = chars;
+	table->Length++;
+
+	return chars;
+}
@@ -1,10 +1,16 @@
-
-#include <stdlib.h>
-#include "include/json-handler.h"
-
-JsonHandler* JsonHandlerInit() {
-	JsonHandler* handler = calloc(1, sizeof(JsonHandler));
-	handler->Error = ErrorInit();
-
-	return handler;
-}
+
+#include <stdlib.h>
+#include "include/json-handler.h"
+
+JsonHandler* JsonHandlerInit() {
+	JsonHandler* handler = JsonCalloc(1, sizeof(JsonHandler));
+	handler->Error = ErrorInit();
+	handler->PresizeContainers = FALSE;
+	handler->PackNumericLists = FALSE;
+	handler->ShareShapes = FALSE;
+	handler->InternStrings = FALSE;
+	handler->Strings = NULL;
+	handler->Allocator = NULL;
+
+	return handler;
+}
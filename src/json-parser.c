@@ -1,749 +1,1284 @@
-
-#include <stdlib.h>
-#include <string.h>
-#include "include/json-parser.h"
-#include "include/lexer.h"
-#include "include/parser.h"
-#include "include/serialisation.h"
-#include "include/file-io.h"
-
-#define CompareStrings(str1, str2) strcmp(str1, str2) == 0
-
-/*
-	Loading Json Data
-
-	FUNCTIONS:
-
-	> JsonLoadString()
-	Creates a JsonExpr object from a raw JSON string using a parsing algorithm
-	Creates an error in the handler if there is an error in the string
-
-	> JsonLoadFile()
-	Creates a JsonExpr object from a json file using a parsing algorithm
-	Creates an error in the handler if the contents of the file are invalid
-
-	> JsonDumpString()
-	Dumps a JsonExpr object to a string
-	String that is returns should be freed by the function caller
-
-	> JsonDumpFile()
-	Dumps a JsonExpr object to a json file
-	Creates an error in the JsonHandler if it failed to write to the file
-	
-	WARNING:
-
-	Attempting to work with a JsonExpr object return from JsonLoadString() or JsonLoadFile()
-	may result in a runtime error as the behaviour is undefined. Errors should be checked for
-	in the handler after calling this function. If there is no error then it is safe to proceed
-*/
-
-JsonExpr* JsonLoadString(JsonHandler* handler, const char* source) {
-	// Lexer
-
-	Lexer* lexer = LexerInit(source);
-	TokenArray* tokens = LexerGetResult(lexer);
-
-	if (lexer->Error->Exists) {
-		handler->Error = lexer->Error;
-		
-		// Free Lexer Memory
-
-		TokenArrayDelete(tokens);
-		free(lexer);
-
-		return;
-	}
-
-	// Parser
-
-	Parser* parser = ParserInit(tokens);
-	JsonExpr* expr = ParserGetResult(parser);
-
-	if (parser->Error->Exists) {
-		handler->Error = parser->Error;
-		
-		// Free Lexer & Parser Memory
-
-		TokenArrayDelete(tokens);
-		free(lexer);
-		free(parser);
-
-		return;
-	}
-
-	// Free All Memory
-
-	for (ullong i = 0; i < tokens->Length; i++) {
-		Token* token = &tokens->Buffer[i];
-
-		switch (token->Type) {
-			case TOKEN_STRING:
-			case TOKEN_INT:
-			case TOKEN_FLOAT:
-				free(token->Value);
-				break;
-		}
-	}
-
-	ErrorDelete(lexer->Error);
-	ErrorDelete(parser->Error);
-	TokenArrayDelete(tokens);
-	free(lexer);
-	free(parser);
-
-	return expr;
-}
-
-JsonExpr* JsonLoadFile(JsonHandler* handler, const char* path) {
-	char* source;
-	Error* error = FileReadAllText(path, &source);
-
-	if (error->Exists) {
-		handler->Error = error;
-		return;
-	}
-
-	JsonExpr* expr = JsonLoadString(handler, source);
-	ErrorDelete(error);
-	free(source);
-	return expr;
-}
-
-void JsonDumpString(JsonExpr* expr, const char** dest) {
-	*dest = SerialiseJsonExpr(expr);
-}
-
-void JsonDumpFile(JsonHandler* handler, JsonExpr* expr, const char* path) {
-	char* text;
-	JsonDumpString(expr, &text);
-	Error* error = FileWriteAllText(path, text);
-	free(text);
-
-	if (error->Exists) {
-		handler->Error = error;
-		return;
-	}
-
-	ErrorDelete(error);
-}
-
-/*
-	Creating Values
-
-	FUNCTIONS:
-
-	> JsonCreateString()
-	Creates a JsonValue object which stores a JsonString inside of it
-
-	> JsonCreateInt()
-	Creates a JsonValue object which stores a JsonInt inside of it
-
-	> JsonCreateFloat()
-	Creates a JsonValue object which stores a JsonFloat inside of it
-
-	> JsonCreateKeyword()
-	Creates a JsonValue which stores a keyword inside of it (true, false or null)
-*/
-
-JsonValue* JsonCreateString(JsonString string) {
-	JsonValue* value = calloc(1, sizeof(JsonValue));
-	value->Data = calloc(1, sizeof(JsonData));
-	value->Data->String = AllocJsonString(string);
-	value->Type = JSON_STRING;
-
-	return value;
-}
-
-JsonValue* JsonCreateInt(JsonInt integer) {
-	JsonValue* value = calloc(1, sizeof(JsonValue));
-	value->Data = calloc(1, sizeof(JsonData));
-	value->Data->Int = AllocJsonInt(integer);
-	value->Type = JSON_INT;
-
-	return value;
-}
-
-JsonValue* JsonCreateFloat(JsonFloat flt) {
-	JsonValue* value = calloc(1, sizeof(JsonValue));
-	value->Data = calloc(1, sizeof(JsonData));
-	value->Data->Float = AllocJsonFloat(flt);
-	value->Type = JSON_FLOAT;
-
-	return value;
-}
-
-JsonValue* JsonCreateKeyword(JsonType keyword) {
-	JsonValue* value = calloc(1, sizeof(JsonValue));
-	value->Type = keyword;
-
-	return value;
-}
-
-/*
-	Accessing Data
-
-	MACROS:
-
-	> COMPARE_KEYS()
-	Compares two keys to see if they match (technically its just a shorthand for string comparison)
-
-	> PAIR_INDEX_NOT_FOUND
-	The index of a key in a JsonExpr was not found (the JsonExpr object does not contain this key)
-
-	> SUCCESS
-	An operation was successfuly
-
-	> FAILURE
-	An operation failed
-
-	FUNCTIONS:
-
-	> JsonGetPairIndex()
-	Returns the index of a key in a JsonExpr
-	Returns PAIR_INDEX_NOT_FOUND if the key does not exist
-
-	> JsonKeyExists()
-	Returns 1 if a key exists in a JsonExpr
-	Returns 0 if the key does not exist
-
-	> JsonGetValue()
-
-	Gets the value which belongs to a key in a JsonExpr object
-	Returns SUCCESS if the value was found
-	Returns FAILURE if the value was not found
-
-	> JsonGetList()
-	Gets the JsonList which belongs to a key in a JsonExpr
-	Returns SUCCESS if a JsonList was found
-	Returns FAILURE if the value was not found or if the value type is not JSON_LIST
-
-	> JsonGetExpr()
-	Gets the JsonExpr which belongs to a key in a JsonExpr
-	Returns SUCCESS if a JsonExpr was found
-	Returns FAILURE if the value was not found or if the value type is not JSON_EXPR
-
-	WARNING:
-	Attempting to work with a value assigned by JsonGetValue(), JsonGetList() or JsonGetExpr()
-	without checking for an error may result in a runtime error as the behaviour is undefined.
-	You should check that the return values from these functions is 1 and not 0 before using the value
-*/
-
-#define PAIR_INDEX_NOT_FOUND -1
-#define SUCCESS 1
-#define FAILURE 0
-
-ullong JsonGetPairIndex(JsonExpr* expr, const char* key) {
-	for (ullong i = 0; i < expr->Length; i++) {
-		if (CompareStrings(expr->Buffer[i].Key, key)) {
-			return i;
-		}
-	}
-
-	return PAIR_INDEX_NOT_FOUND;
-}
-
-ullong JsonKeyExists(JsonExpr* expr, const char* key) {
-	return JsonGetPairIndex(expr, key) != PAIR_INDEX_NOT_FOUND;
-}
-
-int JsonGetValue(JsonExpr* expr, const char* key, JsonValue** value) {
-	ullong index = JsonGetPairIndex(expr, key);
-
-	if (index == PAIR_INDEX_NOT_FOUND) {
-		return FAILURE;
-	}
-
-	*value = expr->Buffer[index].Value;
-	return SUCCESS;
-}
-
-int JsonGetList(JsonExpr* expr, const char* key, JsonList** list) {
-	JsonValue* value;
-
-	if (JsonGetValue(expr, key, &value)) {
-		if (value->Type != JSON_LIST) {
-			return FAILURE;
-		}
-
-		*list = value->Data->List;
-		return SUCCESS;
-	}
-	
-	return FAILURE;
-}
-
-int JsonGetExpr(JsonExpr* expr, const char* key, JsonExpr** expr2) {
-	JsonValue* value;
-
-	if (JsonGetValue(expr, key, &value)) {
-		if (value->Type != JSON_EXPR) {
-			return FAILURE;
-		}
-
-		*expr2 = value->Data->Expr;
-		return SUCCESS;
-	}
-
-	return FAILURE;
-}
-
-/*
-	Comparing Data
-
-	MACROS:
-
-	> CompareValueExprs()
-	Compares two JsonValues which are both JsonExprs
-
-	> CompareValueLists()
-	Compares two JsonValues which are both JsonLists
-
-	> CompareValueString()
-	Compares two JsonValues which are both JsonStrings
-
-	> CompareValueInt()
-	Compares two JsonValues which are both JsonInts
-
-	> CompareValueFloat()
-	Compares two JsonValues which are both JsonFloats
-
-	FUNCTIONS:
-
-	> JsonCompareValues()
-	Compares two JsonValues together
-	If both JsonValues point to the same JsonValue struct in memory then they are automatically the same
-	If they both share the same datatype it will compare the JsonData inside of each JsonValue
-
-	> JsonComparePairs()
-	Compares two JsonPairs together
-	If both JsonPairs point to the same JsonPair struct in memory then they are autoamtically the same
-	If the keys both match then it will call JsonCompareValues on both of the values
-
-	> JsonCompareLists()
-	Compares two JsonLists together
-	If both JsonLists point to the same JsonList struct in memory then they are automatically the same
-	If both JsonLists do not share the same length then they cannot be the same
-	If every JsonValue in both of the JsonLists match at the same index then they are identical
-
-	> JsonCompareExprs()
-	Compares two JsonExprs together
-	If both JsonExprs point to the same JsonExpr struct in memory then they are automatically the same
-	If both JsonExprs do not share the same length then they cannot be the same
-	
-	NOTE:
-
-	Unlike JsonCompareLists(), JsonCompareExprs() does not require the values to match at the same index.
-	For example: {"name": "John", "age": 30} and {"age": 30, "name": "John"} would still be seen as equal.
-	This does not apply in a JsonList as it is indexed by integers not keys
-*/
-
-#define CompareValueExprs(value1, value2)							\
-	JsonCompareExprs(value1->Data->Expr, value2->Data->Expr)
-
-#define CompareValueLists(value1, value2)							\
-	JsonCompareLists(value1->Data->List, value2->Data->List)
-
-#define CompareValueString(value1, value2)							\
-	CompareStrings(value1->Data->String, value2->Data->String)
-
-#define CompareValueInt(value1, value2)								\
-	*value1->Data->Int == *value2->Data->Int
-
-#define CompareValueFloat(value1, value2)							\
-	*value1->Data->Float == *value2->Data->Float
-
-#define TRUE 1
-#define FALSE 0
-
-int JsonCompareValues(JsonValue* value1, JsonValue* value2) {
-	if (value1 == value2) {
-		return TRUE;
-	}
-
-	switch (value1->Type) {
-		case JSON_EXPR:
-			return value2->Type == JSON_EXPR
-				? CompareValueExprs(value1, value2)
-				: FALSE;
-		case JSON_LIST:
-			return value2->Type == JSON_LIST
-				? CompareValueLists(value1, value2)
-				: FALSE;
-		case JSON_STRING:
-			return value2->Type == JSON_STRING
-				? CompareValueString(value1, value2)
-				: FALSE;
-		case JSON_INT:
-			return value2->Type == JSON_INT
-				? CompareValueInt(value1, value2)
-				: FALSE;
-		case JSON_FLOAT:
-			return value2->Type == JSON_FLOAT
-				? CompareValueFloat(value1, value2)
-				: FALSE;
-		case JSON_TRUE:
-		case JSON_FALSE:
-		case JSON_NULL:
-			return value1->Type == value2->Type;
-	}
-}
-
-int JsonComparePairs(JsonPair* pair1, JsonPair* pair2) {
-	if (pair1 == pair2) {
-		return TRUE;
-	}
-	
-	if (!CompareStrings(pair1->Key, pair2->Key)) {
-		return FALSE;
-	}
-
-	return JsonCompareValues(pair1->Value, pair2->Value);
-}
-
-int JsonCompareLists(JsonList* list1, JsonList* list2) {
-	if (list1 == list2) {
-		return TRUE;
-	}
-
-	if (list1->Length != list2->Length) {
-		return FALSE;
-	}
-
-	for (ullong i = 0; i < list1->Length; i++) {
-		JsonValue* value1 = &list1->Buffer[i];
-		JsonValue* value2 = &list2->Buffer[i];
-
-		if (!JsonCompareValues(value1, value2)) {
-			return FALSE;
-		}
-	}
-
-	return TRUE;
-}
-
-int JsonCompareExprs(JsonExpr* expr1, JsonExpr* expr2) {
-	if (expr1 == expr2) {
-		return TRUE;
-	}
-
-	if (expr1->Length != expr2->Length) {
-		return FALSE;
-	}
-
-	for (ullong i = 0; i < expr1->Length; i++) {
-		JsonPair* pair1 = &expr1->Buffer[i];
-		JsonValue* value1 = pair1->Value;
-		JsonValue* value2;
-
-		if (JsonGetValue(expr2, pair1->Key, &value2)) {
-			if (!JsonCompareValues(value1, value2)) {
-				return FALSE;
-			}
-		}
-		else {
-			return FALSE;
-		}
-	}
-
-	return TRUE;
-}
-
-/*
-	Modifying List
-
-	FUNCTIONS:
-
-	> JsonAppend()
-	Adds a JsonValue to a JsonList
-	Used for when you want to append a JsonValue to a JsonList
-
-	> JsonAppendString()
-	Creates a JsonValue from a JsonString and adds it to a JsonList
-	Used for when you want to append a string to a JsonList
-
-	> JsonAppendInt()
-	Creates a JsonValue from a JsonInt and adds it to a JsonList
-	Used for when you want to append an int to a JsonList
-
-	> JsonAppendFloat()
-	Creates a JsonValue from a JsonFloat and adds it to a JsonList
-	Used for when you want to append a float to a JsonList
-
-	> JsonAppendTrue
-	Creates a JsonValue which equals JSON_TRUE (true keyword)
-	Used for when you want to add true to a JsonList
-
-	> JsonAppendFalse
-	Creates a JsonValue which equals JSON_FALSE (false keyword)
-	Used for when you want to add false to a JsonList
-
-	> JsonAppendNull
-	Creates a JsonValue which equals JSON_NULL (null keyword)
-	Used for when you want to add null to a JsonList
-
-	> JsonAppendList()
-	Appends a JsonList to a JsonList
-	If you are adding a JsonList to itself a copy will be made of the JsonExpr to avoid errors, this may result in
-	a very small memory leak as the memory deallocator has lost a reference to the data. This can be fixed
-	by manually freeing the list
-	
-	> JsonAppendExpr()
-	Appends a JsonExpr to a JsonList
-	
-	> JsonAddRange()
-	Adds the values of a JsonList to another
-	Used for combining two JsonLists
-	example: [1, 2, 3] MERGED WITH [4, 5, 6] IS [1, 2, 3, 4, 5, 6]
-	Will delete the second list if argument 'reuse_list' is true
-
-	> JsonRemoveElement()
-	Removes an element in a JsonList at a specific index. Indexes are always 0 based. 
-	Will return a failure if the index is out of bounds
-*/
-
-void JsonAppend(JsonList* list, JsonValue* value) {
-	JsonValueArrayAppend(list, *value);
-}
-
-void JsonAppendString(JsonList* list, JsonString string) {
-	JsonValue* value = JsonCreateString(string);
-	JsonAppend(list, value);
-	free(value);
-}
-
-void JsonAppendInt(JsonList* list, JsonInt integer) {
-	JsonValue* value = JsonCreateInt(integer);
-	JsonAppend(list, value);
-	free(value);
-}
-
-void JsonAppendFloat(JsonList* list, JsonFloat flt) {
-	JsonValue* value = JsonCreateFloat(flt);
-	JsonAppend(list, value);
-	free(value);
-}
-
-void JsonAppendTrue(JsonList* list) {
-	JsonValue* value = JsonTrue;
-	JsonAppend(list, value);
-	free(value);
-}
-
-void JsonAppendFalse(JsonList* list) {
-	JsonValue* value = JsonFalse;
-	JsonAppend(list, value);
-	free(value);
-}
-
-void JsonAppendNull(JsonList* list) {
-	JsonValue* value = JsonNull;
-	JsonAppend(list, value);
-	free(value);
-}
-
-void JsonAppendList(JsonList* list, JsonList* list2) {
-	if (list == list2) {
-		JsonList* copy = JsonListCopy(list);
-		JsonValue* value = JsonValueInit(copy, JSON_LIST);
-		JsonValueArrayAppend(list, *value);
-	}
-	else {
-		JsonValue* value = JsonValueInit(list2, JSON_LIST);
-		JsonValueArrayAppend(list, *value);
-	}
-}
-
-void JsonAppendExpr(JsonList* list, JsonExpr* expr) {
-	JsonValue* value = JsonValueInit(expr, JSON_EXPR);
-	JsonValueArrayAppend(list, *value);
-}
-
-void JsonAddRange(JsonList* list, JsonList* list2, int reuse_list) {
-	for (ullong i = 0; i < list2->Length; i++) {
-		JsonValue* value = &list2->Buffer[i];
-		JsonValue* copy = JsonValueCopy(value);
-
-		JsonValueArrayAppend(list, *copy);
-		free(copy);
-	}
-
-	if (!reuse_list) {
-		JsonListDelete(list2);
-	}
-}
-
-int JsonRemoveElement(JsonList* list, ullong index) {
-	if (index > list->Length || index < 0) {
-		return FAILURE;
-	}
-
-	JsonDataDelete(&list->Buffer[index]);
-	JsonValueArrayRemove(list, index);
-	return SUCCESS;
-}
-
-/*
-	Modifying Expr
-
-	FUNCTIONS:
-
-	> JsonSet()
-	Adds a JsonValue to a JsonExpr with a key to index it
-	If the key exists then it will delete the previous value and override it
-	Used for when you want a key to equal a value
-
-	> JsonSetString()
-	Creates a JsonValue from a JsonString and adds it to a JsonExpr with a key to index it
-	Used for when you want to add a string to a JsonExpr
-
-	> JsonSetInt()
-	Creates a JsonValue from a JsonInt and adds it to a JsonExpr with a key to index it
-	Used for when you want to add an int to a JsonExpr
-
-	> JsonSetFloat()
-	Creates a JsonValue from a JsonFloat and adds it to a JsonExpr with a key to index it
-	Used for when you want to add a float to a JsonExpr
-
-	> JsonSetTrue()
-	Creates a JsonValue which equals JSON_TRUE (true keyword) and adds it to a JsonExpr with a key to index it
-	Used for when you want to set the value of a key to true in a JsonExpr
-
-	> JsonSetFalse()
-	Creates a JsonValue which equals JSON_FALSE (false keyword) and adds it to a JsonExpr with a key to index it
-	Used for when you want to set the value of a key to false in a JsonExpr
-
-	> JsonSetNull()
-	Creates a JsonValue which equals JSON_NULL (null keyword) and adds it to a JsonExpr with a key to index it
-	Used for when you want to set the value of a key to null in a JsonExpr
-
-	> JsonSetList()
-	Adds a JsonList to a JsonExpr with a key to index it
-	If the key exists it will delete the previous value and override it
-
-	> JsonSetExpr()
-	Adds a JsonExpr to a JsonExpr with a key to index it
-	If the key exists it will delete the previous value to override it
-	If you are adding a JsonExpr to itself a copy will be made of the JsonExpr to avoid errors, this may result
-	in a very small memory leak as the memory deallocator has lost a reference to the data. This can be fixed by
-	manually freeing the list. 
-
-	> JsonMerge()
-	Adds the pairs of a JsonExpr to another
-	Used for combining two JsonExprs
-	If argument "reuse_expr" is correct then the function will delete the JsonExpr which is being copied from. 
-	example: {"animal": "Polar Bear"} MERGED WITH {"location": "Snowy Areas"} IS {"animal": "PolarBear", "location": "Snowy Areas"}
-
-	> JsonRemoveKey()
-	Removes a pair in a JsonExpr with the key it is associated with
-	Will return a failure if the key is not in the JsonExpr
-*/
-
-void JsonSet(JsonExpr* expr, const char* key, JsonValue* value) {
-	ullong index = JsonGetPairIndex(expr, key);
-
-	if (index == PAIR_INDEX_NOT_FOUND) {
-		JsonPair* pair = JsonPairInit(AllocJsonString(key), value);
-		JsonPairArrayAppend(expr, *pair);
-		free(pair);
-	}
-	else {
-		JsonValueDelete(expr->Buffer[index].Value);
-		expr->Buffer[index].Value = value;
-	}
-}
-
-void JsonSetString(JsonExpr* expr, const char* key, JsonString* string) {
-	JsonValue* value = JsonCreateString(string);
-	JsonSet(expr, key, value);
-}
-
-void JsonSetInt(JsonExpr* expr, const char* key, JsonInt integer) {
-	JsonValue* value = JsonCreateInt(integer);
-	JsonSet(expr, key, value);
-}
-
-void JsonSetFloat(JsonExpr* expr, const char* key, JsonFloat flt) {
-	JsonValue* value = JsonCreateFloat(flt);
-	JsonSet(expr, key, value);
-}
-
-void JsonSetTrue(JsonExpr* expr, const char* key) {
-	JsonSet(expr, key, JsonTrue);
-}
-
-void JsonSetFalse(JsonExpr* expr, const char* key) {
-	JsonSet(expr, key, JsonFalse);
-}
-
-void JsonSetNull(JsonExpr* expr, const char* key) {
-	JsonSet(expr, key, JsonNull);
-}
-
-void JsonSetList(JsonExpr* expr, const char* key, JsonList* list) {
-	ullong index = JsonGetPairIndex(expr, key);
-
-	if (index == PAIR_INDEX_NOT_FOUND) {
-		JsonString* _key = AllocJsonString(key);
-		JsonValue* value = JsonValueInit(list, JSON_LIST);
-		JsonPair* pair = JsonPairInit(_key, value);
-
-		JsonPairArrayAppend(expr, *pair);
-		free(pair);
-	}
-	else {
-		JsonValueDelete(expr->Buffer[index].Value);
-		expr->Buffer[index].Value->Data->List = list;
-	}
-}
-
-void JsonSetExpr(JsonExpr* expr, const char* key, JsonExpr* expr2) {
-	ullong index = JsonGetPairIndex(expr, key);
-
-	if (index == PAIR_INDEX_NOT_FOUND) {
-		JsonString* _key = AllocJsonString(key);
-		JsonPair* pair;
-		
-		if (expr == expr2) {
-			JsonExpr* copy = JsonExprCopy(expr2);
-			JsonValue* value = JsonValueInit(copy, JSON_EXPR);
-			pair = JsonPairInit(_key, value);
-		}
-		else {
-			JsonValue* value = JsonValueInit(expr2, JSON_EXPR);
-			pair = JsonPairInit(_key, value);
-		}
-		
-		JsonPairArrayAppend(expr, *pair);
-		free(pair);
-	}
-	else {
-		JsonValueDelete(expr->Buffer[index].Value);
-		expr->Buffer[index].Value->Data->Expr = expr2;
-	}
-}
-
-void JsonMerge(JsonExpr* expr, JsonExpr* expr2, int reuse_expr) {
-	for (ullong i = 0; i < expr2->Length; i++) {
-		JsonPair* pair = &expr2->Buffer[i];
-		JsonPair* copy = JsonPairCopy(pair);
-
-		JsonPairArrayAppend(expr, *copy);
-		free(copy);
-	}
-
-	if (!reuse_expr) {
-		JsonExprDelete(expr2);
-	}
-}
-
-int JsonRemoveKey(JsonExpr* expr, const char* key) {
-	ullong index = JsonGetPairIndex(expr, key);
-
-	if (index == PAIR_INDEX_NOT_FOUND) {
-		return FAILURE;
-	}
-
-	JsonPairDelete(&expr->Buffer[index]);
-	JsonPairArrayRemove(expr, index);
-	return SUCCESS;
-}
+
+#include <stdlib.h>
+#include <string.h>
+#include "include/json-parser.h"
+#include "include/lexer.h"
+#include "include/parser.h"
+#include "include/serialisation.h"
+#include "include/file-io.h"
+#include "include/shapes.h"
+#include "include/hashing.h"
+
+#define JSON_DUMP_BUFFER_SIZE (256 * 1024)
+#define JSON_HASH_BUFFER_SIZE (16 * 1024)
+
+#define CompareStrings(str1, str2) ((str1) == (str2) || strcmp(str1, str2) == 0)
+
+/*
+	Loading Json Data
+
+	FUNCTIONS:
+
+	> JsonLoadString()
+	Creates a JsonExpr object from a raw JSON string using a parsing algorithm
+	Creates an error in the handler if there is an error in the string
+
+	> JsonLoadFile()
+	Creates a JsonExpr object from a json file using a parsing algorithm
+	Creates an error in the handler if the contents of the file are invalid
+
+	> JsonLoadColumns()
+	Extracts typed columns from a raw JSON string whose top level is a list of exprs (see JsonTokensToColumns())
+	without building a JsonList. Creates an error in the handler if there is an error in the string
+
+	> JsonDumpString()
+	Dumps a JsonExpr object to a string
+	String that is returns should be freed by the function caller
+
+	> JsonDumpStringEx()
+	Dumps a JsonExpr object to a string formatted as the JsonDumpOptions say: compact, pretty printed with an indent
+	and/or with sorted keys, or in canonical form (see JsonDumpOptions). NULL options give the same string as
+	JsonDumpString()
+	String that is returns should be freed by the function caller
+
+	> JsonDumpStringParallel()
+	Same as JsonDumpStringEx() but the JsonExpr is serialised on 'threads' threads, or one per processor when
+	'threads' is 0 (see SerialiseJsonExprParts()). The string is the same as the one JsonDumpStringEx() returns.
+	The calling thread's allocator is used from every thread, so it has to be thread safe
+
+	> JsonSerializedSize()
+	Returns the exact number of chars JsonDumpString() would write for a JsonExpr object (not counting the null
+	terminator) without writing them, e.g., to allocate a buffer once or to send a Content-Length before streaming
+
+	> JsonSerializedSizeEx()
+	Returns the exact number of chars JsonDumpStringEx() would write for a JsonExpr object and the same options
+
+	> JsonCanonicalHash()
+	Returns the XXH64 hash (with the given seed) of a JsonExpr object's canonical form (see JsonDumpOptions.Canonical),
+	e.g., to use as a cache key. The canonical form is streamed into the hash through a buffer of
+	JSON_HASH_BUFFER_SIZE chars, so it is never held in memory as a whole. Equal documents hash the same no matter
+	the order their keys were stored in or how their numbers were written
+
+	> JsonDumpFile()
+	Dumps a JsonExpr object to a json file
+	Creates an error in the JsonHandler if it failed to write to the file
+
+	> JsonDumpFileParallel()
+	Dumps a JsonExpr object to a json file, serialised on 'threads' threads (see JsonDumpStringParallel()). The
+	parts every thread wrote are passed to the file as they are with writev() instead of being joined first
+	Creates an error in the JsonHandler if it failed to write to the file
+
+	> JsonDumpStream()
+	Dumps a JsonExpr object to an open FILE*, which is left open
+	Creates an error in the JsonHandler if it failed to write to the stream
+
+	> JsonDumpFd()
+	Dumps a JsonExpr object to an open file descriptor (e.g., a pipe or socket), which is left open
+	Creates an error in the JsonHandler if it failed to write to the file descriptor
+
+	> DumpSink()
+	Streams a JsonExpr object formatted as the JsonDumpOptions say to a sink through a buffer of 'capacity' chars
+	(see StringBuilderInitSink()). Returns FAILURE if the sink failed
+
+	> JsonDumpArrow()
+	Dumps the given keys of a list of JsonExprs to an Apache Arrow IPC file (Feather v2), one column per key
+	(see JsonListToColumns() and ArrowWriteFile())
+	Creates an error in the JsonHandler if it failed to write to the file
+
+	> UseHandlerAllocator()
+	Selects the handler's allocator on the calling thread (if it has one) and returns the allocator which was in use
+	before, so that it can be restored with JsonSelectAllocator() once the function is done. Everything loaded
+	keeps the handler's allocator after the function returns (see JsonValueArray.Allocator)
+
+	> FreeTokens()
+	Frees the values of the Tokens in a TokenArray and the TokenArray itself
+
+	MACROS:
+
+	> JSON_DUMP_BUFFER_SIZE
+	Size of the buffer JsonDumpFile(), JsonDumpStream() and JsonDumpFd() serialise into before passing it on. Dumping
+	needs this much memory no matter how big the document is
+
+	> JSON_HASH_BUFFER_SIZE
+	Size of the buffer JsonCanonicalHash() serialises into, small enough that the chars are still in the CPU's cache
+	when they are hashed
+
+	NOTES:
+
+	Every function which takes a JsonHandler makes all of its allocations with the handler's allocator. The public
+	functions only switch allocators, the work is done by the static functions of the same name
+	
+	WARNING:
+
+	Attempting to work with a JsonExpr object return from JsonLoadString() or JsonLoadFile()
+	may result in a runtime error as the behaviour is undefined. Errors should be checked for
+	in the handler after calling this function. If there is no error then it is safe to proceed
+*/
+
+static JsonAllocator* UseHandlerAllocator(JsonHandler* handler) {
+	return handler->Allocator != NULL
+		? JsonSelectAllocator(handler->Allocator)
+		: JsonGetAllocator();
+}
+
+static void FreeTokens(TokenArray* tokens) {
+	for (ullong i = 0; i < tokens->Length; i++) {
+		Token* token = &tokens->Buffer[i];
+
+		switch (token->Type) {
+			case TOKEN_STRING:
+			case TOKEN_INT:
+			case TOKEN_FLOAT:
+				JsonFree((char*)token->Value);
+				break;
+		}
+	}
+
+	TokenArrayDelete(tokens);
+}
+
+static JsonExpr* LoadString(JsonHandler* handler, const char* source) {
+	// Lexer
+
+	Lexer* lexer = LexerInit(source);
+	TokenArray* tokens = LexerGetResult(lexer);
+
+	if (lexer->Error->Exists) {
+		handler->Error = lexer->Error;
+		
+		// Free Lexer Memory
+
+		TokenArrayDelete(tokens);
+		JsonFree(lexer);
+
+		return;
+	}
+
+	// Parser
+
+	Parser* parser = ParserInit(tokens);
+	parser->Presize = handler->PresizeContainers;
+	parser->Pack = handler->PackNumericLists;
+	parser->Share = handler->ShareShapes;
+	parser->Intern = handler->InternStrings || handler->Strings != NULL;
+	parser->Strings = handler->Strings;
+	JsonExpr* expr = ParserGetResult(parser);
+
+	if (parser->Error->Exists) {
+		handler->Error = parser->Error;
+		
+		// Free Lexer & Parser Memory
+
+		TokenArrayDelete(tokens);
+		JsonFree(lexer);
+		JsonFree(parser);
+
+		return;
+	}
+
+	// Free All Memory
+
+	ErrorDelete(lexer->Error);
+	ErrorDelete(parser->Error);
+	FreeTokens(tokens);
+	JsonFree(lexer);
+	JsonFree(parser);
+
+	return expr;
+}
+
+static JsonExpr* LoadFile(JsonHandler* handler, const char* path) {
+	char* source;
+	Error* error = FileReadAllText(path, &source);
+
+	if (error->Exists) {
+		handler->Error = error;
+		return;
+	}
+
+	JsonExpr* expr = LoadString(handler, source);
+	ErrorDelete(error);
+	JsonFree(source);
+	return expr;
+}
+
+static JsonColumns* LoadColumns(JsonHandler* handler, const char* source, const char** keys, ullong count) {
+	// Lexer
+
+	Lexer* lexer = LexerInit(source);
+	TokenArray* tokens = LexerGetResult(lexer);
+
+	if (lexer->Error->Exists) {
+		handler->Error = lexer->Error;
+		TokenArrayDelete(tokens);
+		JsonFree(lexer);
+
+		return NULL;
+	}
+
+	// Columns
+
+	Error* error = ErrorInit();
+	JsonColumns* columns = JsonTokensToColumns(tokens, keys, count, error);
+
+	if (error->Exists) {
+		handler->Error = error;
+	}
+	else {
+		ErrorDelete(error);
+	}
+
+	// Free All Memory
+
+	ErrorDelete(lexer->Error);
+	FreeTokens(tokens);
+	JsonFree(lexer);
+
+	return columns;
+}
+
+static int DumpSink(JsonExpr* expr, const JsonDumpOptions* options, ullong capacity, StringBuilderSink sink, void* data) {
+	StringBuilder* builder = StringBuilderInitSink(sink, data, capacity);
+	SerialiseJsonExprTo(builder, expr, options);
+
+	int result = StringBuilderFlush(builder);
+	StringBuilderDelete(builder);
+
+	return result;
+}
+
+static void DumpFile(JsonHandler* handler, JsonExpr* expr, const char* path) {
+	FILE* file = fopen(path, "w");
+
+	if (file == NULL) {
+		CREATE_ERROR(ERR_ACCESS_PATH_FAILURE, path);
+		handler->Error = error;
+		return;
+	}
+
+	int result = DumpSink(expr, NULL, JSON_DUMP_BUFFER_SIZE, FileWriteSink, file);
+
+	if (fclose(file) != 0 || result == FAILURE) {
+		CREATE_ERROR(ERR_ACCESS_PATH_FAILURE, path);
+		handler->Error = error;
+	}
+}
+
+static void DumpFileParallel(JsonHandler* handler, JsonExpr* expr, const JsonDumpOptions* options, int threads, const char* path) {
+	SerialisedParts* parts = SerialiseJsonExprParts(expr, options, threads);
+	Error* error = FileWriteVector(path, (const char**)parts->Buffers, parts->Lengths, parts->Count);
+	SerialisedPartsDelete(parts);
+
+	if (error->Exists) {
+		handler->Error = error;
+		return;
+	}
+
+	ErrorDelete(error);
+}
+
+static void DumpStream(JsonHandler* handler, JsonExpr* expr, StringBuilderSink sink, void* data) {
+	if (DumpSink(expr, NULL, JSON_DUMP_BUFFER_SIZE, sink, data) == FAILURE) {
+		CREATE_ERROR(ERR_WRITE_FAILURE);
+		handler->Error = error;
+	}
+}
+
+static void DumpArrow(JsonHandler* handler, JsonList* list, const char** keys, ullong count, const char* path) {
+	JsonColumns* columns = JsonListToColumns(list, keys, count);
+	Error* error = ArrowWriteFile(columns, path);
+	JsonColumnsDelete(columns);
+
+	if (error->Exists) {
+		handler->Error = error;
+		return;
+	}
+
+	ErrorDelete(error);
+}
+
+JsonExpr* JsonLoadString(JsonHandler* handler, const char* source) {
+	JsonAllocator* previous = UseHandlerAllocator(handler);
+	JsonExpr* expr = LoadString(handler, source);
+	JsonSelectAllocator(previous);
+
+	return expr;
+}
+
+JsonExpr* JsonLoadFile(JsonHandler* handler, const char* path) {
+	JsonAllocator* previous = UseHandlerAllocator(handler);
+	JsonExpr* expr = LoadFile(handler, path);
+	JsonSelectAllocator(previous);
+
+	return expr;
+}
+
+JsonColumns* JsonLoadColumns(JsonHandler* handler, const char* source, const char** keys, ullong count) {
+	JsonAllocator* previous = UseHandlerAllocator(handler);
+	JsonColumns* columns = LoadColumns(handler, source, keys, count);
+	JsonSelectAllocator(previous);
+
+	return columns;
+}
+
+void JsonDumpString(JsonExpr* expr, const char** dest) {
+	*dest = SerialiseJsonExpr(expr);
+}
+
+void JsonDumpStringEx(JsonExpr* expr, const JsonDumpOptions* options, const char** dest) {
+	*dest = SerialiseJsonExprEx(expr, options);
+}
+
+void JsonDumpStringParallel(JsonExpr* expr, const JsonDumpOptions* options, int threads, const char** dest) {
+	*dest = SerialiseJsonExprParallel(expr, options, threads);
+}
+
+ullong JsonSerializedSize(JsonExpr* expr) {
+	return SerialisedJsonExprSize(expr, NULL);
+}
+
+ullong JsonSerializedSizeEx(JsonExpr* expr, const JsonDumpOptions* options) {
+	return SerialisedJsonExprSize(expr, options);
+}
+
+ullong JsonCanonicalHash(JsonExpr* expr, ullong seed) {
+	JsonDumpOptions options = { 0 };
+	options.Canonical = TRUE;
+
+	Hasher* hasher = HasherInit(seed);
+	DumpSink(expr, &options, JSON_HASH_BUFFER_SIZE, HasherSink, hasher);
+
+	ullong hash = HasherDigest(hasher);
+	HasherDelete(hasher);
+
+	return hash;
+}
+
+void JsonDumpFile(JsonHandler* handler, JsonExpr* expr, const char* path) {
+	JsonAllocator* previous = UseHandlerAllocator(handler);
+	DumpFile(handler, expr, path);
+	JsonSelectAllocator(previous);
+}
+
+void JsonDumpFileParallel(JsonHandler* handler, JsonExpr* expr, const JsonDumpOptions* options, int threads, const char* path) {
+	JsonAllocator* previous = UseHandlerAllocator(handler);
+	DumpFileParallel(handler, expr, options, threads, path);
+	JsonSelectAllocator(previous);
+}
+
+void JsonDumpStream(JsonHandler* handler, JsonExpr* expr, FILE* file) {
+	JsonAllocator* previous = UseHandlerAllocator(handler);
+	DumpStream(handler, expr, FileWriteSink, file);
+	JsonSelectAllocator(previous);
+}
+
+void JsonDumpFd(JsonHandler* handler, JsonExpr* expr, int fd) {
+	JsonAllocator* previous = UseHandlerAllocator(handler);
+	DumpStream(handler, expr, FdWriteSink, FileDescriptorData(fd));
+	JsonSelectAllocator(previous);
+}
+
+void JsonDumpArrow(JsonHandler* handler, JsonList* list, const char** keys, ullong count, const char* path) {
+	JsonAllocator* previous = UseHandlerAllocator(handler);
+	DumpArrow(handler, list, keys, count, path);
+	JsonSelectAllocator(previous);
+}
+
+/*
+	Creating Values
+
+	FUNCTIONS:
+
+	> JsonCreateString()
+	Creates a JsonValue object which stores a JsonString inside of it
+
+	> JsonCreateInt()
+	Creates a JsonValue object which stores a JsonInt inside of it
+
+	> JsonCreateFloat()
+	Creates a JsonValue object which stores a JsonFloat inside of it
+
+	> JsonCreateKeyword()
+	Creates a JsonValue which stores a keyword inside of it (true, false or null)
+*/
+
+JsonValue* JsonCreateString(JsonString string) {
+	JsonValue* value = JsonPoolCalloc(sizeof(JsonValue));
+	value->Data = JsonPoolCalloc(sizeof(JsonData));
+	value->Data->String = AllocJsonString(string);
+	value->Type = JSON_STRING;
+
+	return value;
+}
+
+JsonValue* JsonCreateInt(JsonInt integer) {
+	JsonValue* value = JsonPoolCalloc(sizeof(JsonValue));
+	value->Data = JsonPoolCalloc(sizeof(JsonData));
+	value->Data->Int = AllocJsonInt(integer);
+	value->Type = JSON_INT;
+
+	return value;
+}
+
+JsonValue* JsonCreateFloat(JsonFloat flt) {
+	JsonValue* value = JsonPoolCalloc(sizeof(JsonValue));
+	value->Data = JsonPoolCalloc(sizeof(JsonData));
+	value->Data->Float = AllocJsonFloat(flt);
+	value->Type = JSON_FLOAT;
+
+	return value;
+}
+
+JsonValue* JsonCreateKeyword(JsonType keyword) {
+	JsonValue* value = JsonPoolCalloc(sizeof(JsonValue));
+	value->Type = keyword;
+
+	return value;
+}
+
+/*
+	Accessing Data
+
+	MACROS:
+
+	> COMPARE_KEYS()
+	Compares two keys to see if they match (technically its just a shorthand for string comparison)
+
+	> PAIR_INDEX_NOT_FOUND
+	The index of a key in a JsonExpr was not found (the JsonExpr object does not contain this key)
+
+	> SUCCESS
+	An operation was successfuly
+
+	> FAILURE
+	An operation failed
+
+	FUNCTIONS:
+
+	> JsonGetPairIndex()
+	Returns the index of a key in a JsonExpr
+	Returns PAIR_INDEX_NOT_FOUND if the key does not exist
+
+	> JsonGetPairIndexHashed()
+	Returns the index of a key in a JsonExpr using a key length and hash computed by the caller (see JsonHashKey())
+	Pairs with a different hash or length are skipped without comparing any characters
+	A JsonExpr which uses a shape is looked up through the shape's keys (see JsonShapeGetSlot())
+	Returns PAIR_INDEX_NOT_FOUND if the key does not exist
+
+	> JsonKeyExists()
+	Returns 1 if a key exists in a JsonExpr
+	Returns 0 if the key does not exist
+
+	> JsonGetValue()
+
+	Gets the value which belongs to a key in a JsonExpr object
+	Returns SUCCESS if the value was found
+	Returns FAILURE if the value was not found
+
+	> JsonGetValueHashed()
+	Same as JsonGetValue() but uses a key length and hash computed by the caller (see JsonHashKey())
+	Used in hot paths where the same key is looked up many times, so the key is only hashed once
+
+	> JsonGetList()
+	Gets the JsonList which belongs to a key in a JsonExpr
+	Returns SUCCESS if a JsonList was found
+	Returns FAILURE if the value was not found or if the value type is not JSON_LIST
+
+	> JsonGetExpr()
+	Gets the JsonExpr which belongs to a key in a JsonExpr
+	Returns SUCCESS if a JsonExpr was found
+	Returns FAILURE if the value was not found or if the value type is not JSON_EXPR
+
+	> JsonGetPackedInts()
+	Gets the packed JsonInt array of a JsonList (see JsonListPack()), which holds list->Length elements
+	Returns FAILURE if the JsonList is not packed as JSON_PACKED_INT
+
+	> JsonGetPackedFloats()
+	Gets the packed JsonFloat array of a JsonList (see JsonListPack()), which holds list->Length elements
+	Returns FAILURE if the JsonList is not packed as JSON_PACKED_FLOAT
+
+	WARNING:
+	Attempting to work with a value assigned by JsonGetValue(), JsonGetList() or JsonGetExpr()
+	without checking for an error may result in a runtime error as the behaviour is undefined.
+	You should check that the return values from these functions is 1 and not 0 before using the value
+
+	NOTE:
+
+	These functions only read, they never give a JsonExpr which shares its buffer with a copy its own buffer. A
+	JsonList or JsonExpr they hand out is never shared (see JsonExprCopy()) and can be edited with the functions
+	below, which detach a shared buffer first. A JsonValue or packed array they hand out may be shared with a copy,
+	so numbers and strings should be changed with JsonSet* rather than written through it
+*/
+
+#define PAIR_INDEX_NOT_FOUND -1
+#define SUCCESS 1
+#define FAILURE 0
+
+ullong JsonGetPairIndex(JsonExpr* expr, const char* key) {
+	ullong length = strlen(key);
+	return JsonGetPairIndexHashed(expr, key, length, JsonHashKey(key, length));
+}
+
+ullong JsonGetPairIndexHashed(JsonExpr* expr, const char* key, ullong length, ullong hash) {
+	if (expr->Shape != NULL) {
+		return JsonShapeGetSlot(expr->Shape, key, length, hash);
+	}
+
+	for (ullong i = 0; i < expr->Length; i++) {
+		JsonPair* pair = &expr->Buffer[i];
+
+		if (pair->KeyHash == hash && pair->KeyLength == length && memcmp(pair->Key, key, length) == 0) {
+			return i;
+		}
+	}
+
+	return PAIR_INDEX_NOT_FOUND;
+}
+
+ullong JsonKeyExists(JsonExpr* expr, const char* key) {
+	return JsonGetPairIndex(expr, key) != PAIR_INDEX_NOT_FOUND;
+}
+
+int JsonGetValue(JsonExpr* expr, const char* key, JsonValue** value) {
+	ullong length = strlen(key);
+	return JsonGetValueHashed(expr, key, length, JsonHashKey(key, length), value);
+}
+
+int JsonGetValueHashed(JsonExpr* expr, const char* key, ullong length, ullong hash, JsonValue** value) {
+	ullong index = JsonGetPairIndexHashed(expr, key, length, hash);
+
+	if (index == PAIR_INDEX_NOT_FOUND) {
+		return FAILURE;
+	}
+
+	*value = expr->Buffer[index].Value;
+	return SUCCESS;
+}
+
+int JsonGetList(JsonExpr* expr, const char* key, JsonList** list) {
+	JsonValue* value;
+
+	if (JsonGetValue(expr, key, &value)) {
+		if (value->Type != JSON_LIST) {
+			return FAILURE;
+		}
+
+		*list = value->Data->List;
+		return SUCCESS;
+	}
+	
+	return FAILURE;
+}
+
+int JsonGetExpr(JsonExpr* expr, const char* key, JsonExpr** expr2) {
+	JsonValue* value;
+
+	if (JsonGetValue(expr, key, &value)) {
+		if (value->Type != JSON_EXPR) {
+			return FAILURE;
+		}
+
+		*expr2 = value->Data->Expr;
+		return SUCCESS;
+	}
+
+	return FAILURE;
+}
+
+int JsonGetPackedInts(JsonList* list, JsonInt** ints) {
+	if (list->Packing != JSON_PACKED_INT) {
+		return FAILURE;
+	}
+
+	*ints = list->Numbers;
+	return SUCCESS;
+}
+
+int JsonGetPackedFloats(JsonList* list, JsonFloat** floats) {
+	if (list->Packing != JSON_PACKED_FLOAT) {
+		return FAILURE;
+	}
+
+	*floats = list->Numbers;
+	return SUCCESS;
+}
+
+/*
+	Comparing Data
+
+	MACROS:
+
+	> CompareValueExprs()
+	Compares two JsonValues which are both JsonExprs
+
+	> CompareValueLists()
+	Compares two JsonValues which are both JsonLists
+
+	> CompareValueString()
+	Compares two JsonValues which are both JsonStrings
+
+	> CompareValueInt()
+	Compares two JsonValues which are both JsonInts
+
+	> CompareValueFloat()
+	Compares two JsonValues which are both JsonFloats
+
+	FUNCTIONS:
+
+	> ViewElement()
+	Gets the element of a JsonList at an index as a JsonValue. Elements of a packed JsonList are wrapped in the
+	ElementView passed in, so nothing is allocated and the JsonValue is only valid as long as the ElementView
+
+	> JsonCompareValues()
+	Compares two JsonValues together
+	If both JsonValues point to the same JsonValue struct in memory then they are automatically the same
+	If they both share the same datatype it will compare the JsonData inside of each JsonValue
+
+	> JsonComparePairs()
+	Compares two JsonPairs together
+	If both JsonPairs point to the same JsonPair struct in memory then they are autoamtically the same
+	Keys with a different hash or length are rejected before any characters are compared
+	If the keys both match then it will call JsonCompareValues on both of the values
+
+	> JsonCompareLists()
+	Compares two JsonLists together
+	If both JsonLists point to the same JsonList struct or share the same buffer then they are automatically the same
+	If both JsonLists do not share the same length then they cannot be the same
+	If every JsonValue in both of the JsonLists match at the same index then they are identical
+	A packed JsonList compares equal to an unpacked JsonList holding the same numbers
+
+	> JsonCompareExprs()
+	Compares two JsonExprs together
+	If both JsonExprs point to the same JsonExpr struct or share the same buffer then they are automatically the same
+	If both JsonExprs do not share the same length then they cannot be the same
+	If both JsonExprs use the same shape then their values are compared index by index
+	
+	NOTE:
+
+	Unlike JsonCompareLists(), JsonCompareExprs() does not require the values to match at the same index.
+	For example: {"name": "John", "age": 30} and {"age": 30, "name": "John"} would still be seen as equal.
+	This does not apply in a JsonList as it is indexed by integers not keys
+*/
+
+#define CompareValueExprs(value1, value2)							\
+	JsonCompareExprs(value1->Data->Expr, value2->Data->Expr)
+
+#define CompareValueLists(value1, value2)							\
+	JsonCompareLists(value1->Data->List, value2->Data->List)
+
+#define CompareValueString(value1, value2)							\
+	CompareStrings(value1->Data->String, value2->Data->String)
+
+#define CompareValueInt(value1, value2)								\
+	*value1->Data->Int == *value2->Data->Int
+
+#define CompareValueFloat(value1, value2)							\
+	*value1->Data->Float == *value2->Data->Float
+
+typedef struct {
+	JsonValue Value;
+	JsonData Data;
+} ElementView;
+
+static JsonValue* ViewElement(JsonList* list, ullong index, ElementView* view) {
+	switch (list->Packing) {
+		case JSON_PACKED_INT:
+			view->Value.Type = JSON_INT;
+			view->Data.Int = &((JsonInt*)list->Numbers)[index];
+			break;
+		case JSON_PACKED_FLOAT:
+			view->Value.Type = JSON_FLOAT;
+			view->Data.Float = &((JsonFloat*)list->Numbers)[index];
+			break;
+		default:
+			return &list->Buffer[index];
+	}
+
+	view->Value.Data = &view->Data;
+	return &view->Value;
+}
+
+#define TRUE 1
+#define FALSE 0
+
+int JsonCompareValues(JsonValue* value1, JsonValue* value2) {
+	if (value1 == value2) {
+		return TRUE;
+	}
+
+	switch (value1->Type) {
+		case JSON_EXPR:
+			return value2->Type == JSON_EXPR
+				? CompareValueExprs(value1, value2)
+				: FALSE;
+		case JSON_LIST:
+			return value2->Type == JSON_LIST
+				? CompareValueLists(value1, value2)
+				: FALSE;
+		case JSON_STRING:
+			return value2->Type == JSON_STRING
+				? CompareValueString(value1, value2)
+				: FALSE;
+		case JSON_INT:
+			return value2->Type == JSON_INT
+				? CompareValueInt(value1, value2)
+				: FALSE;
+		case JSON_FLOAT:
+			return value2->Type == JSON_FLOAT
+				? CompareValueFloat(value1, value2)
+				: FALSE;
+		case JSON_TRUE:
+		case JSON_FALSE:
+		case JSON_NULL:
+			return value1->Type == value2->Type;
+	}
+}
+
+int JsonComparePairs(JsonPair* pair1, JsonPair* pair2) {
+	if (pair1 == pair2) {
+		return TRUE;
+	}
+	
+	if (pair1->KeyHash != pair2->KeyHash || pair1->KeyLength != pair2->KeyLength) {
+		return FALSE;
+	}
+
+	if (!CompareStrings(pair1->Key, pair2->Key)) {
+		return FALSE;
+	}
+
+	return JsonCompareValues(pair1->Value, pair2->Value);
+}
+
+int JsonCompareLists(JsonList* list1, JsonList* list2) {
+	if (list1 == list2 || (
+		list1->Buffer == list2->Buffer &&
+		list1->Numbers == list2->Numbers &&
+		list1->Length == list2->Length
+	)) {
+		return TRUE;
+	}
+
+	if (list1->Length != list2->Length) {
+		return FALSE;
+	}
+
+	if (list1->Packing == JSON_PACKED_INT && list2->Packing == JSON_PACKED_INT) {
+		JsonInt* ints1 = list1->Numbers;
+		JsonInt* ints2 = list2->Numbers;
+
+		for (ullong i = 0; i < list1->Length; i++) {
+			if (ints1[i] != ints2[i]) {
+				return FALSE;
+			}
+		}
+
+		return TRUE;
+	}
+
+	for (ullong i = 0; i < list1->Length; i++) {
+		ElementView view1, view2;
+		JsonValue* value1 = ViewElement(list1, i, &view1);
+		JsonValue* value2 = ViewElement(list2, i, &view2);
+
+		if (!JsonCompareValues(value1, value2)) {
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+int JsonCompareExprs(JsonExpr* expr1, JsonExpr* expr2) {
+	if (expr1 == expr2 || (expr1->Buffer == expr2->Buffer && expr1->Length == expr2->Length)) {
+		return TRUE;
+	}
+
+	if (expr1->Length != expr2->Length) {
+		return FALSE;
+	}
+
+	if (expr1->Shape != NULL && expr1->Shape == expr2->Shape) {
+		for (ullong i = 0; i < expr1->Length; i++) {
+			if (!JsonCompareValues(expr1->Buffer[i].Value, expr2->Buffer[i].Value)) {
+				return FALSE;
+			}
+		}
+
+		return TRUE;
+	}
+
+	for (ullong i = 0; i < expr1->Length; i++) {
+		JsonPair* pair1 = &expr1->Buffer[i];
+		ullong index = JsonGetPairIndexHashed(expr2, pair1->Key, pair1->KeyLength, pair1->KeyHash);
+
+		if (index != (ullong)PAIR_INDEX_NOT_FOUND) {
+			if (!JsonCompareValues(pair1->Value, expr2->Buffer[index].Value)) {
+				return FALSE;
+			}
+		}
+		else {
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/*
+	Modifying List
+
+	FUNCTIONS:
+
+	> JsonAppend()
+	Adds a JsonValue to a JsonList
+	Used for when you want to append a JsonValue to a JsonList
+
+	> JsonAppendString()
+	Creates a JsonValue from a JsonString and adds it to a JsonList
+	Used for when you want to append a string to a JsonList
+
+	> JsonAppendInt()
+	Creates a JsonValue from a JsonInt and adds it to a JsonList
+	Used for when you want to append an int to a JsonList
+
+	> JsonAppendFloat()
+	Creates a JsonValue from a JsonFloat and adds it to a JsonList
+	Used for when you want to append a float to a JsonList
+
+	> JsonAppendTrue
+	Creates a JsonValue which equals JSON_TRUE (true keyword)
+	Used for when you want to add true to a JsonList
+
+	> JsonAppendFalse
+	Creates a JsonValue which equals JSON_FALSE (false keyword)
+	Used for when you want to add false to a JsonList
+
+	> JsonAppendNull
+	Creates a JsonValue which equals JSON_NULL (null keyword)
+	Used for when you want to add null to a JsonList
+
+	> JsonAppendList()
+	Appends a JsonList to a JsonList
+	If you are adding a JsonList to itself a copy will be made of the JsonExpr to avoid errors, this may result in
+	a very small memory leak as the memory deallocator has lost a reference to the data. This can be fixed
+	by manually freeing the list
+	
+	> JsonAppendExpr()
+	Appends a JsonExpr to a JsonList
+	
+	> JsonAddRange()
+	Adds the values of a JsonList to another
+	Used for combining two JsonLists
+	example: [1, 2, 3] MERGED WITH [4, 5, 6] IS [1, 2, 3, 4, 5, 6]
+	Will delete the second list if argument 'reuse_list' is true
+
+	> JsonRemoveElement()
+	Removes an element in a JsonList at a specific index. Indexes are always 0 based. 
+	Will return a failure if the index is out of bounds
+
+	> JsonSwapRemoveElement()
+	Removes an element in a JsonList at a specific index by moving the last element into its place
+	Faster than JsonRemoveElement() for large lists but does not keep the order of the elements
+	Will return a failure if the index is out of bounds
+
+	> JsonRemoveRange()
+	Removes 'count' elements from a JsonList starting at a specific index in one pass
+	Used for popping a batch of processed elements from the front of a list
+	Will return a failure if the range is out of bounds
+
+	> JsonRemoveElementsIf()
+	Removes every element in a JsonList that the predicate returns true for, compacting the list in one pass
+	Returns the number of elements which were removed
+*/
+
+void JsonAppend(JsonList* list, JsonValue* value) {
+	JsonValueArrayAppend(list, *value);
+}
+
+void JsonAppendString(JsonList* list, JsonString string) {
+	JSON_WITH_ALLOCATOR(list->Allocator) {
+		JsonValue* value = JsonCreateString(string);
+		JsonAppend(list, value);
+		JsonPoolFree(value, sizeof(JsonValue));
+	}
+}
+
+void JsonAppendInt(JsonList* list, JsonInt integer) {
+	JSON_WITH_ALLOCATOR(list->Allocator) {
+		JsonValue* value = JsonCreateInt(integer);
+		JsonAppend(list, value);
+		JsonPoolFree(value, sizeof(JsonValue));
+	}
+}
+
+void JsonAppendFloat(JsonList* list, JsonFloat flt) {
+	JSON_WITH_ALLOCATOR(list->Allocator) {
+		JsonValue* value = JsonCreateFloat(flt);
+		JsonAppend(list, value);
+		JsonPoolFree(value, sizeof(JsonValue));
+	}
+}
+
+void JsonAppendTrue(JsonList* list) {
+	JSON_WITH_ALLOCATOR(list->Allocator) {
+		JsonValue* value = JsonTrue;
+		JsonAppend(list, value);
+		JsonPoolFree(value, sizeof(JsonValue));
+	}
+}
+
+void JsonAppendFalse(JsonList* list) {
+	JSON_WITH_ALLOCATOR(list->Allocator) {
+		JsonValue* value = JsonFalse;
+		JsonAppend(list, value);
+		JsonPoolFree(value, sizeof(JsonValue));
+	}
+}
+
+void JsonAppendNull(JsonList* list) {
+	JSON_WITH_ALLOCATOR(list->Allocator) {
+		JsonValue* value = JsonNull;
+		JsonAppend(list, value);
+		JsonPoolFree(value, sizeof(JsonValue));
+	}
+}
+
+void JsonAppendList(JsonList* list, JsonList* list2) {
+	JSON_WITH_ALLOCATOR(list->Allocator) {
+		if (list == list2) {
+			JsonList* copy = JsonListCopy(list);
+			JsonValue* value = JsonValueInit(copy, JSON_LIST);
+			JsonValueArrayAppend(list, *value);
+		}
+		else {
+			JsonValue* value = JsonValueInit(list2, JSON_LIST);
+			JsonValueArrayAppend(list, *value);
+		}
+	}
+}
+
+void JsonAppendExpr(JsonList* list, JsonExpr* expr) {
+	JSON_WITH_ALLOCATOR(list->Allocator) {
+		JsonValue* value = JsonValueInit(expr, JSON_EXPR);
+		JsonValueArrayAppend(list, *value);
+	}
+}
+
+void JsonAddRange(JsonList* list, JsonList* list2, int reuse_list) {
+	JSON_WITH_ALLOCATOR(list->Allocator) {
+		for (ullong i = 0; i < list2->Length; i++) {
+			ElementView view;
+			JsonValue* value = ViewElement(list2, i, &view);
+			JsonValue* copy = JsonValueCopy(value);
+
+			JsonValueArrayAppend(list, *copy);
+			JsonPoolFree(copy, sizeof(JsonValue));
+		}
+	}
+
+	if (!reuse_list) {
+		JsonListDelete(list2);
+	}
+}
+
+int JsonRemoveElement(JsonList* list, ullong index) {
+	if (index >= list->Length) {
+		return FAILURE;
+	}
+
+	JsonListMakeUnique(list);
+
+	if (list->Packing == JSON_PACKED_NONE) {
+		JSON_WITH_ALLOCATOR(list->Allocator) {
+			JsonDataDelete(&list->Buffer[index]);
+		}
+	}
+
+	JsonValueArrayRemove(list, index);
+	return SUCCESS;
+}
+
+int JsonSwapRemoveElement(JsonList* list, ullong index) {
+	if (index >= list->Length) {
+		return FAILURE;
+	}
+
+	JsonListMakeUnique(list);
+
+	if (list->Packing == JSON_PACKED_NONE) {
+		JSON_WITH_ALLOCATOR(list->Allocator) {
+			JsonDataDelete(&list->Buffer[index]);
+		}
+	}
+
+	JsonValueArraySwapRemove(list, index);
+	return SUCCESS;
+}
+
+int JsonRemoveRange(JsonList* list, ullong index, ullong count) {
+	if (index > list->Length || count > list->Length - index) {
+		return FAILURE;
+	}
+
+	JsonListMakeUnique(list);
+
+	JSON_WITH_ALLOCATOR(list->Allocator) {
+		for (ullong i = index; i < index + count && list->Packing == JSON_PACKED_NONE; i++) {
+			JsonDataDelete(&list->Buffer[i]);
+		}
+	}
+
+	JsonValueArrayRemoveRange(list, index, count);
+	return SUCCESS;
+}
+
+typedef struct {
+	JsonValuePredicate Predicate;
+	void* Data;
+} RemoveElementsArgs;
+
+static int RemoveElementsPredicate(JsonValue* value, void* data) {
+	RemoveElementsArgs* args = data;
+
+	if (!args->Predicate(value, args->Data)) {
+		return FALSE;
+	}
+
+	JsonDataDelete(value);
+	return TRUE;
+}
+
+ullong JsonRemoveElementsIf(JsonList* list, JsonValuePredicate predicate, void* data) {
+	RemoveElementsArgs args = { predicate, data };
+	ullong removed = 0;
+
+	JSON_WITH_ALLOCATOR(list->Allocator) {
+		removed = JsonValueArrayRemoveIf(list, RemoveElementsPredicate, &args);
+	}
+
+	return removed;
+}
+
+/*
+	Modifying Expr
+
+	FUNCTIONS:
+
+	> JsonSet()
+	Adds a JsonValue to a JsonExpr with a key to index it
+	If the key exists then it will delete the previous value and override it
+	Used for when you want a key to equal a value
+
+	> JsonSetString()
+	Creates a JsonValue from a JsonString and adds it to a JsonExpr with a key to index it
+	Used for when you want to add a string to a JsonExpr
+
+	> JsonSetInt()
+	Creates a JsonValue from a JsonInt and adds it to a JsonExpr with a key to index it
+	Used for when you want to add an int to a JsonExpr
+
+	> JsonSetFloat()
+	Creates a JsonValue from a JsonFloat and adds it to a JsonExpr with a key to index it
+	Used for when you want to add a float to a JsonExpr
+
+	> JsonSetTrue()
+	Creates a JsonValue which equals JSON_TRUE (true keyword) and adds it to a JsonExpr with a key to index it
+	Used for when you want to set the value of a key to true in a JsonExpr
+
+	> JsonSetFalse()
+	Creates a JsonValue which equals JSON_FALSE (false keyword) and adds it to a JsonExpr with a key to index it
+	Used for when you want to set the value of a key to false in a JsonExpr
+
+	> JsonSetNull()
+	Creates a JsonValue which equals JSON_NULL (null keyword) and adds it to a JsonExpr with a key to index it
+	Used for when you want to set the value of a key to null in a JsonExpr
+
+	> JsonSetList()
+	Adds a JsonList to a JsonExpr with a key to index it
+	If the key exists it will delete the previous value and override it
+
+	> JsonSetExpr()
+	Adds a JsonExpr to a JsonExpr with a key to index it
+	If the key exists it will delete the previous value to override it
+	If you are adding a JsonExpr to itself a copy will be made of the JsonExpr to avoid errors, this may result
+	in a very small memory leak as the memory deallocator has lost a reference to the data. This can be fixed by
+	manually freeing the list. 
+
+	> JsonMerge()
+	Adds the pairs of a JsonExpr to another
+	Used for combining two JsonExprs
+	If argument "reuse_expr" is correct then the function will delete the JsonExpr which is being copied from. 
+	example: {"animal": "Polar Bear"} MERGED WITH {"location": "Snowy Areas"} IS {"animal": "PolarBear", "location": "Snowy Areas"}
+
+	> JsonRemoveKey()
+	Removes a pair in a JsonExpr with the key it is associated with
+	Will return a failure if the key is not in the JsonExpr
+
+	> JsonSwapRemoveKey()
+	Removes a pair in a JsonExpr by moving the last pair into its place
+	Faster than JsonRemoveKey() for large JsonExprs but does not keep the order of the pairs
+	Will return a failure if the key is not in the JsonExpr
+
+	> JsonRemoveKeysIf()
+	Removes every pair in a JsonExpr that the predicate returns true for, compacting the JsonExpr in one pass
+	Returns the number of pairs which were removed
+
+	NOTES:
+
+	These functions, and the ones which modify a JsonList, allocate and free with the allocator the JsonExpr or
+	JsonList was created with rather than the one the calling thread has selected. A JsonValue passed to JsonSet()
+	or JsonAppend() is freed with that allocator too, so it has to be created with it
+*/
+
+void JsonSet(JsonExpr* expr, const char* key, JsonValue* value) {
+	ullong length = strlen(key);
+	ullong hash = JsonHashKey(key, length);
+	ullong index = JsonGetPairIndexHashed(expr, key, length, hash);
+	JsonExprMakeUnique(expr);
+
+	JSON_WITH_ALLOCATOR(expr->Allocator) {
+		if (index == PAIR_INDEX_NOT_FOUND) {
+			JsonPair* pair = JsonPairInitHashed(AllocJsonString(key), length, hash, value);
+			JsonPairArrayAppend(expr, *pair);
+			JsonPoolFree(pair, sizeof(JsonPair));
+		}
+		else {
+			JsonValueDelete(expr->Buffer[index].Value);
+			expr->Buffer[index].Value = value;
+		}
+	}
+}
+
+void JsonSetString(JsonExpr* expr, const char* key, JsonString* string) {
+	JSON_WITH_ALLOCATOR(expr->Allocator) {
+		JsonSet(expr, key, JsonCreateString(string));
+	}
+}
+
+void JsonSetInt(JsonExpr* expr, const char* key, JsonInt integer) {
+	JSON_WITH_ALLOCATOR(expr->Allocator) {
+		JsonSet(expr, key, JsonCreateInt(integer));
+	}
+}
+
+void JsonSetFloat(JsonExpr* expr, const char* key, JsonFloat flt) {
+	JSON_WITH_ALLOCATOR(expr->Allocator) {
+		JsonSet(expr, key, JsonCreateFloat(flt));
+	}
+}
+
+void JsonSetTrue(JsonExpr* expr, const char* key) {
+	JSON_WITH_ALLOCATOR(expr->Allocator) {
+		JsonSet(expr, key, JsonTrue);
+	}
+}
+
+void JsonSetFalse(JsonExpr* expr, const char* key) {
+	JSON_WITH_ALLOCATOR(expr->Allocator) {
+		JsonSet(expr, key, JsonFalse);
+	}
+}
+
+void JsonSetNull(JsonExpr* expr, const char* key) {
+	JSON_WITH_ALLOCATOR(expr->Allocator) {
+		JsonSet(expr, key, JsonNull);
+	}
+}
+
+void JsonSetList(JsonExpr* expr, const char* key, JsonList* list) {
+	JSON_WITH_ALLOCATOR(expr->Allocator) {
+		JsonSet(expr, key, JsonValueInit(list, JSON_LIST));
+	}
+}
+
+void JsonSetExpr(JsonExpr* expr, const char* key, JsonExpr* expr2) {
+	ullong index = JsonGetPairIndex(expr, key);
+
+	JSON_WITH_ALLOCATOR(expr->Allocator) {
+		if (expr == expr2 && index == PAIR_INDEX_NOT_FOUND) {
+			expr2 = JsonExprCopy(expr2);
+		}
+
+		JsonSet(expr, key, JsonValueInit(expr2, JSON_EXPR));
+	}
+}
+
+void JsonMerge(JsonExpr* expr, JsonExpr* expr2, int reuse_expr) {
+	JSON_WITH_ALLOCATOR(expr->Allocator) {
+		for (ullong i = 0; i < expr2->Length; i++) {
+			JsonPair* pair = &expr2->Buffer[i];
+			JsonPair* copy = JsonPairCopy(pair);
+
+			JsonPairArrayAppend(expr, *copy);
+			JsonPoolFree(copy, sizeof(JsonPair));
+		}
+	}
+
+	if (!reuse_expr) {
+		JsonExprDelete(expr2);
+	}
+}
+
+int JsonRemoveKey(JsonExpr* expr, const char* key) {
+	ullong index = JsonGetPairIndex(expr, key);
+
+	if (index == PAIR_INDEX_NOT_FOUND) {
+		return FAILURE;
+	}
+
+	JsonExprUnshape(expr);
+	JsonExprMakeUnique(expr);
+
+	JSON_WITH_ALLOCATOR(expr->Allocator) {
+		JsonPairDelete(&expr->Buffer[index]);
+	}
+
+	JsonPairArrayRemove(expr, index);
+	return SUCCESS;
+}
+
+int JsonSwapRemoveKey(JsonExpr* expr, const char* key) {
+	ullong index = JsonGetPairIndex(expr, key);
+
+	if (index == PAIR_INDEX_NOT_FOUND) {
+		return FAILURE;
+	}
+
+	JsonExprUnshape(expr);
+	JsonExprMakeUnique(expr);
+
+	JSON_WITH_ALLOCATOR(expr->Allocator) {
+		JsonPairDelete(&expr->Buffer[index]);
+	}
+
+	JsonPairArraySwapRemove(expr, index);
+	return SUCCESS;
+}
+
+typedef struct {
+	JsonPairPredicate Predicate;
+	void* Data;
+} RemoveKeysArgs;
+
+static int RemoveKeysPredicate(JsonPair* pair, void* data) {
+	RemoveKeysArgs* args = data;
+
+	if (!args->Predicate(pair, args->Data)) {
+		return FALSE;
+	}
+
+	JsonPairDelete(pair);
+	return TRUE;
+}
+
+ullong JsonRemoveKeysIf(JsonExpr* expr, JsonPairPredicate predicate, void* data) {
+	RemoveKeysArgs args = { predicate, data };
+	ullong removed = 0;
+
+	JSON_WITH_ALLOCATOR(expr->Allocator) {
+		removed = JsonPairArrayRemoveIf(expr, RemoveKeysPredicate, &args);
+	}
+
+	return removed;
+}
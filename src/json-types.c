@@ -1,256 +1,651 @@
-
-#include <stdlib.h>
-#include <string.h>
-#include "include/json-types.h"
-
-/*
-	Memory Allocation
-
-	FUNCTIONS:
-
-	> AllocJsonString()
-	Creates a dynamically allocated JsonString from another string
-
-	> AllocJsonInt()
-	Creates a dynamically allocated JsonInt from an integer
-
-	> AllocJsonFloat()
-	Creates a dynamically allocated JsonFloat from a float
-*/
-
-JsonString* AllocJsonString(JsonString string) {
-	if (!string) {
-		return string;
-	}
-
-	size_t len = strlen(string);
-	char* output = malloc(len + 1);
-
-	for (size_t i = 0; i < len; i++) {
-		output[i] = string[i];
-	}
-
-	output[len] = '\0';
-	return output;
-}
-
-JsonInt* AllocJsonInt(JsonInt integer) {
-	JsonInt* output = malloc(sizeof(JsonInt));
-	*output = integer;
-
-	return output;
-}
-
-JsonFloat* AllocJsonFloat(JsonFloat flt) {
-	JsonFloat* output = malloc(sizeof(JsonFloat));
-	*output = flt;
-
-	return output;
-}
-
-/*
-	Initializing Data
-
-	FUNCTIONS:
-
-	> JsonValueInit()
-	Initialize a JsonValue object
-
-	> JsonPairInit()
-	Initialize a JsonPair object
-*/
-
-JsonValue* JsonValueInit(void* data, JsonType type) {
-	JsonValue* value = calloc(1, sizeof(JsonValue));
-	value->Data = calloc(1, sizeof(JsonData));
-	value->Type = type;
-
-	switch (type) {
-		case JSON_EXPR:
-			value->Data->Expr = data;
-			break;
-		case JSON_LIST:
-			value->Data->List = data;
-			break;
-		case JSON_STRING:
-			value->Data->String = data;
-			break;
-		case JSON_INT:
-			value->Data->Int = data;
-			break;
-		case JSON_FLOAT:
-			value->Data->Float = data;
-			break;
-	}
-
-	return value;
-}
-
-JsonPair* JsonPairInit(const char* key, JsonValue* value) {
-	JsonPair* pair = calloc(1, sizeof(JsonPair));
-	pair->Key = key;
-	pair->Value = value;
-
-	return pair;
-}
-
-/*
-	Copy Data
-
-	FUNCTIONS:
-
-	> JsonValueCopy()
-	Create a copy of a JsonValue from another JsonValue
-
-	> JsonPairCopy()
-	Create a copy of a JsonPair from another JsonPair
-
-	> JsonListCopy()
-	Create a copy of a JsonList from another JsonList
-
-	> JsonExprCopy()
-	Create a copy of a JsonExpr from another JsonExpr
-
-	NOTES:
-
-	These functions are used to create clones of other objects. These help ensure that data is
-	not shared between objects. 
-*/
-
-JsonValue* JsonValueCopy(JsonValue* value) {
-	JsonValue* copy = calloc(1, sizeof(JsonValue));
-	copy->Data = calloc(1, sizeof(JsonValue));
-	copy->Type = value->Type;
-
-	switch (value->Type) {
-		case JSON_EXPR:
-			copy->Data->Expr = JsonExprCopy(value->Data->Expr);
-			break;
-		case JSON_LIST:
-			copy->Data->List = JsonListCopy(value->Data->List);
-			break;
-		case JSON_STRING:
-			copy->Data->String = AllocJsonString(value->Data->String);
-			break;
-		case JSON_INT:
-			copy->Data->Int = AllocJsonInt(*value->Data->Int);
-			break;
-		case JSON_FLOAT:
-			copy->Data->Float = AllocJsonFloat(*value->Data->Float);
-			break;
-	}
-
-	return copy;
-}
-
-JsonPair* JsonPairCopy(JsonPair* pair) {
-	JsonPair* copy = calloc(1, sizeof(JsonPair));
-	copy->Key = AllocJsonString(pair->Key);
-	copy->Value = JsonValueCopy(pair->Value);
-
-	return copy;
-}
-
-JsonList* JsonListCopy(JsonList* list) {
-	JsonList* copy = calloc(1, sizeof(JsonList));
-	copy->Buffer = calloc(list->Length, sizeof(JsonValue));
-	copy->Capacity = list->Capacity;
-	copy->Length = list->Length;
-
-	for (ullong i = 0; i < list->Length; i++) {
-		JsonValue* value = JsonValueCopy(&list->Buffer[i]);
-		copy->Buffer[i] = *value;
-		free(value);
-	}
-
-	return copy;
-}
-
-JsonExpr* JsonExprCopy(JsonExpr* expr) {
-	JsonExpr* copy = calloc(1, sizeof(JsonExpr));
-	copy->Buffer = calloc(expr->Length, sizeof(JsonPair));
-	copy->Capacity = expr->Capacity;
-	copy->Length = expr->Length;
-
-	for (ullong i = 0; i < expr->Length; i++) {
-		JsonPair* pair = JsonPairCopy(&expr->Buffer[i]);
-		copy->Buffer[i] = *pair;
-		free(pair);
-	}
-
-	return copy;
-}
-
-/*
-	Deleting Data
-
-	FUNCTIONS:
-
-	> JsonDataDelete()
-	Deletes a JsonData object inside of a JsonValue object
-	JsonValue is passed in because the type is required for freeing
-
-	> JsonValueDelete()
-	Deletes a JsonValue object entirely
-
-	> JsonPairDelete()
-	Deletes a JsonPair object entirely
-
-	> JsonListDelete()
-	Deletes a JsonList object entirely
-	Deletes all of the elements inside of the JsonList
-
-	> JsonExprDelete()
-	Deletes a JsonExpr object entirely
-	Deletes all of the pairs inside of the JsonExpr
-*/
-
-void JsonDataDelete(JsonValue* value) {
-	switch (value->Type) {
-		case JSON_EXPR:
-			JsonExprDelete(value->Data->Expr);
-			break;
-		case JSON_LIST:
-			JsonListDelete(value->Data->List);
-			break;
-		case JSON_STRING:
-			free(value->Data->String);
-			break;
-		case JSON_INT:
-			free(value->Data->Int);
-			break;
-		case JSON_FLOAT:
-			free(value->Data->Float);
-			break;
-	}
-
-	free(value->Data);
-}
-
-void JsonValueDelete(JsonValue* value) {
-	JsonDataDelete(value);
-	free(value);
-}
-
-void JsonPairDelete(JsonPair* pair) {
-	free(pair->Key);
-	JsonValueDelete(pair->Value);
-}
-
-void JsonListDelete(JsonList* list) {
-	for (ullong i = 0; i < list->Length; i++) {
-		JsonDataDelete(&list->Buffer[i]);
-	}
-
-	free(list->Buffer);
-	free(list);
-}
-
-void JsonExprDelete(JsonExpr* expr) {
-	for (ullong i = 0; i < expr->Length; i++) {
-		JsonPairDelete(&expr->Buffer[i]);
-	}
-
-	free(expr->Buffer);
-	free(expr);
-}
+
+#include <stdlib.h>
+#include <string.h>
+#include "include/json-types.h"
+#include "include/shapes.h"
+#include "include/interning.h"
+
+#define TRUE 1
+#define FALSE 0
+
+/*
+	Memory Allocation
+
+	FUNCTIONS:
+
+	> AllocJsonString()
+	Creates a dynamically allocated JsonString from another string
+
+	> AllocJsonInt()
+	Creates a dynamically allocated JsonInt from an integer
+
+	> AllocJsonFloat()
+	Creates a dynamically allocated JsonFloat from a float
+*/
+
+char* AllocJsonString(JsonString string) {
+	if (!string) {
+		return NULL;
+	}
+
+	size_t len = strlen(string);
+	char* output = JsonMalloc(len + 1);
+
+	for (size_t i = 0; i < len; i++) {
+		output[i] = string[i];
+	}
+
+	output[len] = '\0';
+	return output;
+}
+
+JsonInt* AllocJsonInt(JsonInt integer) {
+	JsonInt* output = JsonPoolAlloc(sizeof(JsonInt));
+	*output = integer;
+
+	return output;
+}
+
+JsonFloat* AllocJsonFloat(JsonFloat flt) {
+	JsonFloat* output = JsonPoolAlloc(sizeof(JsonFloat));
+	*output = flt;
+
+	return output;
+}
+
+/*
+	Key Hashing
+
+	FUNCTIONS:
+
+	> JsonHashKey()
+	Hashes the first 'length' chars of a key. Produces the same hash the Lexer computes while it scans a string,
+	so a caller can hash a key once and pass it to JsonGetValueHashed() for repeated lookups
+*/
+
+ullong JsonHashKey(const char* key, ullong length) {
+	ullong hash = JSON_HASH_OFFSET;
+
+	for (ullong i = 0; i < length; i++) {
+		hash = JsonHashStep(hash, key[i]);
+	}
+
+	return hash;
+}
+
+/*
+	Initializing Data
+
+	FUNCTIONS:
+
+	> JsonValueInit()
+	Initialize a JsonValue object
+
+	> JsonPairInit()
+	Initialize a JsonPair object
+	The length and hash of the key are computed from the key
+
+	> JsonPairInitHashed()
+	Initialize a JsonPair object with a key length and hash which have already been computed (e.g., by the Lexer)
+*/
+
+JsonValue* JsonValueInit(void* data, JsonType type) {
+	JsonValue* value = JsonPoolCalloc(sizeof(JsonValue));
+	value->Data = JsonPoolCalloc(sizeof(JsonData));
+	value->Type = type;
+
+	switch (type) {
+		case JSON_EXPR:
+			value->Data->Expr = data;
+			break;
+		case JSON_LIST:
+			value->Data->List = data;
+			break;
+		case JSON_STRING:
+			value->Data->String = data;
+			break;
+		case JSON_INT:
+			value->Data->Int = data;
+			break;
+		case JSON_FLOAT:
+			value->Data->Float = data;
+			break;
+	}
+
+	return value;
+}
+
+JsonPair* JsonPairInit(const char* key, JsonValue* value) {
+	ullong length = strlen(key);
+	return JsonPairInitHashed(key, length, JsonHashKey(key, length), value);
+}
+
+JsonPair* JsonPairInitHashed(const char* key, ullong length, ullong hash, JsonValue* value) {
+	JsonPair* pair = JsonPoolCalloc(sizeof(JsonPair));
+	pair->Key = key;
+	pair->KeyLength = length;
+	pair->KeyHash = hash;
+	pair->Value = value;
+
+	return pair;
+}
+
+/*
+	Copy Data
+
+	FUNCTIONS:
+
+	> JsonValueCopy()
+	Create a copy of a JsonValue from another JsonValue
+
+	> JsonPairCopy()
+	Create a copy of a JsonPair from another JsonPair
+
+	> JsonListCopy()
+	Create a copy of a JsonList from another JsonList
+
+	> JsonExprCopy()
+	Create a copy of a JsonExpr from another JsonExpr
+
+	> ListHoldsContainers()
+	Checks whether any element of a JsonList is a JsonList or JsonExpr
+
+	> ExprHoldsContainers()
+	Checks whether the value of any JsonPair of a JsonExpr is a JsonList or JsonExpr
+
+	NOTES:
+
+	An interned string is not copied, the copy takes a reference on it (see JsonStringRetain())
+
+	These functions are used to create clones of other objects. The buffer of a JsonList or JsonExpr which holds no
+	other lists or exprs is not copied, the copy shares it with the original and both hold a reference count on it. The
+	first time either of them is modified it is given its own buffer (see JsonValueArrayMakeUnique() and
+	JsonPairArrayMakeUnique()). A JsonList or JsonExpr which does hold other lists or exprs is given its own buffer
+	straight away and its elements are copied the same way. Only the innermost levels of a document are shared, so a
+	copy costs as much as the levels above them, and the innermost levels are only copied once they are edited
+
+	A shared buffer never holds a JsonList or JsonExpr, so every list and expr which can be reached through a copy,
+	whether with JsonGetList() and JsonGetExpr() or through Buffer, belongs to that copy alone and can be edited
+	without changing the original. Only the JsonValues in a shared buffer are shared, so numbers and strings must be
+	changed with the JsonSet* and JsonAppend* functions rather than written through a JsonValue
+
+	The reference counts are not atomic, copies which share data should be used from the same thread
+
+	A copy of a JsonList or JsonExpr is allocated with, and keeps using, the allocator of the original
+*/
+
+JsonValue* JsonValueCopy(JsonValue* value) {
+	JsonValue* copy = JsonPoolCalloc(sizeof(JsonValue));
+	copy->Data = JsonPoolCalloc(sizeof(JsonData));
+	copy->Type = value->Type;
+
+	switch (value->Type) {
+		case JSON_EXPR:
+			copy->Data->Expr = JsonExprCopy(value->Data->Expr);
+			break;
+		case JSON_LIST:
+			copy->Data->List = JsonListCopy(value->Data->List);
+			break;
+		case JSON_STRING:
+			copy->Data->String = value->Interned
+				? JsonStringRetain(value->Data->String)
+				: AllocJsonString(value->Data->String);
+			copy->Interned = value->Interned;
+			copy->Plain = value->Plain;
+			break;
+		case JSON_INT:
+			copy->Data->Int = AllocJsonInt(*value->Data->Int);
+			break;
+		case JSON_FLOAT:
+			copy->Data->Float = AllocJsonFloat(*value->Data->Float);
+			break;
+	}
+
+	return copy;
+}
+
+JsonPair* JsonPairCopy(JsonPair* pair) {
+	JsonPair* copy = JsonPoolCalloc(sizeof(JsonPair));
+	copy->Key = pair->KeyInterned ? JsonStringRetain(pair->Key) : AllocJsonString(pair->Key);
+	copy->KeyLength = pair->KeyLength;
+	copy->KeyInterned = pair->KeyInterned;
+	copy->KeyHash = pair->KeyHash;
+	copy->Value = JsonValueCopy(pair->Value);
+
+	return copy;
+}
+
+static int ListHoldsContainers(JsonList* list) {
+	for (ullong i = 0; i < list->Length && list->Packing == JSON_PACKED_NONE; i++) {
+		if (list->Buffer[i].Type == JSON_EXPR || list->Buffer[i].Type == JSON_LIST) {
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+static int ExprHoldsContainers(JsonExpr* expr) {
+	for (ullong i = 0; i < expr->Length; i++) {
+		if (expr->Buffer[i].Value->Type == JSON_EXPR || expr->Buffer[i].Value->Type == JSON_LIST) {
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+JsonList* JsonListCopy(JsonList* list) {
+	JsonAllocator* previous = JsonSelectAllocator(list->Allocator);
+
+	if (list->RefCount == NULL) {
+		list->RefCount = JsonPoolAlloc(sizeof(ullong));
+		*list->RefCount = 1;
+	}
+
+	(*list->RefCount)++;
+
+	JsonList* copy = JsonPoolCalloc(sizeof(JsonList));
+	*copy = *list;
+	JsonAllocatorRetain(copy->Allocator);
+
+	if (ListHoldsContainers(list)) {
+		JsonListMakeUnique(copy);
+	}
+
+	JsonSelectAllocator(previous);
+	return copy;
+}
+
+JsonExpr* JsonExprCopy(JsonExpr* expr) {
+	JsonAllocator* previous = JsonSelectAllocator(expr->Allocator);
+
+	if (expr->RefCount == NULL) {
+		expr->RefCount = JsonPoolAlloc(sizeof(ullong));
+		*expr->RefCount = 1;
+	}
+
+	(*expr->RefCount)++;
+
+	if (expr->Shape != NULL) {
+		JsonShapeRetain(expr->Shape);
+	}
+
+	JsonExpr* copy = JsonPoolCalloc(sizeof(JsonExpr));
+	*copy = *expr;
+	JsonAllocatorRetain(copy->Allocator);
+
+	if (ExprHoldsContainers(expr)) {
+		JsonExprMakeUnique(copy);
+	}
+
+	JsonSelectAllocator(previous);
+	return copy;
+}
+
+/*
+	Deleting Data
+
+	FUNCTIONS:
+
+	> JsonDataDelete()
+	Deletes a JsonData object inside of a JsonValue object
+	JsonValue is passed in because the type is required for freeing
+	An interned string is released rather than freed (see JsonStringRelease())
+
+	> JsonValueDelete()
+	Deletes a JsonValue object entirely
+
+	> JsonPairDelete()
+	Deletes a JsonPair object entirely
+
+	> JsonListDelete()
+	Deletes a JsonList object entirely
+	Deletes all of the elements inside of the JsonList, unless its buffer is still shared with a copy
+	A packed JsonList only has its number array freed
+
+	> JsonExprDelete()
+	Deletes a JsonExpr object entirely
+	Deletes all of the pairs inside of the JsonExpr, unless its buffer is still shared with a copy
+	The keys of a JsonExpr which uses a shape belong to the shape and are freed with it (see JsonShapeRelease())
+
+	> ListDelete(), ExprDelete()
+	Does the work of JsonListDelete() and JsonExprDelete(), which select the allocator the JsonList or JsonExpr
+	was created with around them (see JsonSelectAllocator())
+*/
+
+void JsonDataDelete(JsonValue* value) {
+	switch (value->Type) {
+		case JSON_EXPR:
+			JsonExprDelete(value->Data->Expr);
+			break;
+		case JSON_LIST:
+			JsonListDelete(value->Data->List);
+			break;
+		case JSON_STRING:
+			if (value->Interned) {
+				JsonStringRelease(value->Data->String);
+			}
+			else {
+				JsonFree((char*)value->Data->String);
+			}
+			break;
+		case JSON_INT:
+			JsonPoolFree(value->Data->Int, sizeof(JsonInt));
+			break;
+		case JSON_FLOAT:
+			JsonPoolFree(value->Data->Float, sizeof(JsonFloat));
+			break;
+	}
+
+	JsonPoolFree(value->Data, sizeof(JsonData));
+}
+
+void JsonValueDelete(JsonValue* value) {
+	JsonDataDelete(value);
+	JsonPoolFree(value, sizeof(JsonValue));
+}
+
+void JsonPairDelete(JsonPair* pair) {
+	if (pair->KeyInterned) {
+		JsonStringRelease(pair->Key);
+	}
+	else {
+		JsonFree((char*)pair->Key);
+	}
+
+	JsonValueDelete(pair->Value);
+}
+
+static void ListDelete(JsonList* list) {
+	if (list->RefCount != NULL && --*list->RefCount > 0) {
+		JsonPoolFree(list, sizeof(JsonList));
+		return;
+	}
+
+	JsonPoolFree(list->RefCount, sizeof(ullong));
+
+	for (ullong i = 0; i < list->Length && list->Packing == JSON_PACKED_NONE; i++) {
+		JsonDataDelete(&list->Buffer[i]);
+	}
+
+	JsonFree(list->Buffer);
+	JsonFree(list->Numbers);
+	JsonPoolFree(list, sizeof(JsonList));
+}
+
+static void ExprDelete(JsonExpr* expr) {
+	if (expr->RefCount != NULL && --*expr->RefCount > 0) {
+		JsonShapeRelease(expr->Shape);
+		JsonPoolFree(expr, sizeof(JsonExpr));
+		return;
+	}
+
+	JsonPoolFree(expr->RefCount, sizeof(ullong));
+
+	for (ullong i = 0; i < expr->Length; i++) {
+		if (expr->Shape != NULL) {
+			JsonValueDelete(expr->Buffer[i].Value);
+			continue;
+		}
+
+		JsonPairDelete(&expr->Buffer[i]);
+	}
+
+	JsonShapeRelease(expr->Shape);
+
+	JsonFree(expr->Buffer);
+	JsonPoolFree(expr, sizeof(JsonExpr));
+}
+
+void JsonListDelete(JsonList* list) {
+	JsonAllocator* allocator = list->Allocator;
+	JsonAllocator* previous = JsonSelectAllocator(allocator);
+	ListDelete(list);
+	JsonSelectAllocator(previous);
+	JsonAllocatorRelease(allocator);
+}
+
+void JsonExprDelete(JsonExpr* expr) {
+	JsonAllocator* allocator = expr->Allocator;
+	JsonAllocator* previous = JsonSelectAllocator(allocator);
+	ExprDelete(expr);
+	JsonSelectAllocator(previous);
+	JsonAllocatorRelease(allocator);
+}
+
+/*
+	Compacting Data
+
+	FUNCTIONS:
+
+	> JsonCompact()
+	Relocates every node of a JsonExpr (and everything inside of it) into a single JsonRegion, laid out in
+	depth-first order with every JsonList, JsonExpr and string sized exactly to its contents. The old nodes are
+	freed once the whole tree has been relocated. 'expr' itself stays where it is, so pointers to it remain valid,
+	but pointers to anything inside of it do not
+
+	> MeasureValue(), MeasureList(), MeasureExpr()
+	Gets the number of bytes CompactValue(), CompactListInto() and CompactExprInto() take from a JsonRegion
+
+	> CompactString()
+	Creates an exactly sized copy of a string whose length is known
+
+	> CompactValue()
+	Relocates the JsonData of a JsonValue (and everything inside of it) into 'copy'
+
+	> CompactListInto(), CompactExprInto()
+	Relocates the contents of a JsonList or JsonExpr into 'copy', which is already allocated
+
+	> CompactList(), CompactExpr()
+	Relocates a JsonList or JsonExpr and returns the new one
+
+	NOTES:
+
+	Long lived documents which are edited in place end up spread across the heap with containers left at their
+	doubled capacity. The tree is measured first so the region is allocated once at its exact size. Every JsonList
+	and JsonExpr of the compacted document uses the region's allocator (see JsonRegion.Interface), so its nodes are
+	still freed and resized one by one like any other, a compacted JsonExpr can be edited and deleted as usual, and
+	the region is freed with its last node. Memory added to the document later comes from the allocator it used
+	before. 'expr' itself is freed with the allocator it was allocated with, so its region is the new region's
+	parent when 'expr' is part of a document which was compacted before (see JsonAllocatorOwner())
+
+	A JsonFloat which is wider than JSON_REGION_ALIGNMENT (a long double, see JSON_FLOAT_DOUBLE) is allocated
+	outside of the region, as the region does not align blocks for it
+
+	Buffers which are shared with a copy (see JsonListCopy() and JsonExprCopy()) are relocated as well, so the
+	compacted JsonExpr no longer shares anything with its copies. Shapes and interned strings stay shared
+*/
+
+#define COMPACT_FLOAT_IN_REGION (sizeof(JsonFloat) <= JSON_REGION_ALIGNMENT)
+
+static ullong MeasureList(JsonList* list);
+static ullong MeasureExpr(JsonExpr* expr);
+static JsonList* CompactList(JsonRegion* region, JsonList* list);
+static JsonExpr* CompactExpr(JsonRegion* region, JsonExpr* expr);
+
+static ullong MeasureValue(JsonValue* value) {
+	ullong size = JsonRegionSize(sizeof(JsonData));
+
+	switch (value->Type) {
+		case JSON_EXPR:
+			return size + JsonRegionSize(sizeof(JsonExpr)) + MeasureExpr(value->Data->Expr);
+		case JSON_LIST:
+			return size + JsonRegionSize(sizeof(JsonList)) + MeasureList(value->Data->List);
+		case JSON_STRING:
+			return size + (value->Interned ? 0 : JsonRegionSize(strlen(value->Data->String) + 1));
+		case JSON_INT:
+			return size + JsonRegionSize(sizeof(JsonInt));
+		case JSON_FLOAT:
+			return size + (COMPACT_FLOAT_IN_REGION ? JsonRegionSize(sizeof(JsonFloat)) : 0);
+		default:
+			break;
+	}
+
+	return size;
+}
+
+static ullong MeasureList(JsonList* list) {
+	switch (list->Packing) {
+		case JSON_PACKED_INT:
+			return JsonRegionSize(sizeof(JsonInt) * list->Length);
+		case JSON_PACKED_FLOAT:
+			return COMPACT_FLOAT_IN_REGION ? JsonRegionSize(sizeof(JsonFloat) * list->Length) : 0;
+	}
+
+	ullong size = JsonRegionSize(sizeof(JsonValue) * list->Length);
+
+	for (ullong i = 0; i < list->Length; i++) {
+		size += MeasureValue(&list->Buffer[i]);
+	}
+
+	return size;
+}
+
+static ullong MeasureExpr(JsonExpr* expr) {
+	ullong size = JsonRegionSize(sizeof(JsonPair) * expr->Length);
+
+	for (ullong i = 0; i < expr->Length; i++) {
+		JsonPair* pair = &expr->Buffer[i];
+
+		if (expr->Shape == NULL && !pair->KeyInterned) {
+			size += JsonRegionSize(pair->KeyLength + 1);
+		}
+
+		size += JsonRegionSize(sizeof(JsonValue)) + MeasureValue(pair->Value);
+	}
+
+	return size;
+}
+
+static char* CompactString(JsonRegion* region, const char* string, ullong length) {
+	char* output = JsonRegionAlloc(region, length + 1);
+	memcpy(output, string, length);
+	output[length] = '\0';
+
+	return output;
+}
+
+static void CompactValue(JsonRegion* region, JsonValue* value, JsonValue* copy) {
+	copy->Type = value->Type;
+	copy->Interned = value->Interned;
+	copy->Plain = value->Plain;
+	copy->Data = JsonRegionAlloc(region, sizeof(JsonData));
+
+	switch (value->Type) {
+		case JSON_EXPR:
+			copy->Data->Expr = CompactExpr(region, value->Data->Expr);
+			break;
+		case JSON_LIST:
+			copy->Data->List = CompactList(region, value->Data->List);
+			break;
+		case JSON_STRING:
+			copy->Data->String = value->Interned
+				? JsonStringRetain(value->Data->String)
+				: CompactString(region, value->Data->String, strlen(value->Data->String));
+			break;
+		case JSON_INT:
+			copy->Data->Int = JsonRegionAlloc(region, sizeof(JsonInt));
+			*copy->Data->Int = *value->Data->Int;
+			break;
+		case JSON_FLOAT:
+			copy->Data->Float = COMPACT_FLOAT_IN_REGION
+				? JsonRegionAlloc(region, sizeof(JsonFloat))
+				: JsonPoolAlloc(sizeof(JsonFloat));
+			*copy->Data->Float = *value->Data->Float;
+			break;
+		default:
+			break;
+	}
+}
+
+static void CompactListInto(JsonRegion* region, JsonList* list, JsonList* copy) {
+	memset(copy, 0, sizeof(JsonList));
+	copy->Allocator = JsonAllocatorRetain(JsonGetAllocator());
+	copy->Length = list->Length;
+	copy->Capacity = list->Length;
+	copy->Packing = list->Packing;
+
+	if (list->Length == 0) {
+		return;
+	}
+
+	if (list->Packing != JSON_PACKED_NONE) {
+		ullong size = (list->Packing == JSON_PACKED_INT ? sizeof(JsonInt) : sizeof(JsonFloat)) * list->Length;
+
+		copy->Numbers = list->Packing == JSON_PACKED_INT || COMPACT_FLOAT_IN_REGION
+			? JsonRegionAlloc(region, size)
+			: JsonMalloc(size);
+		memcpy(copy->Numbers, list->Numbers, size);
+		return;
+	}
+
+	copy->Buffer = JsonRegionAlloc(region, sizeof(JsonValue) * list->Length);
+
+	for (ullong i = 0; i < list->Length; i++) {
+		CompactValue(region, &list->Buffer[i], &copy->Buffer[i]);
+	}
+}
+
+static void CompactExprInto(JsonRegion* region, JsonExpr* expr, JsonExpr* copy) {
+	memset(copy, 0, sizeof(JsonExpr));
+	copy->Allocator = JsonAllocatorRetain(JsonGetAllocator());
+	copy->Length = expr->Length;
+	copy->Capacity = expr->Length;
+	copy->Shape = expr->Shape != NULL ? JsonShapeRetain(expr->Shape) : NULL;
+
+	if (expr->Length == 0) {
+		return;
+	}
+
+	copy->Buffer = JsonRegionAlloc(region, sizeof(JsonPair) * expr->Length);
+
+	for (ullong i = 0; i < expr->Length; i++) {
+		JsonPair* pair = &expr->Buffer[i];
+		JsonPair* pairCopy = &copy->Buffer[i];
+
+		if (expr->Shape != NULL) {
+			pairCopy->Key = pair->Key;
+		}
+		else {
+			pairCopy->Key = pair->KeyInterned
+				? JsonStringRetain(pair->Key)
+				: CompactString(region, pair->Key, pair->KeyLength);
+		}
+
+		pairCopy->KeyLength = pair->KeyLength;
+		pairCopy->KeyInterned = pair->KeyInterned;
+		pairCopy->KeyHash = pair->KeyHash;
+		pairCopy->Value = JsonRegionAlloc(region, sizeof(JsonValue));
+		CompactValue(region, pair->Value, pairCopy->Value);
+	}
+}
+
+static JsonList* CompactList(JsonRegion* region, JsonList* list) {
+	JsonList* copy = JsonRegionAlloc(region, sizeof(JsonList));
+	CompactListInto(region, list, copy);
+
+	return copy;
+}
+
+static JsonExpr* CompactExpr(JsonRegion* region, JsonExpr* expr) {
+	JsonExpr* copy = JsonRegionAlloc(region, sizeof(JsonExpr));
+	CompactExprInto(region, expr, copy);
+
+	return copy;
+}
+
+void JsonCompact(JsonExpr* expr) {
+	JsonAllocator* previous = JsonSelectAllocator(expr->Allocator);
+	JsonExpr* old = JsonPoolAlloc(sizeof(JsonExpr));
+	*old = *expr;
+
+	JsonSelectAllocator(JsonAllocatorOwner(expr->Allocator, expr));
+	JsonRegion* region = JsonRegionInit(MeasureExpr(expr));
+	JsonSelectAllocator(&region->Interface);
+	CompactExprInto(region, old, expr);
+	JsonRegionRelease(region);
+
+	JsonSelectAllocator(previous);
+	JsonExprDelete(old);
+}
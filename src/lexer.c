@@ -1,367 +1,527 @@
-
-#include <stdio.h> //
-#include <stdlib.h>
-#include <string.h>
-#include <ctype.h>
-#include "include/lexer.h"
-
-/*
-	Advancing
-
-	FUNCTIONS:
-
-	> Advance()
-	Advance to the next char in a Lexer's source string. Also sets the previous char in the Lexer
-
-	> PeekNext()
-	Peek ahead of the current Lexer's index without advancing
-
-	> SkipWhitespace()
-	Keep advancing until a character which is not a whitespace is found
-
-	> AdvanceWith()
-	Create a token from the current lexer's char and call Advance()
-*/
-
-static void Advance(Lexer* lexer) {
-	lexer->PrevChar = lexer->Char;
-
-	lexer->Char = lexer->Length > ++lexer->Index
-		? lexer->Source[lexer->Index]
-		: CHAR_EMPTY;
-}
-
-static char PeekNext(Lexer* lexer, ullong offset) {
-	return lexer->Length > (offset = lexer->Index + offset)
-		? lexer->Source[offset]
-		: CHAR_EMPTY;
-}
-
-static void SkipWhitespace(Lexer* lexer) {
-	while (isspace(lexer->Char)) {
-		Advance(lexer);
-	}
-}
-
-static Token* AdvanceWith(Lexer* lexer, TokenType type) {
-	Advance(lexer);
-	return TokenInit(NULL, type);
-}
-
-/*
-	String Evaluation
-
-	MACROS:
-
-	> COMPARE_KEYWORDS
-	Returns 1 if a string is equal to a keyword
-
-	FUNCTIONS:
-
-	> EvaluateKeyword
-	Returns the keyword that a string represents. If there is no keyword then the string is not a valid
-	keyword and an error is thrown in the Lexer
-*/
-
-#define COMPARE_KEYWORD(str, keyword) strcmp(str, keyword) == 0
-
-static TokenType EvaluateKeyword(Lexer* lexer, const char* str) {
-	if (COMPARE_KEYWORD(str, KEYWORD_TRUE)) {
-		return TOKEN_TRUE;
-	}
-	else if (COMPARE_KEYWORD(str, KEYWORD_FALSE)) {
-		return TOKEN_FALSE;
-	}
-	else if (COMPARE_KEYWORD(str, KEYWORD_NULL)) {
-		return TOKEN_NULL;
-	}
-
-	RAISE_FATAL_ERROR(
-		lexer,
-		ERR_KEYWORD_NOT_RECOGNISED,
-		str
-	);
-}
-
-/*
-	Data Building
-
-	MACROS:
-
-	> IS_STRING
-	Returns 1 if a char is a valid string type
-
-	> IS_KEYWORD
-	Returns 1 if a char is a valid keyword type
-
-	> IS_NUMERICAL
-	Returns 1 if a char is a valid numerical type
-
-	> IS_ESCAPE_SEQ
-	Returns 1 if a char is a valid escape sequence type (e.g., \n)
-
-	> ESCAPE_STRING
-	String escape \" is used to register a '"' character into the string
-
-	> ESCAPE_TAB
-	String escape \t is used to register a tab (multiple spaces) into the string
-
-	> ESCAPE_NEWLINE
-	String escape \n is used to register a newline into the string
-
-	> ESCAPE_BACKSLASH
-	String escape \\ is used to register a '\' into the string
-
-	FUNCTIONS:
-
-	> ScanStringSize()
-	Scans the size of a string without advancing. This is used to tell the caller how many bytes should be
-	allocated when trying to store the string. Supports scanning for string escape characters such as '\n'
-
-	> ScanKeywordSize()
-	Scans the size of a keyword without advancing. This is used to tell the caller how many bytes should be
-	allocated when trying to store the keyword
-
-	> ScanNumberSize()
-	Scans the size of a number without advancing. This is used to tell the caller how many bytes should be
-	allocated when trying to store the number
-
-	> BuildString()
-	Builds a string from characters in a Lexer's source by advancing. Supports recognition for string escape
-	characters such as '\n'. 
-
-	> BuildKeyword()
-	Builds a keyword from characters in a Lexer's source by advancing
-
-	> BuildNumber()
-	Builds a number from characters in a Lexer's source by advancing
-*/
-
-#define IS_STRING(chr) chr != CHAR_QUOTE && chr != CHAR_EMPTY
-#define IS_KEYWORD(chr) isalpha(chr) && chr != CHAR_EMPTY
-#define IS_NUMERICAL(chr) isdigit(chr) || chr == '.' && chr != CHAR_EMPTY
-#define IS_ESCAPE_SEQ(chr) chr == 't' || chr == 'n' && chr != CHAR_EMPTY
-
-#define ESCAPE_STRING '"'
-#define ESCAPE_TAB 't'
-#define ESCAPE_NEWLINE 'n'
-#define ESCAPE_BACKSLASH '\\'
-
-static ullong ScanStringSize(Lexer* lexer) {
-	ullong size = 0;
-	ullong offset = 0;
-	char chr = lexer->Char;
-
-	while (IS_STRING(chr)) {
-		if (chr == CHAR_ESCAPE) {
-			chr = PeekNext(lexer, offset++);
-		}
-
-		size++;
-		chr = PeekNext(lexer, offset++);
-	}
-
-	return size;
-}
-
-static ullong ScanKeywordSize(Lexer* lexer) {
-	ullong size = 0;
-	ullong offset = 0;
-	char chr = lexer->Char;
-
-	while (IS_KEYWORD(chr)) {
-		size++;
-		chr = PeekNext(lexer, offset++);
-	}
-
-	return size;
-}
-
-static ullong ScanNumberSize(Lexer* lexer) {
-	ullong size = 0;
-	ullong offset = 0;
-	char chr = lexer->Char;
-
-	while (IS_NUMERICAL(chr)) {
-		size++;
-		chr = PeekNext(lexer, offset++);
-	}
-
-	return size;
-}
-
-static Token* BuildString(Lexer* lexer) {
-	ullong size = ScanStringSize(lexer);
-	char* value = malloc(size + 1);
-	ullong index = 0;
-	
-	while (IS_STRING(lexer->Char)) {
-		if (lexer->Char == CHAR_ESCAPE) {
-			switch (PeekNext(lexer, 1)) {
-				case ESCAPE_STRING:
-					value[index++] = CHAR_ESCAPE_QUOTE;
-					Advance(lexer);
-					break;
-				case ESCAPE_TAB:
-					value[index++] = CHAR_ESCAPE_TAB;
-					Advance(lexer);
-					break;
-				case ESCAPE_NEWLINE:
-					value[index++] = CHAR_ESCAPE_NEWLINE;
-					Advance(lexer);
-					break;
-				case ESCAPE_BACKSLASH:
-					value[index++] = CHAR_ESCAPE;
-					Advance(lexer);
-					break;
-				default:
-					{
-						RAISE_FATAL_ERROR(
-							lexer,
-							ERR_UNTERMINATED_STRING_LIERAL
-						);
-					}
-					break;
-			}
-		}
-		else {
-			value[index++] = lexer->Char;
-		}
-
-		Advance(lexer);
-	}
-
-	value[index] = '\0';
-	return TokenInit(value, TOKEN_STRING);
-}
-
-static Token* BuildKeyword(Lexer* lexer) {
-	ullong size = ScanKeywordSize(lexer);
-	char* value = malloc(size + 1);
-	int index = 0;
-	
-	while (IS_KEYWORD(lexer->Char)) {
-		value[index++] = lexer->Char;
-		Advance(lexer);
-	}
-
-	value[index] = '\0';
-	TokenType type = EvaluateKeyword(lexer, value);
-	free(value);
-
-	return TokenInit(NULL, type);
-}
-
-static Token* BuildNumber(Lexer* lexer) {
-	ullong size = ScanNumberSize(lexer);
-	char* value = malloc(size + 1);
-	int index = 0;
-	int decimals = 0;
-
-	while (IS_NUMERICAL(lexer->Char)) {
-		value[index++] = lexer->Char;
-		Advance(lexer);
-
-		if (lexer->Char == '.') {
-			decimals++;
-		}
-	}
-
-	value[index] = '\0';
-	return TokenInit(value, decimals ? TOKEN_FLOAT : TOKEN_INT);
-}
-
-/*
-	Reading Tokens
-
-	FUNCTIONS:
-
-	> GetNextToken()
-	Gets the next token from the current character in a Lexer's source string. Data can be built off of these characters,
-	such as (e.g., strings, keywords and numbers) if it is appropriate to do so. 
-*/
-
-Token* GetNextToken(Lexer* lexer) {
-	SkipWhitespace(lexer);
-
-	switch (lexer->Char) {
-		case CHAR_LCURLY:
-			return AdvanceWith(lexer, TOKEN_LCURLY);
-		case CHAR_RCURLY:
-			return AdvanceWith(lexer, TOKEN_RCURLY);
-		case CHAR_LBRACKET:
-			return AdvanceWith(lexer, TOKEN_LBRACKET);
-		case CHAR_RBRACKET:
-			return AdvanceWith(lexer, TOKEN_RBRACKET);
-		case CHAR_COLON:
-			return AdvanceWith(lexer, TOKEN_COLON);
-		case CHAR_COMMA:
-			return AdvanceWith(lexer, TOKEN_COMMA);
-		case CHAR_QUOTE:
-			return AdvanceWith(lexer, TOKEN_QUOTE);
-		case CHAR_MINUS:
-			return AdvanceWith(lexer, TOKEN_MINUS);
-		case CHAR_EMPTY:
-			return TokenInit(NULL, TOKEN_EOF);
-	}
-
-	if (lexer->PrevChar == CHAR_QUOTE) {
-		return BuildString(lexer);
-	}
-	else if (IS_KEYWORD(lexer->Char)) {
-		return BuildKeyword(lexer);
-	}
-	else if (IS_NUMERICAL(lexer->Char)) {
-		return BuildNumber(lexer);
-	}
-
-	RAISE_FATAL_ERROR(lexer, ERR_TOKEN_NOT_RECOGNISED, lexer->Char);
-}
-
-/*
-	Initializing Data
-
-	FUNCTIONS:
-
-	> LexerInit()
-	Initialize a Lexer object
-*/
-
-Lexer* LexerInit(const char* source) {
-	Lexer* lexer = calloc(1, sizeof(Lexer));
-	lexer->Source = source;
-	lexer->Length = strlen(source);
-	lexer->Index = 0;
-	lexer->Char = source[0];
-	lexer->Error = ErrorInit();
-
-	return lexer;
-}
-
-/*
-	Get Results
-
-	FUNCTIONS:
-
-	> LexerGetResult()
-	Use a Lexer object to generate a TokenArray object
-*/
-
-TokenArray* LexerGetResult(Lexer* lexer) {
-	TokenArray* tokens = TokenArrayInit();
-	TokenType type;
-	
-	do {
-		Token* token = GetNextToken(lexer);
-
-		if (lexer->Error->Exists) {
-			return tokens;
-		}
-
-		type = token->Type;
-		TokenArrayAppend(tokens, *token);
-		free(token);
-	} while (type != TOKEN_EOF);
-
-	return tokens;
-}
+
+#include <stdio.h> //
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "include/lexer.h"
+
+/*
+	Advancing
+
+	FUNCTIONS:
+
+	> Advance()
+	Advance to the next char in a Lexer's source string. Also sets the previous char in the Lexer
+
+	> PeekNext()
+	Peek ahead of the current Lexer's index without advancing
+
+	> SkipWhitespace()
+	Keep advancing until a character which is not a whitespace is found
+
+	> AdvanceWith()
+	Create a token from the current lexer's char and call Advance()
+*/
+
+static void Advance(Lexer* lexer) {
+	lexer->PrevChar = lexer->Char;
+
+	lexer->Char = lexer->Length > ++lexer->Index
+		? lexer->Source[lexer->Index]
+		: CHAR_EMPTY;
+}
+
+static char PeekNext(Lexer* lexer, ullong offset) {
+	return lexer->Length > (offset = lexer->Index + offset)
+		? lexer->Source[offset]
+		: CHAR_EMPTY;
+}
+
+static void SkipWhitespace(Lexer* lexer) {
+	while (isspace(lexer->Char)) {
+		Advance(lexer);
+	}
+}
+
+static Token* AdvanceWith(Lexer* lexer, TokenType type) {
+	Advance(lexer);
+	return TokenInit(NULL, type);
+}
+
+/*
+	String Evaluation
+
+	MACROS:
+
+	> COMPARE_KEYWORDS
+	Returns 1 if a string is equal to a keyword
+
+	FUNCTIONS:
+
+	> EvaluateKeyword
+	Returns the keyword that a string represents. If there is no keyword then the string is not a valid
+	keyword and an error is thrown in the Lexer
+*/
+
+#define COMPARE_KEYWORD(str, keyword) strcmp(str, keyword) == 0
+
+static TokenType EvaluateKeyword(Lexer* lexer, const char* str) {
+	if (COMPARE_KEYWORD(str, KEYWORD_TRUE)) {
+		return TOKEN_TRUE;
+	}
+	else if (COMPARE_KEYWORD(str, KEYWORD_FALSE)) {
+		return TOKEN_FALSE;
+	}
+	else if (COMPARE_KEYWORD(str, KEYWORD_NULL)) {
+		return TOKEN_NULL;
+	}
+
+	RAISE_FATAL_ERROR(
+		lexer,
+		ERR_KEYWORD_NOT_RECOGNISED,
+		str
+	);
+}
+
+/*
+	Data Building
+
+	MACROS:
+
+	> IS_STRING
+	Returns 1 if a char is a valid string type
+
+	> IS_KEYWORD
+	Returns 1 if a char is a valid keyword type
+
+	> IS_NUMERICAL
+	Returns 1 if a char is a valid numerical type
+
+	> IS_ESCAPE_SEQ
+	Returns 1 if a char is a valid escape sequence type (e.g., \n)
+
+	> ESCAPE_STRING
+	String escape \" is used to register a '"' character into the string
+
+	> ESCAPE_TAB
+	String escape \t is used to register a tab (multiple spaces) into the string
+
+	> ESCAPE_NEWLINE
+	String escape \n is used to register a newline into the string
+
+	> ESCAPE_BACKSLASH
+	String escape \\ is used to register a '\' into the string
+
+	> ESCAPE_RETURN, ESCAPE_BACKSPACE, ESCAPE_FORMFEED, ESCAPE_SLASH
+	String escapes \r, \b, \f and \/ are used to register a carriage return, backspace, form feed or '/' into the string
+
+	> ESCAPE_UNICODE
+	String escape \uXXXX is used to register a unicode code point (4 hex digits) into the string as UTF-8. A pair of
+	escapes holding a UTF-16 surrogate pair registers the one code point they encode
+
+	FUNCTIONS:
+
+	> ScanStringSize()
+	Scans the size of a string without advancing. This is used to tell the caller how many bytes should be
+	allocated when trying to store the string. Supports scanning for string escape characters such as '\n', the
+	char after a backslash is skipped so an escaped quote does not end the string
+
+	> ScanKeywordSize()
+	Scans the size of a keyword without advancing. This is used to tell the caller how many bytes should be
+	allocated when trying to store the keyword
+
+	> ScanNumberSize()
+	Scans the size of a number without advancing. This is used to tell the caller how many bytes should be
+	allocated when trying to store the number
+
+	> HexDigit()
+	Returns the value of a hex digit, or -1 if the char is not one
+
+	> ReadUnicodeEscape()
+	Reads the 4 hex digits of a \u escape 'offset' chars ahead of the Lexer's index. Returns -1 if they are not hex
+
+	> BuildUnicodeEscape()
+	Writes the UTF-8 bytes of a \u escape (or a surrogate pair of them) to a string and advances to its last hex
+	digit. Returns the number of bytes written, or 0 if the escape is invalid. A surrogate which is not part of a
+	pair has no UTF-8 form and is invalid, \u0000 is written as JSON_NUL_LEAD and JSON_NUL_TRAIL (see JsonString)
+
+	> BuildString()
+	Builds a string from characters in a Lexer's source by advancing. Supports recognition for string escape
+	characters such as '\n'. The length and hash of the string are computed as it is built and stored
+	in the Token, so the Parser can give keys their hash without scanning them again. The Token is marked Plain
+	when the string has no escapes or control chars, so it can be serialised without being escaped
+
+	> BuildKeyword()
+	Builds a keyword from characters in a Lexer's source by advancing
+
+	> BuildNumber()
+	Builds a number from characters in a Lexer's source by advancing
+*/
+
+#define IS_STRING(chr) chr != CHAR_QUOTE && chr != CHAR_EMPTY
+#define IS_KEYWORD(chr) isalpha(chr) && chr != CHAR_EMPTY
+#define IS_NUMERICAL(chr) isdigit(chr) || chr == '.' && chr != CHAR_EMPTY
+#define IS_ESCAPE_SEQ(chr) chr == 't' || chr == 'n' && chr != CHAR_EMPTY
+
+#define ESCAPE_STRING '"'
+#define ESCAPE_TAB 't'
+#define ESCAPE_NEWLINE 'n'
+#define ESCAPE_BACKSLASH '\\'
+#define ESCAPE_RETURN 'r'
+#define ESCAPE_BACKSPACE 'b'
+#define ESCAPE_FORMFEED 'f'
+#define ESCAPE_SLASH '/'
+#define ESCAPE_UNICODE 'u'
+
+static ullong ScanStringSize(Lexer* lexer) {
+	ullong size = 0;
+	ullong offset = 0;
+	char chr = lexer->Char;
+
+	while (IS_STRING(chr)) {
+		if (chr == CHAR_ESCAPE) {
+			offset++;
+		}
+
+		size++;
+		chr = PeekNext(lexer, ++offset);
+	}
+
+	return size;
+}
+
+static ullong ScanKeywordSize(Lexer* lexer) {
+	ullong size = 0;
+	ullong offset = 0;
+	char chr = lexer->Char;
+
+	while (IS_KEYWORD(chr)) {
+		size++;
+		chr = PeekNext(lexer, offset++);
+	}
+
+	return size;
+}
+
+static ullong ScanNumberSize(Lexer* lexer) {
+	ullong size = 0;
+	ullong offset = 0;
+	char chr = lexer->Char;
+
+	while (IS_NUMERICAL(chr)) {
+		size++;
+		chr = PeekNext(lexer, offset++);
+	}
+
+	return size;
+}
+
+static int HexDigit(char chr) {
+	if (chr >= '0' && chr <= '9') {
+		return chr - '0';
+	}
+	else if (chr >= 'a' && chr <= 'f') {
+		return chr - 'a' + 10;
+	}
+	else if (chr >= 'A' && chr <= 'F') {
+		return chr - 'A' + 10;
+	}
+
+	return -1;
+}
+
+static long ReadUnicodeEscape(Lexer* lexer, ullong offset) {
+	long code = 0;
+
+	for (ullong i = 0; i < 4; i++) {
+		int digit = HexDigit(PeekNext(lexer, offset + i));
+
+		if (digit < 0) {
+			return -1;
+		}
+
+		code = code * 16 + digit;
+	}
+
+	return code;
+}
+
+static ullong BuildUnicodeEscape(Lexer* lexer, char* value) {
+	long code = ReadUnicodeEscape(lexer, 2);
+	ullong advance = 5;
+
+	if (code < 0) {
+		return 0;
+	}
+
+	if (code >= 0xD800 && code <= 0xDBFF && PeekNext(lexer, 6) == CHAR_ESCAPE && PeekNext(lexer, 7) == ESCAPE_UNICODE) {
+		long low = ReadUnicodeEscape(lexer, 8);
+
+		if (low >= 0xDC00 && low <= 0xDFFF) {
+			code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+			advance = 11;
+		}
+	}
+
+	if (code >= 0xD800 && code <= 0xDFFF) {
+		return 0;
+	}
+
+	for (ullong i = 0; i < advance; i++) {
+		Advance(lexer);
+	}
+
+	if (code == 0) {
+		value[0] = (char)JSON_NUL_LEAD;
+		value[1] = (char)JSON_NUL_TRAIL;
+		return 2;
+	}
+	else if (code < 0x80) {
+		value[0] = (char)code;
+		return 1;
+	}
+	else if (code < 0x800) {
+		value[0] = (char)(0xC0 | (code >> 6));
+		value[1] = (char)(0x80 | (code & 0x3F));
+		return 2;
+	}
+	else if (code < 0x10000) {
+		value[0] = (char)(0xE0 | (code >> 12));
+		value[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+		value[2] = (char)(0x80 | (code & 0x3F));
+		return 3;
+	}
+
+	value[0] = (char)(0xF0 | (code >> 18));
+	value[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+	value[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+	value[3] = (char)(0x80 | (code & 0x3F));
+	return 4;
+}
+
+static Token* BuildString(Lexer* lexer) {
+	ullong size = ScanStringSize(lexer);
+	char* value = JsonMalloc(size + 1);
+	ullong index = 0;
+	ullong hash = JSON_HASH_OFFSET;
+	int plain = TRUE;
+	
+	while (IS_STRING(lexer->Char)) {
+		if (lexer->Char == CHAR_ESCAPE) {
+			char escape = PeekNext(lexer, 1);
+			plain = plain && escape == ESCAPE_SLASH;
+
+			switch (escape) {
+				case ESCAPE_STRING:
+					value[index++] = CHAR_ESCAPE_QUOTE;
+					Advance(lexer);
+					break;
+				case ESCAPE_TAB:
+					value[index++] = CHAR_ESCAPE_TAB;
+					Advance(lexer);
+					break;
+				case ESCAPE_NEWLINE:
+					value[index++] = CHAR_ESCAPE_NEWLINE;
+					Advance(lexer);
+					break;
+				case ESCAPE_BACKSLASH:
+					value[index++] = CHAR_ESCAPE;
+					Advance(lexer);
+					break;
+				case ESCAPE_RETURN:
+					value[index++] = CHAR_ESCAPE_RETURN;
+					Advance(lexer);
+					break;
+				case ESCAPE_BACKSPACE:
+					value[index++] = CHAR_ESCAPE_BACKSPACE;
+					Advance(lexer);
+					break;
+				case ESCAPE_FORMFEED:
+					value[index++] = CHAR_ESCAPE_FORMFEED;
+					Advance(lexer);
+					break;
+				case ESCAPE_SLASH:
+					value[index++] = CHAR_ESCAPE_SLASH;
+					Advance(lexer);
+					break;
+				case ESCAPE_UNICODE:
+					{
+						ullong bytes = BuildUnicodeEscape(lexer, value + index);
+
+						if (bytes > 0) {
+							for (ullong i = 0; i + 1 < bytes; i++) {
+								hash = JsonHashStep(hash, value[index++]);
+							}
+
+							index++;
+							break;
+						}
+
+						RAISE_FATAL_ERROR(
+							lexer,
+							ERR_INVALID_UNICODE_ESCAPE
+						);
+
+						value[index] = '\0';
+						return TokenInit(value, TOKEN_STRING);
+					}
+				default:
+					{
+						RAISE_FATAL_ERROR(
+							lexer,
+							ERR_UNTERMINATED_STRING_LIERAL
+						);
+					}
+
+					value[index] = '\0';
+					return TokenInit(value, TOKEN_STRING);
+			}
+		}
+		else {
+			plain = plain && (unsigned char)lexer->Char >= 0x20;
+			value[index++] = lexer->Char;
+		}
+
+		hash = JsonHashStep(hash, value[index - 1]);
+		Advance(lexer);
+	}
+
+	value[index] = '\0';
+
+	Token* token = TokenInit(value, TOKEN_STRING);
+	token->Length = index;
+	token->Hash = hash;
+	token->Plain = plain;
+	return token;
+}
+
+static Token* BuildKeyword(Lexer* lexer) {
+	ullong size = ScanKeywordSize(lexer);
+	char* value = JsonMalloc(size + 1);
+	int index = 0;
+	
+	while (IS_KEYWORD(lexer->Char)) {
+		value[index++] = lexer->Char;
+		Advance(lexer);
+	}
+
+	value[index] = '\0';
+	TokenType type = EvaluateKeyword(lexer, value);
+	JsonFree(value);
+
+	return TokenInit(NULL, type);
+}
+
+static Token* BuildNumber(Lexer* lexer) {
+	ullong size = ScanNumberSize(lexer);
+	char* value = JsonMalloc(size + 1);
+	int index = 0;
+	int decimals = 0;
+
+	while (IS_NUMERICAL(lexer->Char)) {
+		value[index++] = lexer->Char;
+		Advance(lexer);
+
+		if (lexer->Char == '.') {
+			decimals++;
+		}
+	}
+
+	value[index] = '\0';
+	return TokenInit(value, decimals ? TOKEN_FLOAT : TOKEN_INT);
+}
+
+/*
+	Reading Tokens
+
+	FUNCTIONS:
+
+	> GetNextToken()
+	Gets the next token from the current character in a Lexer's source string. Data can be built off of these characters,
+	such as (e.g., strings, keywords and numbers) if it is appropriate to do so. 
+*/
+
+Token* GetNextToken(Lexer* lexer) {
+	SkipWhitespace(lexer);
+
+	switch (lexer->Char) {
+		case CHAR_LCURLY:
+			return AdvanceWith(lexer, TOKEN_LCURLY);
+		case CHAR_RCURLY:
+			return AdvanceWith(lexer, TOKEN_RCURLY);
+		case CHAR_LBRACKET:
+			return AdvanceWith(lexer, TOKEN_LBRACKET);
+		case CHAR_RBRACKET:
+			return AdvanceWith(lexer, TOKEN_RBRACKET);
+		case CHAR_COLON:
+			return AdvanceWith(lexer, TOKEN_COLON);
+		case CHAR_COMMA:
+			return AdvanceWith(lexer, TOKEN_COMMA);
+		case CHAR_QUOTE:
+			return AdvanceWith(lexer, TOKEN_QUOTE);
+		case CHAR_MINUS:
+			return AdvanceWith(lexer, TOKEN_MINUS);
+		case CHAR_EMPTY:
+			return TokenInit(NULL, TOKEN_EOF);
+	}
+
+	if (lexer->PrevChar == CHAR_QUOTE) {
+		return BuildString(lexer);
+	}
+	else if (IS_KEYWORD(lexer->Char)) {
+		return BuildKeyword(lexer);
+	}
+	else if (IS_NUMERICAL(lexer->Char)) {
+		return BuildNumber(lexer);
+	}
+
+	RAISE_FATAL_ERROR(lexer, ERR_TOKEN_NOT_RECOGNISED, lexer->Char);
+}
+
+/*
+	Initializing Data
+
+	FUNCTIONS:
+
+	> LexerInit()
+	Initialize a Lexer object
+*/
+
+Lexer* LexerInit(const char* source) {
+	Lexer* lexer = JsonCalloc(1, sizeof(Lexer));
+	lexer->Source = source;
+	lexer->Length = strlen(source);
+	lexer->Index = 0;
+	lexer->Char = source[0];
+	lexer->Error = ErrorInit();
+
+	return lexer;
+}
+
+/*
+	Get Results
+
+	FUNCTIONS:
+
+	> LexerGetResult()
+	Use a Lexer object to generate a TokenArray object
+*/
+
+TokenArray* LexerGetResult(Lexer* lexer) {
+	TokenArray* tokens = TokenArrayInit();
+	TokenType type;
+	
+	do {
+		Token* token = GetNextToken(lexer);
+
+		if (lexer->Error->Exists) {
+			return tokens;
+		}
+
+		type = token->Type;
+		TokenArrayAppend(tokens, *token);
+		JsonFree(token);
+	} while (type != TOKEN_EOF);
+
+	return tokens;
+}
@@ -1,246 +1,395 @@
-
-#include <stdlib.h>
-#include "include/parser.h"
-#include "include/converters.h"
-
-static JsonList* ParseList(Parser* parser);
-static JsonExpr* ParseExpr(Parser* parser);
-
-/*
-	> Advancing
-
-	MACROS:
-
-	> ADVANCE_NO_ARGS
-	Used for skipping a TokenType check in Advance()
-
-	FUNCTIONS:
-
-	> Advance()
-	Advance to the next token in a Parser's TokenArray. Also asserts the type of the current TokenType to ensure
-	that unexpected TokenTypes do not occur (for example, if the caller is expecting the current TokenType to be
-	a TOKEN_QUOTE but it is a TOKEN_COMMA it will raise an error in the Parser. ADVANCE_NO_ARGS can be passed in
-	when the function caller wants this check to be skipped
-*/
-
-#define ADVANCE_NO_ARGS -1
-
-static void Advance(Parser* parser, TokenType type) {
-	if (type != ADVANCE_NO_ARGS) {
-		ASSERT(
-			parser,
-			parser->Token->Type == type,
-			ERR_UNEXPECTED_TYPE,
-			TokenTypeToString(parser->Token->Type),
-			TokenTypeToString(type)
-		);
-	}
-
-	parser->Token = parser->Tokens->Length > ++parser->Index
-		? &parser->Tokens->Buffer[parser->Index]
-		: &parser->Tokens->Buffer[parser->Tokens->Length - 1];
-}
-
-/*
-	Parsing
-
-	FUNCTIONS:
-
-	> ParseString()
-	Create a JsonString from Tokens in a Parser's TokenArray. Strings must be wrapped in quotes. Supports empty strings. 
-
-	> ParseValue()
-	Create a JsonValue from Tokens in a Parser's TokenArray. 
-
-	> ParsePair()
-	Create a JsonPair from Tokens in a Parser's TokenArray
-
-	> ParseList()
-	Create a JsonList from Tokens in a Parser's TokenArray
-
-	> ParseExpr()
-	Create a JsonExpr from Tokens in a Parser's TokenArray
-*/
-
-static JsonString ParseString(Parser* parser) {
-	Advance(parser, TOKEN_QUOTE);
-
-	if (parser->Token->Type == TOKEN_QUOTE) {
-		Advance(parser, TOKEN_QUOTE);
-		return AllocJsonString("");
-	}
-
-	ASSERT(
-		parser,
-		parser->Token->Type == TOKEN_STRING,
-		ERR_INVALID_SYNTAX
-	);
-
-	JsonString string = AllocJsonString(parser->Token->Value);
-	Advance(parser, TOKEN_STRING);
-	Advance(parser, TOKEN_QUOTE);
-
-	return string;
-}
-
-static JsonValue* ParseValue(Parser* parser) {
-	if (parser->Token->Type == TOKEN_LCURLY) {
-		JsonExpr* expr = ParseExpr(parser);
-		return JsonValueInit(expr, JSON_EXPR);
-	}
-	else if (parser->Token->Type == TOKEN_LBRACKET) {
-		JsonList* list = ParseList(parser);
-		return JsonValueInit(list, JSON_LIST);
-	}
-	else if (parser->Token->Type == TOKEN_QUOTE) {
-		JsonString string = ParseString(parser);
-		return JsonValueInit(string, JSON_STRING);
-	}
-	else if (parser->Token->Type == TOKEN_INT) {
-		JsonInt* integer;
-
-		ASSERT(
-			parser,
-			StringToInt(parser->Token->Value, &integer),
-			ERR_INVALID_INT, parser->Token->Value
-		);
-
-		Advance(parser, TOKEN_INT);
-		return JsonValueInit(integer, JSON_INT);
-	}
-	else if (parser->Token->Type == TOKEN_FLOAT) {
-		JsonFloat* flt;
-
-		ASSERT(
-			parser,
-			StringToFloat(parser->Token->Value, &flt),
-			ERR_INVALID_FLOAT, parser->Token->Value
-		);
-
-		Advance(parser, TOKEN_FLOAT);
-		return JsonValueInit(flt, JSON_FLOAT);
-	}
-	else if (parser->Token->Type == TOKEN_TRUE) {
-		Advance(parser, TOKEN_TRUE);
-		return JsonValueInit(NULL, JSON_TRUE);
-	}
-	else if (parser->Token->Type == TOKEN_FALSE) {
-		Advance(parser, TOKEN_FALSE);
-		return JsonValueInit(NULL, JSON_FALSE);
-	}
-	else if (parser->Token->Type == TOKEN_NULL) {
-		Advance(parser, TOKEN_NULL);
-		return JsonValueInit(NULL, JSON_NULL);
-	}
-	else if (parser->Token->Type == TOKEN_MINUS) {
-		Advance(parser, TOKEN_MINUS);
-		JsonValue* value = ParseValue(parser);
-
-		switch (value->Type) {
-			case JSON_INT:
-				*value->Data->Int *= -1;
-				return value;
-			case JSON_FLOAT:
-				*value->Data->Float *= -1;
-				return value;
-		}
-
-		RAISE_FATAL_ERROR(parser, ERR_INVALID_SYNTAX);
-	}
-}
-
-static JsonPair* ParsePair(Parser* parser) {
-	JsonString key = ParseString(parser);
-	Advance(parser, TOKEN_COLON);
-	JsonValue* value = ParseValue(parser);
-
-	return JsonPairInit(key, value);
-}
-
-static JsonList* ParseList(Parser* parser) {
-	JsonList* list = JsonListInit();
-	Advance(parser, TOKEN_LBRACKET);
-
-	if (parser->Token->Type == TOKEN_RBRACKET) {
-		Advance(parser, TOKEN_RBRACKET);
-		return list;
-	}
-
-	JsonValue* value = ParseValue(parser);
-	JsonValueArrayAppend(list, *value);
-	free(value);
-
-	while (parser->Token->Type == TOKEN_COMMA) {
-		Advance(parser, TOKEN_COMMA);
-		JsonValue* value = ParseValue(parser);
-		JsonValueArrayAppend(list, *value);
-		free(value);
-	}
-
-	Advance(parser, TOKEN_RBRACKET);
-	return list;
-}
-
-static JsonExpr* ParseExpr(Parser* parser) {
-	JsonExpr* expr = JsonExprInit();
-	Advance(parser, TOKEN_LCURLY);
-
-	if (parser->Token->Type == TOKEN_RCURLY) {
-		Advance(parser, TOKEN_RCURLY);
-		return expr;
-	}
-
-	JsonPair* pair = ParsePair(parser);
-	JsonPairArrayAppend(expr, *pair);
-	free(pair);
-
-	while (parser->Token->Type == TOKEN_COMMA) {
-		Advance(parser, TOKEN_COMMA);
-		JsonPair* pair = ParsePair(parser);
-		JsonPairArrayAppend(expr, *pair);
-		free(pair);
-	}
-
-	Advance(parser, TOKEN_RCURLY);
-	return expr;
-}
-
-/*
-	Initializing Data
-
-	FUNCTIONS:
-
-	> ParserInit()
-	Initialize a Parser object
-*/
-
-Parser* ParserInit(TokenArray* tokens) {
-	Parser* parser = calloc(1, sizeof(Parser));
-	parser->Tokens = tokens;
-	parser->Token = &tokens->Buffer[0];
-	parser->Index = 0;
-	parser->Error = ErrorInit();
-
-	return parser;
-}
-
-/*
-	Get Results
-
-	FUNCTIONS:
-
-	> ParserGetResult()
-	Use a Parser object to generate a JsonExpr object
-*/
-
-JsonExpr* ParserGetResult(Parser* parser) {
-	JsonExpr* expr = ParseExpr(parser);
-
-	ASSERT(
-		parser,
-		parser->Token->Type == TOKEN_EOF,
-		ERR_UNEXPECTED_EOF
-	);
-
-	return expr;
-}
+
+#include <stdlib.h>
+#include "include/parser.h"
+#include "include/converters.h"
+#include "include/shapes.h"
+#include "include/interning.h"
+
+static JsonList* ParseList(Parser* parser);
+static JsonExpr* ParseExpr(Parser* parser);
+
+/*
+	> Advancing
+
+	MACROS:
+
+	> ADVANCE_NO_ARGS
+	Used for skipping a TokenType check in Advance()
+
+	FUNCTIONS:
+
+	> Advance()
+	Advance to the next token in a Parser's TokenArray. Also asserts the type of the current TokenType to ensure
+	that unexpected TokenTypes do not occur (for example, if the caller is expecting the current TokenType to be
+	a TOKEN_QUOTE but it is a TOKEN_COMMA it will raise an error in the Parser. ADVANCE_NO_ARGS can be passed in
+	when the function caller wants this check to be skipped
+*/
+
+#define ADVANCE_NO_ARGS -1
+
+static void Advance(Parser* parser, TokenType type) {
+	if (type != ADVANCE_NO_ARGS) {
+		ASSERT(
+			parser,
+			parser->Token->Type == type,
+			ERR_UNEXPECTED_TYPE,
+			TokenTypeToString(parser->Token->Type),
+			TokenTypeToString(type)
+		);
+	}
+
+	parser->Token = parser->Tokens->Length > ++parser->Index
+		? &parser->Tokens->Buffer[parser->Index]
+		: &parser->Tokens->Buffer[parser->Tokens->Length - 1];
+}
+
+/*
+	Parsing
+
+	FUNCTIONS:
+
+	> CopyString()
+	Gives the Parser its own copy of a string: a new allocation, or a reference to the copy in the Parser's
+	JsonStringTable when it is in Intern mode. The string is looked up with the hash computed by the Lexer
+
+	> ParseString()
+	Create a JsonString from Tokens in a Parser's TokenArray. Strings must be wrapped in quotes. Supports empty strings. 
+	The length and hash which the Lexer computed for the string are written to 'length' and 'hash', and whether
+	the Lexer found it Plain (see JsonValue) to 'plain'. The string is interned when the Parser is in Intern mode
+
+	> ParseValue()
+	Create a JsonValue from Tokens in a Parser's TokenArray. 
+
+	> ParsePair()
+	Create a JsonPair from Tokens in a Parser's TokenArray. The key keeps the hash computed by the Lexer
+
+	> ParseList()
+	Create a JsonList from Tokens in a Parser's TokenArray
+
+	> ParseExpr()
+	Create a JsonExpr from Tokens in a Parser's TokenArray
+
+	NOTES:
+
+	When the Parser is in Presize mode, ParseList() and ParseExpr() reserve the exact number of elements counted by
+	ScanContainerSizes() so that the containers never have to grow while they are being filled
+
+	When the Parser is in Pack mode, a JsonList whose first element is a number is packed (see JsonListPack()). It
+	stays packed for as long as the following elements are numbers of the same type and is unpacked by the first
+	one which is not
+
+	When the Parser is in Share mode, every JsonExpr is passed to JsonShapeTableShare() once it has been parsed so
+	JsonExprs with the same keys share one key table (see shapes.c)
+
+	When the Parser is in Intern mode, every key and string value is interned (see interning.c), so repeated keys and
+	values share one copy and the JsonPairs and JsonValues holding them have KeyInterned or Interned set
+*/
+
+static JsonString CopyString(Parser* parser, const char* string, ullong length, ullong hash) {
+	if (string == NULL || !parser->Intern) {
+		return AllocJsonString(string);
+	}
+
+	return JsonStringTableIntern(parser->Strings, string, length, hash);
+}
+
+static JsonString ParseString(Parser* parser, ullong* length, ullong* hash, int* plain) {
+	Advance(parser, TOKEN_QUOTE);
+
+	if (parser->Token->Type == TOKEN_QUOTE) {
+		Advance(parser, TOKEN_QUOTE);
+		*length = 0;
+		*hash = JSON_HASH_OFFSET;
+		*plain = TRUE;
+		return CopyString(parser, "", 0, JSON_HASH_OFFSET);
+	}
+
+	ASSERT(
+		parser,
+		parser->Token->Type == TOKEN_STRING,
+		ERR_INVALID_SYNTAX
+	);
+
+	JsonString string = CopyString(parser, parser->Token->Value, parser->Token->Length, parser->Token->Hash);
+	*length = parser->Token->Length;
+	*hash = parser->Token->Hash;
+	*plain = parser->Token->Plain;
+	Advance(parser, TOKEN_STRING);
+	Advance(parser, TOKEN_QUOTE);
+
+	return string;
+}
+
+static JsonValue* ParseValue(Parser* parser) {
+	if (parser->Token->Type == TOKEN_LCURLY) {
+		JsonExpr* expr = ParseExpr(parser);
+		return JsonValueInit(expr, JSON_EXPR);
+	}
+	else if (parser->Token->Type == TOKEN_LBRACKET) {
+		JsonList* list = ParseList(parser);
+		return JsonValueInit(list, JSON_LIST);
+	}
+	else if (parser->Token->Type == TOKEN_QUOTE) {
+		ullong length, hash;
+		int plain;
+		JsonString string = ParseString(parser, &length, &hash, &plain);
+
+		JsonValue* value = JsonValueInit((char*)string, JSON_STRING);
+		value->Interned = parser->Intern;
+		value->Plain = plain;
+		return value;
+	}
+	else if (parser->Token->Type == TOKEN_INT) {
+		JsonInt* integer;
+
+		ASSERT(
+			parser,
+			StringToInt(parser->Token->Value, &integer),
+			ERR_INVALID_INT, parser->Token->Value
+		);
+
+		Advance(parser, TOKEN_INT);
+		return JsonValueInit(integer, JSON_INT);
+	}
+	else if (parser->Token->Type == TOKEN_FLOAT) {
+		JsonFloat* flt;
+
+		ASSERT(
+			parser,
+			StringToFloat(parser->Token->Value, &flt),
+			ERR_INVALID_FLOAT, parser->Token->Value
+		);
+
+		Advance(parser, TOKEN_FLOAT);
+		return JsonValueInit(flt, JSON_FLOAT);
+	}
+	else if (parser->Token->Type == TOKEN_TRUE) {
+		Advance(parser, TOKEN_TRUE);
+		return JsonValueInit(NULL, JSON_TRUE);
+	}
+	else if (parser->Token->Type == TOKEN_FALSE) {
+		Advance(parser, TOKEN_FALSE);
+		return JsonValueInit(NULL, JSON_FALSE);
+	}
+	else if (parser->Token->Type == TOKEN_NULL) {
+		Advance(parser, TOKEN_NULL);
+		return JsonValueInit(NULL, JSON_NULL);
+	}
+	else if (parser->Token->Type == TOKEN_MINUS) {
+		Advance(parser, TOKEN_MINUS);
+		JsonValue* value = ParseValue(parser);
+
+		switch (value->Type) {
+			case JSON_INT:
+				*value->Data->Int *= -1;
+				return value;
+			case JSON_FLOAT:
+				*value->Data->Float *= -1;
+				return value;
+		}
+
+		RAISE_FATAL_ERROR(parser, ERR_INVALID_SYNTAX);
+	}
+}
+
+static JsonPair* ParsePair(Parser* parser) {
+	ullong length, hash;
+	int plain;
+	JsonString key = ParseString(parser, &length, &hash, &plain);
+	Advance(parser, TOKEN_COLON);
+	JsonValue* value = ParseValue(parser);
+
+	JsonPair* pair = JsonPairInitHashed(key, length, hash, value);
+	pair->KeyInterned = parser->Intern;
+	return pair;
+}
+
+static JsonList* ParseList(Parser* parser) {
+	JsonList* list = JsonListInit();
+	ullong size = parser->Token->Length;
+
+	Advance(parser, TOKEN_LBRACKET);
+
+	if (parser->Token->Type == TOKEN_RBRACKET) {
+		Advance(parser, TOKEN_RBRACKET);
+		return list;
+	}
+
+	JsonValue* value = ParseValue(parser);
+
+	if (parser->Pack && (value->Type == JSON_INT || value->Type == JSON_FLOAT)) {
+		JsonListPack(list, value->Type == JSON_INT ? JSON_PACKED_INT : JSON_PACKED_FLOAT);
+	}
+
+	if (parser->Presize) {
+		JsonListReserve(list, size);
+	}
+
+	JsonValueArrayAppend(list, *value);
+	JsonPoolFree(value, sizeof(JsonValue));
+
+	while (parser->Token->Type == TOKEN_COMMA) {
+		Advance(parser, TOKEN_COMMA);
+		JsonValue* value = ParseValue(parser);
+		JsonValueArrayAppend(list, *value);
+		JsonPoolFree(value, sizeof(JsonValue));
+	}
+
+	Advance(parser, TOKEN_RBRACKET);
+	return list;
+}
+
+static JsonExpr* ParseExpr(Parser* parser) {
+	JsonExpr* expr = JsonExprInit();
+
+	if (parser->Presize) {
+		JsonExprReserve(expr, parser->Token->Length);
+	}
+
+	Advance(parser, TOKEN_LCURLY);
+
+	if (parser->Token->Type == TOKEN_RCURLY) {
+		Advance(parser, TOKEN_RCURLY);
+		return expr;
+	}
+
+	JsonPair* pair = ParsePair(parser);
+	JsonPairArrayAppend(expr, *pair);
+	JsonPoolFree(pair, sizeof(JsonPair));
+
+	while (parser->Token->Type == TOKEN_COMMA) {
+		Advance(parser, TOKEN_COMMA);
+		JsonPair* pair = ParsePair(parser);
+		JsonPairArrayAppend(expr, *pair);
+		JsonPoolFree(pair, sizeof(JsonPair));
+	}
+
+	if (parser->Share) {
+		JsonShapeTableShare(parser->Shapes, expr);
+	}
+
+	Advance(parser, TOKEN_RCURLY);
+	return expr;
+}
+
+/*
+	Structural Pre-Scan
+
+	FUNCTIONS:
+
+	> ScanContainerSizes()
+	Walks a Parser's TokenArray once and counts the elements inside of every list and expr. The count is stored in the
+	Length of the TOKEN_LBRACKET or TOKEN_LCURLY Token which opens the container. Commas are counted against the
+	innermost open container, plus one for any container which is not empty. Unbalanced brackets are left for the
+	Parser to report
+*/
+
+static void ScanContainerSizes(Parser* parser) {
+	TokenArray* tokens = parser->Tokens;
+	ullong* stack = NULL;
+	ullong depth = 0;
+	ullong capacity = 0;
+
+	for (ullong i = 0; i < tokens->Length; i++) {
+		Token* token = &tokens->Buffer[i];
+
+		switch (token->Type) {
+			case TOKEN_LBRACKET:
+			case TOKEN_LCURLY:
+				if (depth >= capacity) {
+					capacity = capacity > 0 ? capacity * 2 : 16;
+					stack = JsonRealloc(stack, sizeof(ullong) * capacity);
+				}
+
+				token->Length = 0;
+				stack[depth++] = i;
+				break;
+			case TOKEN_COMMA:
+				if (depth > 0) {
+					tokens->Buffer[stack[depth - 1]].Length++;
+				}
+				break;
+			case TOKEN_RBRACKET:
+			case TOKEN_RCURLY:
+				if (depth > 0) {
+					ullong open = stack[--depth];
+
+					if (open != i - 1) {
+						tokens->Buffer[open].Length++;
+					}
+				}
+				break;
+			default:
+				break;
+		}
+	}
+
+	JsonFree(stack);
+}
+
+/*
+	Initializing Data
+
+	FUNCTIONS:
+
+	> ParserInit()
+	Initialize a Parser object
+*/
+
+Parser* ParserInit(TokenArray* tokens) {
+	Parser* parser = JsonCalloc(1, sizeof(Parser));
+	parser->Tokens = tokens;
+	parser->Token = &tokens->Buffer[0];
+	parser->Index = 0;
+	parser->Error = ErrorInit();
+
+	return parser;
+}
+
+/*
+	Get Results
+
+	FUNCTIONS:
+
+	> ParserGetResult()
+	Use a Parser object to generate a JsonExpr object
+	If the Parser is in Presize mode the container sizes are scanned before parsing
+	If the Parser is in Share mode it keeps a JsonShapeTable for as long as it parses
+	If the Parser is in Intern mode without a shared JsonStringTable it keeps one for as long as it parses
+*/
+
+JsonExpr* ParserGetResult(Parser* parser) {
+	if (parser->Presize) {
+		ScanContainerSizes(parser);
+	}
+
+	if (parser->Share) {
+		parser->Shapes = JsonShapeTableInit();
+	}
+
+	int ownStrings = parser->Intern && parser->Strings == NULL;
+
+	if (ownStrings) {
+		parser->Strings = JsonStringTableInit();
+	}
+
+	JsonExpr* expr = ParseExpr(parser);
+
+	if (parser->Share) {
+		JsonShapeTableDelete(parser->Shapes);
+		parser->Shapes = NULL;
+	}
+
+	if (ownStrings) {
+		JsonStringTableDelete(parser->Strings);
+		parser->Strings = NULL;
+	}
+
+	ASSERT(
+		parser,
+		parser->Token->Type == TOKEN_EOF,
+		ERR_UNEXPECTED_EOF
+	);
+
+	return expr;
+}
@@ -0,0 +1,1047 @@
+
+#include <stdlib.h>
+#include <string.h>
+#include "include/persistent.h"
+
+#define SUCCESS 1
+#define FAILURE 0
+#define TRUE 1
+#define FALSE 0
+
+/*
+	Trie Nodes
+
+	TYPES:
+
+	> PersistentHeader
+	Shared header of every node in a JsonPersistentExpr's trie. 'IsNode' tells a branch apart from a leaf
+
+	> PersistentLeaf
+	A single key/value pair. Leaves are shared between versions and never modified after they are made
+
+	> PersistentNode
+	A branch of the trie. 'Bitmap' has a bit set for every 5 bit hash fragment which has a child, the children are
+	stored packed in fragment order. Collision nodes hold leaves whose 64 bit hashes are identical and are searched
+	linearly
+
+	> PersistentVectorNode
+	A node of a JsonPersistentList's trie. Nodes at level 0 hold JsonPersistentValues, higher levels hold nodes
+
+	MACROS:
+
+	> TRIE_BITS
+	Number of hash or index bits used at each level of a trie
+
+	> TRIE_WIDTH
+	Maximum number of children of a trie node
+
+	> TRIE_MASK
+	Mask for taking the bits used at one level of a trie
+*/
+
+#define TRIE_BITS 5
+#define TRIE_WIDTH (1 << TRIE_BITS)
+#define TRIE_MASK (TRIE_WIDTH - 1)
+#define HASH_BITS 64
+
+typedef struct {
+	ullong RefCount;
+	int IsNode;
+} PersistentHeader;
+
+typedef struct {
+	PersistentHeader Header;
+	char* Key;
+	ullong KeyLength;
+	ullong KeyHash;
+	JsonPersistentValue* Value;
+} PersistentLeaf;
+
+typedef struct PersistentNode_t {
+	PersistentHeader Header;
+	uint Bitmap;
+	uint Length;
+	int Collision;
+	PersistentHeader* Children[];
+} PersistentNode;
+
+typedef struct PersistentVectorNode_t {
+	ullong RefCount;
+	void* Children[TRIE_WIDTH];
+} PersistentVectorNode;
+
+/*
+	Creating Values
+
+	FUNCTIONS:
+
+	> PersistentValueInit()
+	Initialize a JsonPersistentValue object with a reference count of 1
+
+	> JsonPersistentCreateString()
+	Creates a JsonPersistentValue which stores a copy of a string
+
+	> JsonPersistentCreateInt()
+	Creates a JsonPersistentValue which stores an int
+
+	> JsonPersistentCreateFloat()
+	Creates a JsonPersistentValue which stores a float
+
+	> JsonPersistentCreateKeyword()
+	Creates a JsonPersistentValue which stores a keyword (true, false or null)
+
+	> JsonPersistentCreateExpr()
+	Creates a JsonPersistentValue which stores a JsonPersistentExpr
+	Takes over the caller's reference to the JsonPersistentExpr
+
+	> JsonPersistentCreateList()
+	Creates a JsonPersistentValue which stores a JsonPersistentList
+	Takes over the caller's reference to the JsonPersistentList
+*/
+
+static JsonPersistentValue* PersistentValueInit(JsonType type) {
+	JsonPersistentValue* value = JsonCalloc(1, sizeof(JsonPersistentValue));
+	value->RefCount = 1;
+	value->Type = type;
+
+	return value;
+}
+
+JsonPersistentValue* JsonPersistentCreateString(JsonString string) {
+	JsonPersistentValue* value = PersistentValueInit(JSON_STRING);
+	value->Data.String = AllocJsonString(string);
+
+	return value;
+}
+
+JsonPersistentValue* JsonPersistentCreateInt(JsonInt integer) {
+	JsonPersistentValue* value = PersistentValueInit(JSON_INT);
+	value->Data.Int = integer;
+
+	return value;
+}
+
+JsonPersistentValue* JsonPersistentCreateFloat(JsonFloat flt) {
+	JsonPersistentValue* value = PersistentValueInit(JSON_FLOAT);
+	value->Data.Float = flt;
+
+	return value;
+}
+
+JsonPersistentValue* JsonPersistentCreateKeyword(JsonType keyword) {
+	return PersistentValueInit(keyword);
+}
+
+JsonPersistentValue* JsonPersistentCreateExpr(JsonPersistentExpr* expr) {
+	JsonPersistentValue* value = PersistentValueInit(JSON_EXPR);
+	value->Data.Expr = expr;
+
+	return value;
+}
+
+JsonPersistentValue* JsonPersistentCreateList(JsonPersistentList* list) {
+	JsonPersistentValue* value = PersistentValueInit(JSON_LIST);
+	value->Data.List = list;
+
+	return value;
+}
+
+/*
+	Reference Counting
+
+	FUNCTIONS:
+
+	> JsonPersistentValueRetain(), JsonPersistentExprRetain(), JsonPersistentListRetain()
+	Adds a reference to an object and returns it
+
+	> JsonPersistentValueRelease(), JsonPersistentExprRelease(), JsonPersistentListRelease()
+	Removes a reference from an object. The object is deleted when its last reference is released, which releases
+	everything it refers to
+
+	> HeaderRelease()
+	Removes a reference from a node or leaf in a JsonPersistentExpr's trie
+
+	> VectorNodeRelease()
+	Removes a reference from a node in a JsonPersistentList's trie. The level is needed to know whether the children
+	are nodes or values
+*/
+
+static void HeaderRelease(PersistentHeader* header);
+static void VectorNodeRelease(PersistentVectorNode* node, uint level);
+
+JsonPersistentValue* JsonPersistentValueRetain(JsonPersistentValue* value) {
+	value->RefCount++;
+	return value;
+}
+
+JsonPersistentExpr* JsonPersistentExprRetain(JsonPersistentExpr* expr) {
+	expr->RefCount++;
+	return expr;
+}
+
+JsonPersistentList* JsonPersistentListRetain(JsonPersistentList* list) {
+	list->RefCount++;
+	return list;
+}
+
+void JsonPersistentValueRelease(JsonPersistentValue* value) {
+	if (--value->RefCount > 0) {
+		return;
+	}
+
+	switch (value->Type) {
+		case JSON_EXPR:
+			JsonPersistentExprRelease(value->Data.Expr);
+			break;
+		case JSON_LIST:
+			JsonPersistentListRelease(value->Data.List);
+			break;
+		case JSON_STRING:
+			JsonFree(value->Data.String);
+			break;
+		default:
+			break;
+	}
+
+	JsonFree(value);
+}
+
+void JsonPersistentExprRelease(JsonPersistentExpr* expr) {
+	if (--expr->RefCount > 0) {
+		return;
+	}
+
+	if (expr->Root != NULL) {
+		HeaderRelease(&expr->Root->Header);
+	}
+
+	JsonFree(expr);
+}
+
+void JsonPersistentListRelease(JsonPersistentList* list) {
+	if (--list->RefCount > 0) {
+		return;
+	}
+
+	if (list->Root != NULL) {
+		VectorNodeRelease(list->Root, list->Shift);
+	}
+
+	JsonFree(list);
+}
+
+static void HeaderRelease(PersistentHeader* header) {
+	if (--header->RefCount > 0) {
+		return;
+	}
+
+	if (header->IsNode) {
+		PersistentNode* node = (PersistentNode*)header;
+
+		for (uint i = 0; i < node->Length; i++) {
+			HeaderRelease(node->Children[i]);
+		}
+	}
+	else {
+		PersistentLeaf* leaf = (PersistentLeaf*)header;
+		JsonFree(leaf->Key);
+		JsonPersistentValueRelease(leaf->Value);
+	}
+
+	JsonFree(header);
+}
+
+static void VectorNodeRelease(PersistentVectorNode* node, uint level) {
+	if (--node->RefCount > 0) {
+		return;
+	}
+
+	for (uint i = 0; i < TRIE_WIDTH; i++) {
+		if (node->Children[i] == NULL) {
+			continue;
+		}
+
+		if (level > 0) {
+			VectorNodeRelease(node->Children[i], level - TRIE_BITS);
+		}
+		else {
+			JsonPersistentValueRelease(node->Children[i]);
+		}
+	}
+
+	JsonFree(node);
+}
+
+/*
+	Expr Trie
+
+	FUNCTIONS:
+
+	> PopCount()
+	Counts the bits which are set in a bitmap, used to find where a child is stored in a PersistentNode
+
+	> Fragment()
+	Returns the 5 bit piece of a hash used at a specific shift
+
+	> LeafInit()
+	Creates a leaf which owns a copy of the key and takes over the reference to the value
+
+	> NodeInit()
+	Creates an empty PersistentNode with room for 'length' children
+
+	> NodeCopy()
+	Creates a copy of a PersistentNode with room for 'extra' more children. Every child is shared with the original
+	node, so the child references are retained
+
+	> NodeReplace()
+	Creates a copy of a PersistentNode where the child at a position is replaced
+
+	> NodeInsert()
+	Creates a copy of a PersistentNode with a new child inserted at a position
+
+	> NodeErase()
+	Creates a copy of a PersistentNode with the child at a position taken out
+
+	> MergeLeaves()
+	Creates the smallest subtree which holds two leaves whose hashes share every fragment above 'shift'
+
+	> KeysMatch()
+	Returns 1 if a leaf has a specific key
+
+	> NodeSet()
+	Returns a copy of a trie with a leaf added or replaced. Only the nodes on the path to the leaf are copied, every
+	other node is shared with the original trie
+
+	> NodeRemove()
+	Returns a copy of a trie with a key taken out, or the same trie with an extra reference if the key is not in it.
+	Can return a leaf if a collision node is left with a single leaf, or NULL if the trie is left empty
+
+	> NodeGet()
+	Finds the leaf for a key in a trie
+
+	> NodeForEach()
+	Calls a callback for every leaf in a trie
+*/
+
+static uint PopCount(uint bitmap) {
+	bitmap = bitmap - ((bitmap >> 1) & 0x55555555);
+	bitmap = (bitmap & 0x33333333) + ((bitmap >> 2) & 0x33333333);
+	return (((bitmap + (bitmap >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+}
+
+static uint Fragment(ullong hash, uint shift) {
+	return (uint)(hash >> shift) & TRIE_MASK;
+}
+
+static PersistentLeaf* LeafInit(const char* key, ullong length, ullong hash, JsonPersistentValue* value) {
+	PersistentLeaf* leaf = JsonCalloc(1, sizeof(PersistentLeaf));
+	leaf->Header.RefCount = 1;
+	leaf->Header.IsNode = FALSE;
+	leaf->Key = JsonMalloc(length + 1);
+	leaf->KeyLength = length;
+	leaf->KeyHash = hash;
+	leaf->Value = value;
+
+	memcpy(leaf->Key, key, length);
+	leaf->Key[length] = '\0';
+
+	return leaf;
+}
+
+static PersistentNode* NodeInit(uint length) {
+	PersistentNode* node = JsonCalloc(1, sizeof(PersistentNode) + sizeof(PersistentHeader*) * length);
+	node->Header.RefCount = 1;
+	node->Header.IsNode = TRUE;
+	node->Length = length;
+
+	return node;
+}
+
+static PersistentNode* NodeCopy(PersistentNode* node, uint extra) {
+	PersistentNode* copy = NodeInit(node->Length + extra);
+	copy->Bitmap = node->Bitmap;
+	copy->Collision = node->Collision;
+	copy->Length = node->Length;
+
+	for (uint i = 0; i < node->Length; i++) {
+		copy->Children[i] = node->Children[i];
+		copy->Children[i]->RefCount++;
+	}
+
+	return copy;
+}
+
+static PersistentNode* NodeReplace(PersistentNode* node, uint pos, PersistentHeader* child) {
+	PersistentNode* copy = NodeCopy(node, 0);
+	HeaderRelease(copy->Children[pos]);
+	copy->Children[pos] = child;
+
+	return copy;
+}
+
+static PersistentNode* NodeInsert(PersistentNode* node, uint pos, PersistentHeader* child) {
+	PersistentNode* copy = NodeCopy(node, 1);
+	memmove(&copy->Children[pos + 1], &copy->Children[pos], sizeof(PersistentHeader*) * (node->Length - pos));
+	copy->Children[pos] = child;
+	copy->Length++;
+
+	return copy;
+}
+
+static PersistentNode* NodeErase(PersistentNode* node, uint pos) {
+	PersistentNode* copy = NodeCopy(node, 0);
+	HeaderRelease(copy->Children[pos]);
+	memmove(&copy->Children[pos], &copy->Children[pos + 1], sizeof(PersistentHeader*) * (node->Length - pos - 1));
+	copy->Length--;
+
+	return copy;
+}
+
+static PersistentNode* MergeLeaves(PersistentLeaf* leaf1, PersistentLeaf* leaf2, uint shift) {
+	if (shift >= HASH_BITS) {
+		PersistentNode* node = NodeInit(2);
+		node->Collision = TRUE;
+		node->Children[0] = &leaf1->Header;
+		node->Children[1] = &leaf2->Header;
+
+		return node;
+	}
+
+	uint fragment1 = Fragment(leaf1->KeyHash, shift);
+	uint fragment2 = Fragment(leaf2->KeyHash, shift);
+
+	if (fragment1 == fragment2) {
+		PersistentNode* node = NodeInit(1);
+		node->Bitmap = 1u << fragment1;
+		node->Children[0] = &MergeLeaves(leaf1, leaf2, shift + TRIE_BITS)->Header;
+
+		return node;
+	}
+
+	PersistentNode* node = NodeInit(2);
+	node->Bitmap = (1u << fragment1) | (1u << fragment2);
+	node->Children[fragment1 < fragment2 ? 0 : 1] = &leaf1->Header;
+	node->Children[fragment1 < fragment2 ? 1 : 0] = &leaf2->Header;
+
+	return node;
+}
+
+static int KeysMatch(PersistentLeaf* leaf, const char* key, ullong length, ullong hash) {
+	return leaf->KeyHash == hash && leaf->KeyLength == length && memcmp(leaf->Key, key, length) == 0;
+}
+
+static PersistentNode* NodeSet(PersistentNode* node, uint shift, PersistentLeaf* leaf, int* replaced) {
+	if (node->Collision) {
+		for (uint i = 0; i < node->Length; i++) {
+			PersistentLeaf* other = (PersistentLeaf*)node->Children[i];
+
+			if (KeysMatch(other, leaf->Key, leaf->KeyLength, leaf->KeyHash)) {
+				*replaced = TRUE;
+				return NodeReplace(node, i, &leaf->Header);
+			}
+		}
+
+		return NodeInsert(node, node->Length, &leaf->Header);
+	}
+
+	uint bit = 1u << Fragment(leaf->KeyHash, shift);
+	uint pos = PopCount(node->Bitmap & (bit - 1));
+
+	if (!(node->Bitmap & bit)) {
+		PersistentNode* copy = NodeInsert(node, pos, &leaf->Header);
+		copy->Bitmap |= bit;
+
+		return copy;
+	}
+
+	PersistentHeader* child = node->Children[pos];
+
+	if (child->IsNode) {
+		PersistentNode* updated = NodeSet((PersistentNode*)child, shift + TRIE_BITS, leaf, replaced);
+		return NodeReplace(node, pos, &updated->Header);
+	}
+
+	PersistentLeaf* other = (PersistentLeaf*)child;
+
+	if (KeysMatch(other, leaf->Key, leaf->KeyLength, leaf->KeyHash)) {
+		*replaced = TRUE;
+		return NodeReplace(node, pos, &leaf->Header);
+	}
+
+	other->Header.RefCount++;
+	PersistentNode* merged = MergeLeaves(other, leaf, shift + TRIE_BITS);
+	return NodeReplace(node, pos, &merged->Header);
+}
+
+static PersistentHeader* NodeRemove(PersistentNode* node, uint shift, const char* key, ullong length, ullong hash) {
+	uint pos = 0;
+	PersistentHeader* child = NULL;
+
+	if (node->Collision) {
+		for (uint i = 0; i < node->Length; i++) {
+			if (KeysMatch((PersistentLeaf*)node->Children[i], key, length, hash)) {
+				child = node->Children[i];
+				pos = i;
+				break;
+			}
+		}
+
+		if (child == NULL) {
+			node->Header.RefCount++;
+			return &node->Header;
+		}
+
+		if (node->Length == 2) {
+			PersistentHeader* remaining = node->Children[1 - pos];
+			remaining->RefCount++;
+			return remaining;
+		}
+
+		return &NodeErase(node, pos)->Header;
+	}
+
+	uint bit = 1u << Fragment(hash, shift);
+
+	if (!(node->Bitmap & bit)) {
+		node->Header.RefCount++;
+		return &node->Header;
+	}
+
+	pos = PopCount(node->Bitmap & (bit - 1));
+	child = node->Children[pos];
+
+	if (child->IsNode) {
+		PersistentHeader* updated = NodeRemove((PersistentNode*)child, shift + TRIE_BITS, key, length, hash);
+
+		if (updated == child) {
+			HeaderRelease(updated);
+			node->Header.RefCount++;
+			return &node->Header;
+		}
+
+		if (updated != NULL) {
+			return &NodeReplace(node, pos, updated)->Header;
+		}
+	}
+	else if (!KeysMatch((PersistentLeaf*)child, key, length, hash)) {
+		node->Header.RefCount++;
+		return &node->Header;
+	}
+
+	if (node->Length == 1) {
+		return NULL;
+	}
+
+	PersistentNode* copy = NodeErase(node, pos);
+	copy->Bitmap &= ~bit;
+
+	return &copy->Header;
+}
+
+static PersistentLeaf* NodeGet(PersistentNode* node, uint shift, const char* key, ullong length, ullong hash) {
+	while (node != NULL) {
+		PersistentHeader* child;
+
+		if (node->Collision) {
+			for (uint i = 0; i < node->Length; i++) {
+				if (KeysMatch((PersistentLeaf*)node->Children[i], key, length, hash)) {
+					return (PersistentLeaf*)node->Children[i];
+				}
+			}
+
+			return NULL;
+		}
+
+		uint bit = 1u << Fragment(hash, shift);
+
+		if (!(node->Bitmap & bit)) {
+			return NULL;
+		}
+
+		child = node->Children[PopCount(node->Bitmap & (bit - 1))];
+
+		if (!child->IsNode) {
+			PersistentLeaf* leaf = (PersistentLeaf*)child;
+			return KeysMatch(leaf, key, length, hash) ? leaf : NULL;
+		}
+
+		node = (PersistentNode*)child;
+		shift += TRIE_BITS;
+	}
+
+	return NULL;
+}
+
+static void NodeForEach(PersistentHeader* header, JsonPersistentPairCallback callback, void* data) {
+	if (!header->IsNode) {
+		PersistentLeaf* leaf = (PersistentLeaf*)header;
+		callback(leaf->Key, leaf->Value, data);
+		return;
+	}
+
+	PersistentNode* node = (PersistentNode*)header;
+
+	for (uint i = 0; i < node->Length; i++) {
+		NodeForEach(node->Children[i], callback, data);
+	}
+}
+
+/*
+	Persistent Expr
+
+	FUNCTIONS:
+
+	> JsonPersistentExprInit()
+	Initialize an empty JsonPersistentExpr object
+
+	> JsonPersistentGet()
+	Gets the value which belongs to a key in a JsonPersistentExpr
+	Returns SUCCESS if the value was found
+	Returns FAILURE if the value was not found
+
+	> JsonPersistentGetHashed()
+	Same as JsonPersistentGet() but uses a key length and hash computed by the caller (see JsonHashKey())
+
+	> JsonPersistentSet()
+	Returns a new version of a JsonPersistentExpr where a key equals a value. The original version is not changed and
+	shares every node which is not on the path to the key with the new version
+	Takes over the caller's reference to the value
+
+	> JsonPersistentRemoveKey()
+	Returns a new version of a JsonPersistentExpr without a key. If the key does not exist the same version is
+	returned with an extra reference
+
+	> JsonPersistentForEach()
+	Calls a callback for every pair in a JsonPersistentExpr
+
+	NOTES:
+
+	Pairs are stored by the hash of their key, so JsonPersistentForEach() does not visit pairs in the order they
+	were added. Lookups, sets and removals only touch one node per 5 bits of hash, so making a new version costs
+	O(log32 n) nodes no matter how large the JsonPersistentExpr is
+*/
+
+static JsonPersistentExpr* PersistentExprInit(PersistentNode* root, ullong length) {
+	JsonPersistentExpr* expr = JsonCalloc(1, sizeof(JsonPersistentExpr));
+	expr->RefCount = 1;
+	expr->Length = length;
+	expr->Root = root;
+
+	return expr;
+}
+
+JsonPersistentExpr* JsonPersistentExprInit() {
+	return PersistentExprInit(NULL, 0);
+}
+
+int JsonPersistentGet(JsonPersistentExpr* expr, const char* key, JsonPersistentValue** value) {
+	ullong length = strlen(key);
+	return JsonPersistentGetHashed(expr, key, length, JsonHashKey(key, length), value);
+}
+
+int JsonPersistentGetHashed(JsonPersistentExpr* expr, const char* key, ullong length, ullong hash, JsonPersistentValue** value) {
+	PersistentLeaf* leaf = NodeGet(expr->Root, 0, key, length, hash);
+
+	if (leaf == NULL) {
+		return FAILURE;
+	}
+
+	*value = leaf->Value;
+	return SUCCESS;
+}
+
+JsonPersistentExpr* JsonPersistentSet(JsonPersistentExpr* expr, const char* key, JsonPersistentValue* value) {
+	ullong length = strlen(key);
+	PersistentLeaf* leaf = LeafInit(key, length, JsonHashKey(key, length), value);
+
+	if (expr->Root == NULL) {
+		PersistentNode* root = NodeInit(1);
+		root->Bitmap = 1u << Fragment(leaf->KeyHash, 0);
+		root->Children[0] = &leaf->Header;
+
+		return PersistentExprInit(root, 1);
+	}
+
+	int replaced = FALSE;
+	PersistentNode* root = NodeSet(expr->Root, 0, leaf, &replaced);
+
+	return PersistentExprInit(root, replaced ? expr->Length : expr->Length + 1);
+}
+
+JsonPersistentExpr* JsonPersistentRemoveKey(JsonPersistentExpr* expr, const char* key) {
+	if (expr->Root == NULL) {
+		return JsonPersistentExprRetain(expr);
+	}
+
+	ullong length = strlen(key);
+	PersistentHeader* root = NodeRemove(expr->Root, 0, key, length, JsonHashKey(key, length));
+
+	if (root == &expr->Root->Header) {
+		HeaderRelease(root);
+		return JsonPersistentExprRetain(expr);
+	}
+
+	return PersistentExprInit((PersistentNode*)root, expr->Length - 1);
+}
+
+void JsonPersistentForEach(JsonPersistentExpr* expr, JsonPersistentPairCallback callback, void* data) {
+	if (expr->Root != NULL) {
+		NodeForEach(&expr->Root->Header, callback, data);
+	}
+}
+
+/*
+	List Trie
+
+	FUNCTIONS:
+
+	> VectorNodeCopy()
+	Creates a copy of a PersistentVectorNode which shares every child with the original node, or an empty node if
+	no node is passed in
+
+	> VectorNewPath()
+	Creates a chain of nodes from 'level' down to level 0 which holds a single value
+
+	> VectorPushTail()
+	Returns a copy of a trie with a value stored at 'index', where 'index' is one past the last element
+
+	> VectorAssoc()
+	Returns a copy of a trie with the value at 'index' replaced
+
+	> VectorPopTail()
+	Returns a copy of a trie without the value at 'index', where 'index' is the last element
+	Returns NULL if the node is left empty
+*/
+
+static PersistentVectorNode* VectorNodeCopy(PersistentVectorNode* node, uint level) {
+	PersistentVectorNode* copy = JsonCalloc(1, sizeof(PersistentVectorNode));
+	copy->RefCount = 1;
+
+	if (node == NULL) {
+		return copy;
+	}
+
+	for (uint i = 0; i < TRIE_WIDTH; i++) {
+		copy->Children[i] = node->Children[i];
+
+		if (copy->Children[i] == NULL) {
+			continue;
+		}
+
+		if (level > 0) {
+			((PersistentVectorNode*)copy->Children[i])->RefCount++;
+		}
+		else {
+			((JsonPersistentValue*)copy->Children[i])->RefCount++;
+		}
+	}
+
+	return copy;
+}
+
+static PersistentVectorNode* VectorNewPath(uint level, JsonPersistentValue* value) {
+	PersistentVectorNode* node = VectorNodeCopy(NULL, level);
+	node->Children[0] = level > 0 ? (void*)VectorNewPath(level - TRIE_BITS, value) : (void*)value;
+
+	return node;
+}
+
+static PersistentVectorNode* VectorPushTail(PersistentVectorNode* node, uint level, ullong index, JsonPersistentValue* value) {
+	PersistentVectorNode* copy = VectorNodeCopy(node, level);
+	uint sub = (index >> level) & TRIE_MASK;
+
+	if (level == 0) {
+		copy->Children[sub] = value;
+	}
+	else if (copy->Children[sub] != NULL) {
+		PersistentVectorNode* child = copy->Children[sub];
+		copy->Children[sub] = VectorPushTail(child, level - TRIE_BITS, index, value);
+		VectorNodeRelease(child, level - TRIE_BITS);
+	}
+	else {
+		copy->Children[sub] = VectorNewPath(level - TRIE_BITS, value);
+	}
+
+	return copy;
+}
+
+static PersistentVectorNode* VectorAssoc(PersistentVectorNode* node, uint level, ullong index, JsonPersistentValue* value) {
+	PersistentVectorNode* copy = VectorNodeCopy(node, level);
+	uint sub = (index >> level) & TRIE_MASK;
+
+	if (level == 0) {
+		JsonPersistentValueRelease(copy->Children[sub]);
+		copy->Children[sub] = value;
+	}
+	else {
+		PersistentVectorNode* child = copy->Children[sub];
+		copy->Children[sub] = VectorAssoc(child, level - TRIE_BITS, index, value);
+		VectorNodeRelease(child, level - TRIE_BITS);
+	}
+
+	return copy;
+}
+
+static PersistentVectorNode* VectorPopTail(PersistentVectorNode* node, uint level, ullong index) {
+	uint sub = (index >> level) & TRIE_MASK;
+
+	if (level > 0) {
+		PersistentVectorNode* child = VectorPopTail(node->Children[sub], level - TRIE_BITS, index);
+
+		if (child == NULL && sub == 0) {
+			return NULL;
+		}
+
+		PersistentVectorNode* copy = VectorNodeCopy(node, level);
+		VectorNodeRelease(copy->Children[sub], level - TRIE_BITS);
+		copy->Children[sub] = child;
+
+		return copy;
+	}
+
+	if (sub == 0) {
+		return NULL;
+	}
+
+	PersistentVectorNode* copy = VectorNodeCopy(node, level);
+	JsonPersistentValueRelease(copy->Children[sub]);
+	copy->Children[sub] = NULL;
+
+	return copy;
+}
+
+/*
+	Persistent List
+
+	FUNCTIONS:
+
+	> JsonPersistentListInit()
+	Initialize an empty JsonPersistentList object
+
+	> JsonPersistentGetElement()
+	Gets the element at an index in a JsonPersistentList
+	Returns FAILURE if the index is out of bounds
+
+	> JsonPersistentAppend()
+	Returns a new version of a JsonPersistentList with a value added to the end
+	Takes over the caller's reference to the value
+
+	> JsonPersistentSetElement()
+	Returns a new version of a JsonPersistentList with the element at an index replaced
+	Takes over the caller's reference to the value
+	Returns NULL if the index is out of bounds, in which case the caller keeps its reference to the value
+
+	> JsonPersistentRemoveLast()
+	Returns a new version of a JsonPersistentList without its last element
+
+	NOTES:
+
+	Every function which returns a new version only copies the O(log32 n) nodes on the path to the index, the rest
+	of the trie is shared with the original version
+*/
+
+static JsonPersistentList* PersistentListInit(PersistentVectorNode* root, uint shift, ullong length) {
+	JsonPersistentList* list = JsonCalloc(1, sizeof(JsonPersistentList));
+	list->RefCount = 1;
+	list->Root = root;
+	list->Shift = shift;
+	list->Length = length;
+
+	return list;
+}
+
+JsonPersistentList* JsonPersistentListInit() {
+	return PersistentListInit(NULL, 0, 0);
+}
+
+int JsonPersistentGetElement(JsonPersistentList* list, ullong index, JsonPersistentValue** value) {
+	if (index >= list->Length) {
+		return FAILURE;
+	}
+
+	PersistentVectorNode* node = list->Root;
+
+	for (uint level = list->Shift; level > 0; level -= TRIE_BITS) {
+		node = node->Children[(index >> level) & TRIE_MASK];
+	}
+
+	*value = node->Children[index & TRIE_MASK];
+	return SUCCESS;
+}
+
+JsonPersistentList* JsonPersistentAppend(JsonPersistentList* list, JsonPersistentValue* value) {
+	if (list->Root == NULL) {
+		return PersistentListInit(VectorNewPath(0, value), 0, 1);
+	}
+
+	if ((list->Length >> TRIE_BITS) >= (1ull << list->Shift)) {
+		PersistentVectorNode* root = VectorNodeCopy(NULL, list->Shift + TRIE_BITS);
+		root->Children[0] = list->Root;
+		root->Children[1] = VectorNewPath(list->Shift, value);
+		list->Root->RefCount++;
+
+		return PersistentListInit(root, list->Shift + TRIE_BITS, list->Length + 1);
+	}
+
+	PersistentVectorNode* root = VectorPushTail(list->Root, list->Shift, list->Length, value);
+	return PersistentListInit(root, list->Shift, list->Length + 1);
+}
+
+JsonPersistentList* JsonPersistentSetElement(JsonPersistentList* list, ullong index, JsonPersistentValue* value) {
+	if (index >= list->Length) {
+		return NULL;
+	}
+
+	PersistentVectorNode* root = VectorAssoc(list->Root, list->Shift, index, value);
+	return PersistentListInit(root, list->Shift, list->Length);
+}
+
+JsonPersistentList* JsonPersistentRemoveLast(JsonPersistentList* list) {
+	if (list->Length <= 1) {
+		return JsonPersistentListInit();
+	}
+
+	PersistentVectorNode* root = VectorPopTail(list->Root, list->Shift, list->Length - 1);
+	uint shift = list->Shift;
+
+	if (shift > 0 && root->Children[1] == NULL) {
+		PersistentVectorNode* child = root->Children[0];
+		child->RefCount++;
+		VectorNodeRelease(root, shift);
+
+		root = child;
+		shift -= TRIE_BITS;
+	}
+
+	return PersistentListInit(root, shift, list->Length - 1);
+}
+
+/*
+	Converting Data
+
+	FUNCTIONS:
+
+	> JsonValueToPersistent()
+	Creates a JsonPersistentValue from a JsonValue
+
+	> PersistentToJsonValue()
+	Creates a JsonValue from a JsonPersistentValue
+
+	> JsonExprToPersistent()
+	Creates a JsonPersistentExpr from a JsonExpr, used to make the first version of a document
+
+	> JsonListToPersistent()
+	Creates a JsonPersistentList from a JsonList
+
+	> JsonPersistentToExpr()
+	Creates a JsonExpr from a JsonPersistentExpr, used for serialising a version or for working with it using the
+	functions in json-parser.h. The JsonExpr has to be deleted by the caller
+
+	> JsonPersistentToList()
+	Creates a JsonList from a JsonPersistentList
+*/
+
+static JsonPersistentValue* JsonValueToPersistent(JsonValue* value) {
+	switch (value->Type) {
+		case JSON_EXPR:
+			return JsonPersistentCreateExpr(JsonExprToPersistent(value->Data->Expr));
+		case JSON_LIST:
+			return JsonPersistentCreateList(JsonListToPersistent(value->Data->List));
+		case JSON_STRING:
+			return JsonPersistentCreateString(value->Data->String);
+		case JSON_INT:
+			return JsonPersistentCreateInt(*value->Data->Int);
+		case JSON_FLOAT:
+			return JsonPersistentCreateFloat(*value->Data->Float);
+		default:
+			return JsonPersistentCreateKeyword(value->Type);
+	}
+}
+
+static JsonValue* PersistentToJsonValue(JsonPersistentValue* value) {
+	switch (value->Type) {
+		case JSON_EXPR:
+			return JsonValueInit(JsonPersistentToExpr(value->Data.Expr), JSON_EXPR);
+		case JSON_LIST:
+			return JsonValueInit(JsonPersistentToList(value->Data.List), JSON_LIST);
+		case JSON_STRING:
+			return JsonValueInit(AllocJsonString(value->Data.String), JSON_STRING);
+		case JSON_INT:
+			return JsonValueInit(AllocJsonInt(value->Data.Int), JSON_INT);
+		case JSON_FLOAT:
+			return JsonValueInit(AllocJsonFloat(value->Data.Float), JSON_FLOAT);
+		default:
+			return JsonValueInit(NULL, value->Type);
+	}
+}
+
+JsonPersistentExpr* JsonExprToPersistent(JsonExpr* expr) {
+	JsonPersistentExpr* version = JsonPersistentExprInit();
+
+	for (ullong i = 0; i < expr->Length; i++) {
+		JsonPair* pair = &expr->Buffer[i];
+		JsonPersistentExpr* next = JsonPersistentSet(version, pair->Key, JsonValueToPersistent(pair->Value));
+
+		JsonPersistentExprRelease(version);
+		version = next;
+	}
+
+	return version;
+}
+
+JsonPersistentList* JsonListToPersistent(JsonList* list) {
+	JsonPersistentList* version = JsonPersistentListInit();
+
+	for (ullong i = 0; i < list->Length; i++) {
+		JsonPersistentValue* value;
+
+		switch (list->Packing) {
+			case JSON_PACKED_INT:
+				value = JsonPersistentCreateInt(((JsonInt*)list->Numbers)[i]);
+				break;
+			case JSON_PACKED_FLOAT:
+				value = JsonPersistentCreateFloat(((JsonFloat*)list->Numbers)[i]);
+				break;
+			default:
+				value = JsonValueToPersistent(&list->Buffer[i]);
+				break;
+		}
+
+		JsonPersistentList* next = JsonPersistentAppend(version, value);
+
+		JsonPersistentListRelease(version);
+		version = next;
+	}
+
+	return version;
+}
+
+static void AppendPersistentPair(const char* key, JsonPersistentValue* value, void* data) {
+	JsonPair* pair = JsonPairInit(AllocJsonString(key), PersistentToJsonValue(value));
+	JsonPairArrayAppend(data, *pair);
+	JsonPoolFree(pair, sizeof(JsonPair));
+}
+
+JsonExpr* JsonPersistentToExpr(JsonPersistentExpr* expr) {
+	JsonExpr* output = JsonExprInit();
+	JsonExprReserve(output, expr->Length);
+	JsonPersistentForEach(expr, AppendPersistentPair, output);
+
+	return output;
+}
+
+JsonList* JsonPersistentToList(JsonPersistentList* list) {
+	JsonList* output = JsonListInit();
+	JsonListReserve(output, list->Length);
+
+	for (ullong i = 0; i < list->Length; i++) {
+		JsonPersistentValue* element;
+		JsonPersistentGetElement(list, i, &element);
+
+		JsonValue* value = PersistentToJsonValue(element);
+		JsonValueArrayAppend(output, *value);
+		JsonPoolFree(value, sizeof(JsonValue));
+	}
+
+	return output;
+}
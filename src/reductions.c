@@ -0,0 +1,413 @@
+#include <stdlib.h>
+#include <string.h>
+#include "include/json-parser.h"
+#include "include/reductions.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#define SUCCESS 1
+#define FAILURE 0
+
+#define TRUE 1
+#define FALSE 0
+
+#define PAIR_INDEX_NOT_FOUND ((ullong)-1)
+
+/*
+	Reduction Kernels
+
+	FUNCTIONS:
+
+	> ReduceNumber()
+	Adds a single number to a JsonReduction
+
+	> ReduceValue()
+	Adds a JsonValue to a JsonReduction if it holds a JsonInt or a JsonFloat
+
+	> AddInt()
+	Adds a JsonInt to a sum, returns FAILURE and leaves the sum alone if the result does not fit in a JsonInt
+
+	> ReduceInts()
+	Adds a packed JsonInt array to a JsonReduction. The sum is accumulated as a JsonInt so it stays exact. If it
+	overflows the numbers are summed again as JsonFloats one at a time, the same way an unpacked list is
+
+	> ReduceFloats()
+	Adds a packed JsonFloat array to a JsonReduction
+
+	> FinishReduction()
+	Computes the mean of a JsonReduction once every number has been added
+
+	NOTES:
+
+	The kernels for packed arrays use AVX2 when the library is compiled with it enabled (e.g., -mavx2), four numbers
+	are reduced at a time and the lanes are combined at the end. Floats only take the AVX2 path when JsonFloat is a
+	double (see JSON_FLOAT_DOUBLE), long doubles are always reduced one at a time. Without AVX2 the kernels are plain
+	loops over contiguous memory which compilers vectorize on their own
+*/
+
+static void ReduceNumber(JsonReduction* reduction, JsonFloat number) {
+	if (reduction->Count == 0 || number < reduction->Min) {
+		reduction->Min = number;
+	}
+
+	if (reduction->Count == 0 || number > reduction->Max) {
+		reduction->Max = number;
+	}
+
+	reduction->Sum += number;
+	reduction->Count++;
+}
+
+static void ReduceValue(JsonReduction* reduction, JsonValue* value) {
+	switch (value->Type) {
+		case JSON_INT:
+			ReduceNumber(reduction, (JsonFloat)*value->Data->Int);
+			break;
+		case JSON_FLOAT:
+			ReduceNumber(reduction, *value->Data->Float);
+			break;
+		default:
+			break;
+	}
+}
+
+static int AddInt(JsonInt* sum, JsonInt number) {
+	JsonInt result = (JsonInt)((ullong)*sum + (ullong)number);
+
+	if (((*sum ^ result) & (number ^ result)) < 0) {
+		return FAILURE;
+	}
+
+	*sum = result;
+	return SUCCESS;
+}
+
+static void ReduceInts(JsonReduction* reduction, JsonInt* ints, ullong length) {
+	if (length == 0) {
+		return;
+	}
+
+	JsonInt sum = 0;
+	JsonInt min = ints[0];
+	JsonInt max = ints[0];
+	int exact = TRUE;
+	ullong i = 0;
+
+#if defined(__AVX2__)
+	if (length >= 4) {
+		__m256i vsum = _mm256_setzero_si256();
+		__m256i vmin = _mm256_set1_epi64x(ints[0]);
+		__m256i vmax = vmin;
+		__m256i voverflow = _mm256_setzero_si256();
+
+		for (; i + 4 <= length; i += 4) {
+			__m256i x = _mm256_loadu_si256((const __m256i*)&ints[i]);
+			__m256i result = _mm256_add_epi64(vsum, x);
+			voverflow = _mm256_or_si256(voverflow, _mm256_and_si256(
+				_mm256_xor_si256(vsum, result),
+				_mm256_xor_si256(x, result)
+			));
+			vsum = result;
+			vmin = _mm256_blendv_epi8(vmin, x, _mm256_cmpgt_epi64(vmin, x));
+			vmax = _mm256_blendv_epi8(vmax, x, _mm256_cmpgt_epi64(x, vmax));
+		}
+
+		JsonInt lanes[3][4];
+		_mm256_storeu_si256((__m256i*)lanes[0], vsum);
+		_mm256_storeu_si256((__m256i*)lanes[1], vmin);
+		_mm256_storeu_si256((__m256i*)lanes[2], vmax);
+		exact = _mm256_movemask_pd(_mm256_castsi256_pd(voverflow)) == 0;
+
+		for (int lane = 0; lane < 4; lane++) {
+			exact = exact && AddInt(&sum, lanes[0][lane]);
+			min = lanes[1][lane] < min ? lanes[1][lane] : min;
+			max = lanes[2][lane] > max ? lanes[2][lane] : max;
+		}
+	}
+#endif
+
+	for (; i < length; i++) {
+		exact = exact && AddInt(&sum, ints[i]);
+		min = ints[i] < min ? ints[i] : min;
+		max = ints[i] > max ? ints[i] : max;
+	}
+
+	if (reduction->Count == 0 || (JsonFloat)min < reduction->Min) {
+		reduction->Min = (JsonFloat)min;
+	}
+
+	if (reduction->Count == 0 || (JsonFloat)max > reduction->Max) {
+		reduction->Max = (JsonFloat)max;
+	}
+
+	if (exact) {
+		reduction->Sum += (JsonFloat)sum;
+	}
+	else {
+		for (i = 0; i < length; i++) {
+			reduction->Sum += (JsonFloat)ints[i];
+		}
+	}
+
+	reduction->Count += length;
+}
+
+static void ReduceFloats(JsonReduction* reduction, JsonFloat* floats, ullong length) {
+	if (length == 0) {
+		return;
+	}
+
+	JsonFloat sum = 0;
+	JsonFloat min = floats[0];
+	JsonFloat max = floats[0];
+	ullong i = 0;
+
+#if defined(__AVX2__) && defined(JSON_FLOAT_DOUBLE)
+	if (length >= 4) {
+		__m256d vsum = _mm256_setzero_pd();
+		__m256d vmin = _mm256_set1_pd(floats[0]);
+		__m256d vmax = vmin;
+
+		for (; i + 4 <= length; i += 4) {
+			__m256d x = _mm256_loadu_pd(&floats[i]);
+			vsum = _mm256_add_pd(vsum, x);
+			vmin = _mm256_min_pd(vmin, x);
+			vmax = _mm256_max_pd(vmax, x);
+		}
+
+		double lanes[3][4];
+		_mm256_storeu_pd(lanes[0], vsum);
+		_mm256_storeu_pd(lanes[1], vmin);
+		_mm256_storeu_pd(lanes[2], vmax);
+
+		for (int lane = 0; lane < 4; lane++) {
+			sum += lanes[0][lane];
+			min = lanes[1][lane] < min ? lanes[1][lane] : min;
+			max = lanes[2][lane] > max ? lanes[2][lane] : max;
+		}
+	}
+#endif
+
+	for (; i < length; i++) {
+		sum += floats[i];
+		min = floats[i] < min ? floats[i] : min;
+		max = floats[i] > max ? floats[i] : max;
+	}
+
+	if (reduction->Count == 0 || min < reduction->Min) {
+		reduction->Min = min;
+	}
+
+	if (reduction->Count == 0 || max > reduction->Max) {
+		reduction->Max = max;
+	}
+
+	reduction->Sum += sum;
+	reduction->Count += length;
+}
+
+static void FinishReduction(JsonReduction* reduction) {
+	reduction->Mean = reduction->Count > 0
+		? reduction->Sum / (JsonFloat)reduction->Count
+		: 0;
+}
+
+/*
+	Histogram Kernels
+
+	FUNCTIONS:
+
+	> HistogramBin()
+	Adds a number to the bin it falls into. Numbers outside of [min, max] are skipped, 'max' itself is put into the
+	last bin. Returns 1 if the number was put into a bin
+
+	> HistogramValue()
+	Same as HistogramBin() but for a JsonValue, values which are not numbers are skipped
+*/
+
+static ullong HistogramBin(JsonFloat number, JsonFloat min, JsonFloat max, ullong* bins, ullong count) {
+	if (!(number >= min && number <= max)) {
+		return 0;
+	}
+
+	ullong bin = max > min
+		? (ullong)((number - min) / (max - min) * (JsonFloat)count)
+		: 0;
+
+	bins[bin < count ? bin : count - 1]++;
+	return 1;
+}
+
+static ullong HistogramValue(JsonValue* value, JsonFloat min, JsonFloat max, ullong* bins, ullong count) {
+	switch (value->Type) {
+		case JSON_INT:
+			return HistogramBin((JsonFloat)*value->Data->Int, min, max, bins, count);
+		case JSON_FLOAT:
+			return HistogramBin(*value->Data->Float, min, max, bins, count);
+		default:
+			return 0;
+	}
+}
+
+/*
+	Reducing Lists
+
+	FUNCTIONS:
+
+	> JsonListReduce()
+	Computes the count, sum, min, max and mean of the numbers in a JsonList in a single pass
+	Packed JsonLists (see JsonListPack()) are reduced with the vectorized kernels, any other JsonList is walked one
+	JsonValue at a time and values which are not numbers are skipped
+
+	> JsonListSum()
+	Returns the sum of the numbers in a JsonList
+
+	> JsonListMinMax()
+	Gets the smallest and largest number in a JsonList
+	Returns FAILURE if the JsonList does not hold any numbers
+
+	> JsonListHistogram()
+	Counts the numbers in a JsonList into 'count' bins of equal width covering [min, max]. The bins are zeroed first
+	Returns the number of numbers which were put into a bin
+
+	NOTES:
+
+	None of these functions modify the JsonList, so a JsonList which shares its buffer with a copy keeps sharing it
+*/
+
+void JsonListReduce(JsonList* list, JsonReduction* reduction) {
+	memset(reduction, 0, sizeof(JsonReduction));
+
+	switch (list->Packing) {
+		case JSON_PACKED_INT:
+			ReduceInts(reduction, list->Numbers, list->Length);
+			break;
+		case JSON_PACKED_FLOAT:
+			ReduceFloats(reduction, list->Numbers, list->Length);
+			break;
+		default:
+			for (ullong i = 0; i < list->Length; i++) {
+				ReduceValue(reduction, &list->Buffer[i]);
+			}
+			break;
+	}
+
+	FinishReduction(reduction);
+}
+
+JsonFloat JsonListSum(JsonList* list) {
+	JsonReduction reduction;
+	JsonListReduce(list, &reduction);
+
+	return reduction.Sum;
+}
+
+int JsonListMinMax(JsonList* list, JsonFloat* min, JsonFloat* max) {
+	JsonReduction reduction;
+	JsonListReduce(list, &reduction);
+
+	if (reduction.Count == 0) {
+		return FAILURE;
+	}
+
+	*min = reduction.Min;
+	*max = reduction.Max;
+	return SUCCESS;
+}
+
+ullong JsonListHistogram(JsonList* list, JsonFloat min, JsonFloat max, ullong* bins, ullong count) {
+	memset(bins, 0, sizeof(ullong) * count);
+
+	if (count == 0) {
+		return 0;
+	}
+
+	ullong binned = 0;
+
+	for (ullong i = 0; i < list->Length; i++) {
+		switch (list->Packing) {
+			case JSON_PACKED_INT:
+				binned += HistogramBin((JsonFloat)((JsonInt*)list->Numbers)[i], min, max, bins, count);
+				break;
+			case JSON_PACKED_FLOAT:
+				binned += HistogramBin(((JsonFloat*)list->Numbers)[i], min, max, bins, count);
+				break;
+			default:
+				binned += HistogramValue(&list->Buffer[i], min, max, bins, count);
+				break;
+		}
+	}
+
+	return binned;
+}
+
+/*
+	Reducing Fields
+
+	FUNCTIONS:
+
+	> FieldValue()
+	Gets the value of a key in an element of a JsonList, or NULL if the element is not a JsonExpr or does not have
+	the key. The key is hashed once by the caller
+
+	> JsonListReduceField()
+	Same as JsonListReduce() but reduces the value of a key in every JsonExpr of a JsonList, e.g. reducing the key
+	"price" of the list "items" reduces items[*].price. Elements which are not JsonExprs, do not have the key or
+	whose value is not a number are skipped
+
+	> JsonListHistogramField()
+	Same as JsonListHistogram() but over the value of a key in every JsonExpr of a JsonList
+*/
+
+static JsonValue* FieldValue(JsonList* list, ullong index, const char* key, ullong length, ullong hash) {
+	if (list->Packing != JSON_PACKED_NONE || list->Buffer[index].Type != JSON_EXPR) {
+		return NULL;
+	}
+
+	JsonExpr* expr = list->Buffer[index].Data->Expr;
+	ullong pair = JsonGetPairIndexHashed(expr, key, length, hash);
+
+	return pair != PAIR_INDEX_NOT_FOUND
+		? expr->Buffer[pair].Value
+		: NULL;
+}
+
+void JsonListReduceField(JsonList* list, const char* key, JsonReduction* reduction) {
+	ullong length = strlen(key);
+	ullong hash = JsonHashKey(key, length);
+	memset(reduction, 0, sizeof(JsonReduction));
+
+	for (ullong i = 0; i < list->Length; i++) {
+		JsonValue* value = FieldValue(list, i, key, length, hash);
+
+		if (value != NULL) {
+			ReduceValue(reduction, value);
+		}
+	}
+
+	FinishReduction(reduction);
+}
+
+ullong JsonListHistogramField(JsonList* list, const char* key, JsonFloat min, JsonFloat max, ullong* bins, ullong count) {
+	ullong length = strlen(key);
+	ullong hash = JsonHashKey(key, length);
+	memset(bins, 0, sizeof(ullong) * count);
+
+	if (count == 0) {
+		return 0;
+	}
+
+	ullong binned = 0;
+
+	for (ullong i = 0; i < list->Length; i++) {
+		JsonValue* value = FieldValue(list, i, key, length, hash);
+
+		if (value != NULL) {
+			binned += HistogramValue(value, min, max, bins, count);
+		}
+	}
+
+	return binned;
+}
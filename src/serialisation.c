@@ -1,163 +1,1682 @@
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include "include/serialisation.h"
-
-/*
-	Serialising JSON Datatypes
-
-	FUNCTIONS:
-
-	> SerialiseJsonString()
-	Converts a JsonString to a serialised string.
-
-	> SerialiseJsonInt()
-	Converts a JsonInt to a serialised int.
-
-	> SerialiseJsonFloat()
-	Converts a JsonFloat to a serialised float.
-
-	> SerialiseKeyword()
-	Converts a keyword (JSON_TRUE, JSON_FALSE or JSON_NULL) to a serialised string
-
-	> SerialiseJsonValue()
-	Converts a JsonValue to a serialised value by serialising the JsonData inside of it
-	
-	> SerialiseJsonPair()
-	Converts a JsonPair to a serialised pair.
-
-	> SerialiseJsonList()
-	Converts a JsonList to a serialised list.
-
-	> SerialiseJsonExpr()
-	Converts a JsonExpr to a serialised expr.
-*/
-
-const char* SerialiseJsonString(JsonString string) {
-	StringBuilder* builder = StringBuilderInit();
-
-	StringBuilderAppendChar(builder, '\"');
-	StringBuilderAppendString(builder, string);
-	StringBuilderAppendChar(builder, '\"');
-
-	char* buffer = builder->Buffer;
-	free(builder);
-	return buffer;
-}
-
-const char* SerialiseJsonInt(JsonInt* integer) {
-	StringBuilder* builder = StringBuilderInit();
-	StringBuilderAppendLLONG(builder, *integer);
-
-	char* buffer = builder->Buffer;
-	free(builder);
-	return buffer;
-}
-
-const char* SerialiseJsonFloat(JsonFloat* flt) {
-	StringBuilder* builder = StringBuilderInit();
-	StringBuilderAppendLDOUBLE(builder, *flt);
-
-	char* buffer = builder->Buffer;
-	free(builder);
-	return buffer;
-}
-
-const char* SerialiseKeyword(JsonType keyword) {
-	StringBuilder* builder = StringBuilderInit();
-	
-	switch (keyword) {
-		case JSON_TRUE:
-			StringBuilderAppendString(builder, KEYWORD_TRUE);
-			break;
-		case JSON_FALSE:
-			StringBuilderAppendString(builder, KEYWORD_FALSE);
-			break;
-		case JSON_NULL:
-			StringBuilderAppendString(builder, KEYWORD_NULL);
-			break;
-	}
-
-	char* buffer = builder->Buffer;
-	free(builder);
-	return buffer;
-}
-
-const char* SerialiseJsonValue(JsonValue* value) {
-	switch (value->Type) {
-		case JSON_EXPR:
-			return SerialiseJsonExpr(value->Data->Expr);
-		case JSON_LIST:
-			return SerialiseJsonList(value->Data->List);
-		case JSON_STRING:
-			return SerialiseJsonString(value->Data->String);
-		case JSON_INT:
-			return SerialiseJsonInt(value->Data->Int);
-		case JSON_FLOAT:
-			return SerialiseJsonFloat(value->Data->Float);
-		case JSON_TRUE:
-		case JSON_FALSE:
-		case JSON_NULL:
-			return SerialiseKeyword(value->Type);
-	}
-}
-
-const char* SerialiseJsonPair(JsonPair* pair) {
-	StringBuilder* builder = StringBuilderInit();
-	const char* valuestr = SerialiseJsonValue(pair->Value);
-
-	StringBuilderAppendChar(builder, '\"');
-	StringBuilderAppendString(builder, pair->Key);
-	StringBuilderAppendString(builder, "\": ");
-	StringBuilderAppendString(builder, valuestr);
-
-	char* buffer = builder->Buffer;
-	free(builder);
-	free(valuestr);
-	return buffer;
-}
-
-const char* SerialiseJsonList(JsonList* list) {
-	StringBuilder* builder = StringBuilderInit();
-	StringBuilderAppendChar(builder, '[');
-
-	for (ullong i = 0; i < list->Length; i++) {
-		const char* valuestr = SerialiseJsonValue(&list->Buffer[i]);
-		StringBuilderAppendString(builder, valuestr);
-
-		if (i != list->Length - 1) {
-			StringBuilderAppendString(builder, ", ");
-		}
-
-		free(valuestr);
-	}
-
-	StringBuilderAppendChar(builder, ']');
-
-	char* buffer = builder->Buffer;
-	free(builder);
-	return buffer;
-}
-
-const char* SerialiseJsonExpr(JsonExpr* expr) {
-	StringBuilder* builder = StringBuilderInit();
-	StringBuilderAppendChar(builder, '{');
-
-	for (ullong i = 0; i < expr->Length; i++) {
-		const char* pairstr = SerialiseJsonPair(&expr->Buffer[i]);
-		StringBuilderAppendString(builder, pairstr);
-
-		if (i != expr->Length - 1) {
-			StringBuilderAppendString(builder, ", ");
-		}
-
-		free(pairstr);
-	}
-
-	StringBuilderAppendChar(builder, '}');
-
-	char* buffer = builder->Buffer;
-	free(builder);
-	return buffer;
-}
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "include/serialisation.h"
+#include "include/converters.h"
+#include "include/file-io.h"
+
+#define TRUE 1
+#define FALSE 0
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ESCAPE_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define ESCAPE_NEON
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/*
+	Escaping Strings
+
+	MACROS:
+
+	> ESCAPE_SSE2, ESCAPE_NEON
+	Defined when CleanPrefix() can scan 16 chars at a time with SSE2 (x86) or NEON (ARM) instructions
+
+	FUNCTIONS:
+
+	> LowestBit()
+	Returns the index of the lowest set bit of a non zero mask
+
+	> CleanPrefix()
+	Returns how many chars at the start of a string need no escaping. Chars are checked 16 at a time when the
+	target has SSE2 or NEON, the rest are checked with the EscapeTable
+
+	> WriteEscape()
+	Appends the escape sequence of the char at the start of a string to a StringBuilder (e.g., \n or \u001f) and
+	returns how many chars it stood for
+
+	> WriteEscapedString()
+	Appends a string to a StringBuilder, escaping the chars JSON does not allow inside a string. Runs of chars which
+	need no escaping are found by CleanPrefix() and copied in one go
+
+	NOTES:
+
+	EscapeTable maps every char to the letter of its escape sequence, 'u' for the control chars which only have a
+	\u00XX escape, or 0 when the char can be written as it is. Only quotes, backslashes and control chars (below 0x20)
+	are escaped, UTF-8 is written as it is. JSON_NUL_LEAD maps to '0': followed by JSON_NUL_TRAIL the two chars are a
+	stored U+0000 and are written as \u0000 (see JsonString), on its own it is written as it is
+*/
+
+static const char EscapeTable[256] = {
+	'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+	'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+	0, 0, '\"', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '\\', 0, 0, 0,
+	[JSON_NUL_LEAD] = '0'
+};
+
+static const char HexDigits[16] = "0123456789abcdef";
+
+#ifdef ESCAPE_SSE2
+static int LowestBit(unsigned int mask) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (int)index;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+static ullong CleanPrefix(const char* string, ullong length) {
+	ullong index = 0;
+
+#if defined(ESCAPE_SSE2)
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i control = _mm_set1_epi8(0x1F);
+	const __m128i nul = _mm_set1_epi8((char)JSON_NUL_LEAD);
+
+	for (; index + 16 <= length; index += 16) {
+		__m128i chunk = _mm_loadu_si128((const __m128i*)(string + index));
+		__m128i found = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+			_mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk), _mm_cmpeq_epi8(chunk, nul))
+		);
+
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(found);
+
+		if (mask != 0) {
+			return index + LowestBit(mask);
+		}
+	}
+#elif defined(ESCAPE_NEON)
+	const uint8x16_t quote = vdupq_n_u8('"');
+	const uint8x16_t backslash = vdupq_n_u8('\\');
+	const uint8x16_t control = vdupq_n_u8(0x1F);
+	const uint8x16_t nul = vdupq_n_u8(JSON_NUL_LEAD);
+
+	for (; index + 16 <= length; index += 16) {
+		uint8x16_t chunk = vld1q_u8((const uint8_t*)(string + index));
+		uint8x16_t found = vorrq_u8(
+			vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)),
+			vorrq_u8(vcleq_u8(chunk, control), vceqq_u8(chunk, nul))
+		);
+
+		if (vmaxvq_u8(found) != 0) {
+			break;
+		}
+	}
+#endif
+
+	for (; index < length; index++) {
+		if (EscapeTable[(unsigned char)string[index]] != 0) {
+			return index;
+		}
+	}
+
+	return length;
+}
+
+static ullong WriteEscape(StringBuilder* builder, const char* string, ullong length) {
+	unsigned char chr = (unsigned char)string[0];
+	char escape = EscapeTable[chr];
+
+	if (escape == '0') {
+		if (length > 1 && JsonIsNul(string)) {
+			StringBuilderAppendBytes(builder, "\\u0000", 6);
+			return 2;
+		}
+
+		StringBuilderAppendChar(builder, (char)chr);
+	}
+	else if (escape == 'u') {
+		char sequence[6] = { '\\', 'u', '0', '0', HexDigits[chr >> 4], HexDigits[chr & 0xF] };
+		StringBuilderAppendBytes(builder, sequence, sizeof(sequence));
+	}
+	else {
+		char sequence[2] = { '\\', escape };
+		StringBuilderAppendBytes(builder, sequence, sizeof(sequence));
+	}
+
+	return 1;
+}
+
+static void WriteEscapedString(StringBuilder* builder, const char* string, ullong length) {
+	ullong index = 0;
+
+	while (index < length) {
+		ullong clean = CleanPrefix(string + index, length - index);
+		StringBuilderAppendBytes(builder, string + index, clean);
+		index += clean;
+
+		if (index < length) {
+			index += WriteEscape(builder, string + index, length - index);
+		}
+	}
+}
+
+/*
+	Serialiser
+
+	FUNCTIONS:
+
+	> SerialiserInit()
+	Sets up a Serialiser for a JsonDumpOptions object, NULL gives the default options
+
+	NOTES:
+
+	The separators are picked once when the Serialiser is set up, so writing one costs the same in every mode
+*/
+
+static void SerialiserInit(Serialiser* serialiser, StringBuilder* builder, const JsonDumpOptions* options) {
+	int canonical = options != NULL && options->Canonical;
+	int compact = canonical || (options != NULL && options->Compact);
+	int indent = !canonical && options != NULL && options->Indent > 0 ? options->Indent : 0;
+
+	serialiser->Builder = builder;
+	serialiser->ItemSeparator = compact || indent > 0 ? "," : ", ";
+	serialiser->ItemSeparatorLength = compact || indent > 0 ? 1 : 2;
+	serialiser->KeySeparator = compact ? ":" : ": ";
+	serialiser->KeySeparatorLength = compact ? 1 : 2;
+	serialiser->Indent = (ullong)indent;
+	serialiser->Depth = 0;
+	serialiser->SortKeys = canonical || (options != NULL && options->SortKeys);
+	serialiser->Canonical = canonical;
+}
+
+/*
+	Writing JSON Datatypes
+
+	MACROS:
+
+	> WriteLiteral()
+	Appends a string literal to a StringBuilder, its length is known at compile time
+
+	> SORTED_PAIRS_STACK_SIZE
+	Number of pairs a JsonExpr can have for SortPairs() to sort them in a buffer on the stack
+
+	> SORTED_PAIRS_RUN_SIZE
+	Number of pairs MergeSortPairs() sorts with InsertionSortPairs() before it starts merging
+
+	> CANONICAL_INT_LIMIT
+	Biggest magnitude up to which every JsonInt is exactly a double, so canonical output can write it as it is
+
+	> PREFETCH_DISTANCE
+	How many pairs ahead PrefetchSortedPairs() loads the keys and values of
+
+	> Prefetch()
+	Asks the CPU to start loading the memory a pointer points at, does nothing where that is not supported
+
+	STRUCTS:
+
+	> SortedPair
+	A pointer to a JsonPair and the first 8 bytes of its key packed big endian into an integer (padded with zeroes),
+	so most keys are ordered by comparing integers without following the pointer
+
+	FUNCTIONS:
+
+	> WriteJsonString()
+	Appends a JsonString wrapped in quotes to a StringBuilder. The string is escaped unless 'plain' says it has
+	nothing to escape (see JsonValue)
+
+	> WriteCanonicalDouble()
+	Appends a double in canonical form (see DoubleToCanonicalString())
+
+	> WriteJsonInt()
+	Appends a JsonInt. In canonical output ints beyond CANONICAL_INT_LIMIT are written as the double they read
+	back as
+
+	> WriteJsonFloat()
+	Appends a JsonFloat. In canonical output it is written as a double (see DoubleToCanonicalString())
+
+	> WriteKeyword()
+	Appends a keyword (JSON_TRUE, JSON_FALSE or JSON_NULL) to a StringBuilder
+
+	> WriteIndent()
+	Starts a new line indented to the Serialiser's depth
+
+	> WriteItem()
+	Writes what goes in front of the element or pair at 'index' of a container: the item separator (unless it is
+	the first one) and a new line when indenting
+
+	> WriteClose()
+	Leaves a container of 'length' items and writes its closing bracket, on a new line when indenting
+
+	> Utf16Byte()
+	Maps a UTF-8 byte so that comparing mapped bytes orders strings by UTF-16 code units (see NOTES)
+
+	> ComparePairKeys()
+	Compares two SortedPairs by key. Compares the prefixes first and only reads the keys when the prefixes are the
+	same, then compares the rest of the keys and then their lengths. The keys are compared with memcmp(), or when
+	'utf16' is set skipped 8 equal bytes at a time up to the first differing byte, which is mapped with Utf16Byte()
+
+	> InsertionSortPairs()
+	Sorts a few SortedPairs in place using ComparePairKeys()
+
+	> MergePairs()
+	Merges two sorted runs of SortedPairs which lie next to each other into 'out'. Pairs from the first run go first
+	when keys are equal
+
+	> MergeRuns()
+	Merges sorted runs of 'width' SortedPairs two at a time until they make up one sorted run. 'scratch' has to hold
+	as many SortedPairs as 'pairs', and the sorted SortedPairs end up in either of the two, which is returned
+
+	> MergeSortPairs()
+	Sorts SortedPairs with a bottom up merge sort: runs of SORTED_PAIRS_RUN_SIZE pairs are sorted with
+	InsertionSortPairs() and then merged with MergeRuns()
+
+	> PrefixPairs()
+	Fills in a SortedPair for each of 'length' JsonPairs, with the prefix of its key mapped with Utf16Byte() when
+	'utf16' is set
+
+	> SortPairs()
+	Returns the pairs of a JsonExpr as SortedPairs in key order, or in UTF-16 key order when 'utf16' is set.
+	JsonExprs with up to SORTED_PAIRS_STACK_SIZE pairs are sorted in 'stack' with InsertionSortPairs(), bigger ones
+	are merge sorted in a new allocation which is returned through 'allocation' to be freed by the caller
+
+	> PrefetchSortedPairs()
+	Prefetches the JsonPairs, keys and values a few pairs ahead of 'index'. Sorted pairs are read in an order which
+	jumps around memory, so without it nearly every key and value is a cache miss
+
+	> WriteJsonValue()
+	Appends a JsonValue to a StringBuilder by writing the JsonData inside of it
+
+	> WriteJsonPair()
+	Appends a JsonPair to a StringBuilder
+
+	> WriteListElement()
+	Appends the element at 'index' of a JsonList to a StringBuilder, reading it from the packed numbers when the
+	JsonList is packed
+
+	> WriteJsonList()
+	Appends a JsonList to a StringBuilder
+
+	> WriteJsonExpr()
+	Appends a JsonExpr to a StringBuilder
+
+	NOTES:
+
+	The whole tree is written into the one StringBuilder passed in at the top, so every char is copied once and
+	there are no allocations besides the StringBuilder growing (and sorting the keys of JsonExprs with more than
+	SORTED_PAIRS_STACK_SIZE pairs). Compact, pretty and sorted output are all written by the same functions, the
+	Serialiser decides what goes between the items
+
+	Keys are sorted by their UTF-8 bytes, which is the same as sorting them by code point. Canonical output sorts
+	them by UTF-16 code units instead, where the surrogates of code points above U+FFFF come before U+E000 to
+	U+FFFF. Only the lead bytes of those code points differ in order, so Utf16Byte() moves 0xF0 to 0xF4 (4 byte
+	sequences) down to 0xEE to 0xF2 and 0xEE and 0xEF (U+E000 to U+FFFF) up to 0xF3 and 0xF4, which lets canonical
+	keys go through the same prefixes and comparisons. Utf16Byte() also moves JSON_NUL_LEAD down to 0, so a stored
+	U+0000 (see JsonString) comes first as the code unit 0 does. Sorted output orders it by its stored bytes
+
+	Sorting takes O(n log n) key comparisons however alike the keys are. Keys which share their first 8 bytes (e.g.,
+	"property_0000001" and "property_0000002") are told apart by comparing the rest of their bytes, so only they
+	read the keys
+*/
+
+#define WriteLiteral(builder, literal) StringBuilderAppendBytes(builder, literal, sizeof(literal) - 1)
+
+#define SORTED_PAIRS_STACK_SIZE 32
+#define SORTED_PAIRS_RUN_SIZE 16
+#define CANONICAL_INT_LIMIT (1LL << 53)
+#define PREFETCH_DISTANCE 8
+
+#if defined(__GNUC__) || defined(__clang__)
+#define Prefetch(ptr) __builtin_prefetch(ptr)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define Prefetch(ptr) _mm_prefetch((const char*)(ptr), _MM_HINT_T0)
+#else
+#define Prefetch(ptr) ((void)(ptr))
+#endif
+
+typedef struct {
+	unsigned long long Prefix;
+	JsonPair* Pair;
+} SortedPair;
+
+static void WriteJsonList(Serialiser* serialiser, JsonList* list);
+static void WriteJsonExpr(Serialiser* serialiser, JsonExpr* expr);
+
+static void WriteJsonString(StringBuilder* builder, JsonString string, ullong length, int plain) {
+	StringBuilderAppendChar(builder, '\"');
+
+	if (plain) {
+		StringBuilderAppendBytes(builder, string, length);
+	}
+	else {
+		WriteEscapedString(builder, string, length);
+	}
+
+	StringBuilderAppendChar(builder, '\"');
+}
+
+static void WriteCanonicalDouble(StringBuilder* builder, double flt) {
+	char buffer[CANONICAL_STRING_SIZE];
+	StringBuilderAppendBytes(builder, buffer, DoubleToCanonicalString(buffer, flt));
+}
+
+static void WriteJsonInt(Serialiser* serialiser, JsonInt integer) {
+	if (serialiser->Canonical && (integer > CANONICAL_INT_LIMIT || integer < -CANONICAL_INT_LIMIT)) {
+		WriteCanonicalDouble(serialiser->Builder, (double)integer);
+		return;
+	}
+
+	StringBuilderAppendLLONG(serialiser->Builder, integer);
+}
+
+static void WriteJsonFloat(Serialiser* serialiser, JsonFloat flt) {
+	if (serialiser->Canonical) {
+		WriteCanonicalDouble(serialiser->Builder, (double)flt);
+		return;
+	}
+
+#ifdef JSON_FLOAT_DOUBLE
+	StringBuilderAppendDOUBLE(serialiser->Builder, flt);
+#else
+	StringBuilderAppendLDOUBLE(serialiser->Builder, flt);
+#endif
+}
+
+static void WriteKeyword(StringBuilder* builder, JsonType keyword) {
+	switch (keyword) {
+		case JSON_TRUE:
+			WriteLiteral(builder, KEYWORD_TRUE);
+			break;
+		case JSON_FALSE:
+			WriteLiteral(builder, KEYWORD_FALSE);
+			break;
+		case JSON_NULL:
+			WriteLiteral(builder, KEYWORD_NULL);
+			break;
+	}
+}
+
+static void WriteIndent(Serialiser* serialiser) {
+	static const char spaces[64] = "                                                                ";
+	ullong count = serialiser->Depth * serialiser->Indent;
+
+	StringBuilderAppendChar(serialiser->Builder, '\n');
+
+	while (count > 0) {
+		ullong chunk = count < sizeof(spaces) ? count : sizeof(spaces);
+		StringBuilderAppendBytes(serialiser->Builder, spaces, chunk);
+		count -= chunk;
+	}
+}
+
+static void WriteItem(Serialiser* serialiser, ullong index) {
+	if (index > 0) {
+		StringBuilderAppendBytes(serialiser->Builder, serialiser->ItemSeparator, serialiser->ItemSeparatorLength);
+	}
+
+	if (serialiser->Indent > 0) {
+		WriteIndent(serialiser);
+	}
+}
+
+static void WriteClose(Serialiser* serialiser, ullong length, char bracket) {
+	serialiser->Depth--;
+
+	if (serialiser->Indent > 0 && length > 0) {
+		WriteIndent(serialiser);
+	}
+
+	StringBuilderAppendChar(serialiser->Builder, bracket);
+}
+
+static unsigned char Utf16Byte(unsigned char byte) {
+	if (byte == JSON_NUL_LEAD) {
+		return 0;
+	}
+	else if (byte >= 0xF0 && byte <= 0xF4) {
+		return byte - 2;
+	}
+
+	return byte == 0xEE || byte == 0xEF ? byte + 5 : byte;
+}
+
+static int ComparePairKeys(const SortedPair* sorted1, const SortedPair* sorted2, int utf16) {
+	if (sorted1->Prefix != sorted2->Prefix) {
+		return sorted1->Prefix < sorted2->Prefix ? -1 : 1;
+	}
+
+	const JsonPair* pair1 = sorted1->Pair;
+	const JsonPair* pair2 = sorted2->Pair;
+	ullong length = pair1->KeyLength < pair2->KeyLength ? pair1->KeyLength : pair2->KeyLength;
+	ullong start = length < 8 ? length : 8;
+
+	if (utf16) {
+		while (start + 8 <= length && memcmp(pair1->Key + start, pair2->Key + start, 8) == 0) {
+			start += 8;
+		}
+
+		for (ullong i = start; i < length; i++) {
+			if (pair1->Key[i] != pair2->Key[i]) {
+				return Utf16Byte((unsigned char)pair1->Key[i]) < Utf16Byte((unsigned char)pair2->Key[i]) ? -1 : 1;
+			}
+		}
+	}
+	else {
+		int order = memcmp(pair1->Key + start, pair2->Key + start, length - start);
+
+		if (order != 0) {
+			return order;
+		}
+	}
+
+	return (pair1->KeyLength > pair2->KeyLength) - (pair1->KeyLength < pair2->KeyLength);
+}
+
+static void InsertionSortPairs(SortedPair* pairs, ullong length, int utf16) {
+	for (ullong i = 1; i < length; i++) {
+		SortedPair pair = pairs[i];
+		ullong j = i;
+
+		while (j > 0 && ComparePairKeys(&pair, &pairs[j - 1], utf16) < 0) {
+			pairs[j] = pairs[j - 1];
+			j--;
+		}
+
+		pairs[j] = pair;
+	}
+}
+
+static void MergePairs(const SortedPair* pairs, ullong middle, ullong length, SortedPair* out, int utf16) {
+	ullong left = 0;
+	ullong right = middle;
+	ullong index = 0;
+
+	if (middle < length && ComparePairKeys(&pairs[middle - 1], &pairs[middle], utf16) <= 0) {
+		memcpy(out, pairs, length * sizeof(SortedPair));
+		return;
+	}
+
+	while (left < middle && right < length) {
+		out[index++] = ComparePairKeys(&pairs[right], &pairs[left], utf16) < 0 ? pairs[right++] : pairs[left++];
+	}
+
+	memcpy(out + index, pairs + left, (middle - left) * sizeof(SortedPair));
+	index += middle - left;
+	memcpy(out + index, pairs + right, (length - right) * sizeof(SortedPair));
+}
+
+static SortedPair* MergeRuns(SortedPair* pairs, SortedPair* scratch, ullong length, ullong width, int utf16) {
+	for (; width < length; width *= 2) {
+		for (ullong start = 0; start < length; start += width * 2) {
+			ullong middle = start + width < length ? start + width : length;
+			ullong end = start + width * 2 < length ? start + width * 2 : length;
+			MergePairs(pairs + start, middle - start, end - start, scratch + start, utf16);
+		}
+
+		SortedPair* swap = pairs;
+		pairs = scratch;
+		scratch = swap;
+	}
+
+	return pairs;
+}
+
+static SortedPair* MergeSortPairs(SortedPair* pairs, SortedPair* scratch, ullong length, int utf16) {
+	for (ullong start = 0; start < length; start += SORTED_PAIRS_RUN_SIZE) {
+		ullong end = start + SORTED_PAIRS_RUN_SIZE < length ? start + SORTED_PAIRS_RUN_SIZE : length;
+		InsertionSortPairs(pairs + start, end - start, utf16);
+	}
+
+	return MergeRuns(pairs, scratch, length, SORTED_PAIRS_RUN_SIZE, utf16);
+}
+
+static void PrefixPairs(JsonPair* pairs, ullong length, SortedPair* sorted, int utf16) {
+	for (ullong i = 0; i < length; i++) {
+		JsonPair* pair = &pairs[i];
+		ullong size = pair->KeyLength < 8 ? pair->KeyLength : 8;
+		unsigned long long prefix = 0;
+
+		for (ullong j = 0; j < 8; j++) {
+			unsigned char byte = j < size ? (unsigned char)pair->Key[j] : 0;
+			prefix = (prefix << 8) | (utf16 ? Utf16Byte(byte) : byte);
+		}
+
+		sorted[i].Prefix = prefix;
+		sorted[i].Pair = pair;
+	}
+}
+
+static SortedPair* SortPairs(JsonExpr* expr, SortedPair* stack, SortedPair** allocation, int utf16) {
+	SortedPair* pairs = stack;
+	*allocation = NULL;
+
+	if (expr->Length > SORTED_PAIRS_STACK_SIZE) {
+		*allocation = JsonMalloc(expr->Length * 2 * sizeof(SortedPair));
+		pairs = *allocation;
+	}
+
+	PrefixPairs(expr->Buffer, expr->Length, pairs, utf16);
+
+	if (*allocation == NULL) {
+		InsertionSortPairs(pairs, expr->Length, utf16);
+		return pairs;
+	}
+
+	return MergeSortPairs(pairs, pairs + expr->Length, expr->Length, utf16);
+}
+
+static void PrefetchSortedPairs(SortedPair* sorted, ullong index, ullong length) {
+	if (index + PREFETCH_DISTANCE * 2 < length) {
+		Prefetch(sorted[index + PREFETCH_DISTANCE * 2].Pair);
+	}
+
+	if (index + PREFETCH_DISTANCE < length) {
+		Prefetch(sorted[index + PREFETCH_DISTANCE].Pair->Key);
+		Prefetch(sorted[index + PREFETCH_DISTANCE].Pair->Value);
+	}
+}
+
+static void WriteJsonValue(Serialiser* serialiser, JsonValue* value) {
+	switch (value->Type) {
+		case JSON_EXPR:
+			WriteJsonExpr(serialiser, value->Data->Expr);
+			break;
+		case JSON_LIST:
+			WriteJsonList(serialiser, value->Data->List);
+			break;
+		case JSON_STRING:
+			WriteJsonString(serialiser->Builder, value->Data->String, strlen(value->Data->String), value->Plain);
+			break;
+		case JSON_INT:
+			WriteJsonInt(serialiser, *value->Data->Int);
+			break;
+		case JSON_FLOAT:
+			WriteJsonFloat(serialiser, *value->Data->Float);
+			break;
+		case JSON_TRUE:
+		case JSON_FALSE:
+		case JSON_NULL:
+			WriteKeyword(serialiser->Builder, value->Type);
+			break;
+	}
+}
+
+static void WriteJsonPair(Serialiser* serialiser, JsonPair* pair) {
+	WriteJsonString(serialiser->Builder, pair->Key, pair->KeyLength, FALSE);
+	StringBuilderAppendBytes(serialiser->Builder, serialiser->KeySeparator, serialiser->KeySeparatorLength);
+	WriteJsonValue(serialiser, pair->Value);
+}
+
+static void WriteListElement(Serialiser* serialiser, JsonList* list, ullong index) {
+	switch (list->Packing) {
+		case JSON_PACKED_INT:
+			WriteJsonInt(serialiser, ((JsonInt*)list->Numbers)[index]);
+			break;
+		case JSON_PACKED_FLOAT:
+			WriteJsonFloat(serialiser, ((JsonFloat*)list->Numbers)[index]);
+			break;
+		default:
+			WriteJsonValue(serialiser, &list->Buffer[index]);
+			break;
+	}
+}
+
+static void WriteJsonList(Serialiser* serialiser, JsonList* list) {
+	StringBuilderAppendChar(serialiser->Builder, '[');
+	serialiser->Depth++;
+
+	for (ullong i = 0; i < list->Length; i++) {
+		WriteItem(serialiser, i);
+		WriteListElement(serialiser, list, i);
+	}
+
+	WriteClose(serialiser, list->Length, ']');
+}
+
+static void WriteJsonExpr(Serialiser* serialiser, JsonExpr* expr) {
+	SortedPair stack[SORTED_PAIRS_STACK_SIZE];
+	SortedPair* allocation = NULL;
+	SortedPair* sorted = serialiser->SortKeys && expr->Length > 1 ? SortPairs(expr, stack, &allocation, serialiser->Canonical) : NULL;
+
+	StringBuilderAppendChar(serialiser->Builder, '{');
+	serialiser->Depth++;
+
+	for (ullong i = 0; i < expr->Length; i++) {
+		WriteItem(serialiser, i);
+
+		if (sorted != NULL) {
+			PrefetchSortedPairs(sorted, i, expr->Length);
+		}
+
+		WriteJsonPair(serialiser, sorted != NULL ? sorted[i].Pair : &expr->Buffer[i]);
+	}
+
+	WriteClose(serialiser, expr->Length, '}');
+
+	JsonFree(allocation);
+}
+
+/*
+	Measuring JSON Datatypes
+
+	FUNCTIONS:
+
+	> EscapedLength()
+	Returns the length of a string once it has been escaped (see WriteEscapedString())
+
+	> MeasureJsonString()
+	Returns the length WriteJsonString() writes
+
+	> MeasureJsonInt()
+	Returns the length WriteJsonInt() writes, by counting digits
+
+	> MeasureJsonFloat(), MeasureCanonicalDouble()
+	Return the length WriteJsonFloat() and WriteCanonicalDouble() write. Floats have to be formatted to be measured,
+	into a buffer which is thrown away
+
+	> MeasureKeyword()
+	Returns the length WriteKeyword() writes
+
+	> MeasureContainer()
+	Returns the length of everything a container of 'length' items at the Serialiser's depth writes besides its
+	items: its brackets, the item separators and the new lines and indents WriteItem() and WriteClose() write
+
+	> MeasureJsonValue(), MeasureJsonPair(), MeasureJsonList(), MeasureJsonExpr()
+	Return the length WriteJsonValue(), WriteJsonPair(), WriteJsonList() and WriteJsonExpr() write
+
+	NOTES:
+
+	Each Measure function mirrors the Write function of the same name and has to be kept in step with it, the
+	lengths are exact. Sorting keys does not change the length, so pairs are measured in the order they are stored
+*/
+
+#define LiteralLength(literal) (sizeof(literal) - 1)
+
+static ullong MeasureJsonList(Serialiser* serialiser, JsonList* list);
+static ullong MeasureJsonExpr(Serialiser* serialiser, JsonExpr* expr);
+
+static ullong EscapedLength(const char* string, ullong length) {
+	ullong size = length;
+	ullong index = 0;
+
+	while (index < length) {
+		index += CleanPrefix(string + index, length - index);
+
+		if (index < length) {
+			char escape = EscapeTable[(unsigned char)string[index]];
+
+			if (escape == '0') {
+				ullong nul = length - index > 1 && JsonIsNul(string + index);
+				size += nul ? 4 : 0;
+				index += nul ? 2 : 1;
+			}
+			else {
+				size += escape == 'u' ? 5 : 1;
+				index++;
+			}
+		}
+	}
+
+	return size;
+}
+
+static ullong MeasureJsonString(JsonString string, ullong length, int plain) {
+	return 2 + (plain ? length : EscapedLength(string, length));
+}
+
+static ullong MeasureCanonicalDouble(double flt) {
+	char buffer[CANONICAL_STRING_SIZE];
+	return DoubleToCanonicalString(buffer, flt);
+}
+
+static ullong MeasureJsonInt(Serialiser* serialiser, JsonInt integer) {
+	if (serialiser->Canonical && (integer > CANONICAL_INT_LIMIT || integer < -CANONICAL_INT_LIMIT)) {
+		return MeasureCanonicalDouble((double)integer);
+	}
+
+	unsigned long long value = integer < 0 ? 0ull - (unsigned long long)integer : (unsigned long long)integer;
+	ullong length = integer < 0 ? 2 : 1;
+
+	while (value >= 10) {
+		value /= 10;
+		length++;
+	}
+
+	return length;
+}
+
+static ullong MeasureJsonFloat(Serialiser* serialiser, JsonFloat flt) {
+	if (serialiser->Canonical) {
+		return MeasureCanonicalDouble((double)flt);
+	}
+
+#ifdef JSON_FLOAT_DOUBLE
+	char buffer[DOUBLE_STRING_SIZE];
+	return DoubleToString(buffer, flt);
+#else
+	char buffer[LDOUBLE_STRING_SIZE];
+	return LDoubleToString(buffer, flt);
+#endif
+}
+
+static ullong MeasureKeyword(JsonType keyword) {
+	switch (keyword) {
+		case JSON_TRUE:
+			return LiteralLength(KEYWORD_TRUE);
+		case JSON_FALSE:
+			return LiteralLength(KEYWORD_FALSE);
+		default:
+			return LiteralLength(KEYWORD_NULL);
+	}
+}
+
+static ullong MeasureContainer(Serialiser* serialiser, ullong length) {
+	if (length == 0) {
+		return 2;
+	}
+
+	ullong size = 2 + (length - 1) * serialiser->ItemSeparatorLength;
+
+	if (serialiser->Indent > 0) {
+		size += length * (1 + (serialiser->Depth + 1) * serialiser->Indent);
+		size += 1 + serialiser->Depth * serialiser->Indent;
+	}
+
+	return size;
+}
+
+static ullong MeasureJsonValue(Serialiser* serialiser, JsonValue* value) {
+	switch (value->Type) {
+		case JSON_EXPR:
+			return MeasureJsonExpr(serialiser, value->Data->Expr);
+		case JSON_LIST:
+			return MeasureJsonList(serialiser, value->Data->List);
+		case JSON_STRING:
+			return MeasureJsonString(value->Data->String, strlen(value->Data->String), value->Plain);
+		case JSON_INT:
+			return MeasureJsonInt(serialiser, *value->Data->Int);
+		case JSON_FLOAT:
+			return MeasureJsonFloat(serialiser, *value->Data->Float);
+		default:
+			return MeasureKeyword(value->Type);
+	}
+}
+
+static ullong MeasureJsonPair(Serialiser* serialiser, JsonPair* pair) {
+	return MeasureJsonString(pair->Key, pair->KeyLength, FALSE) + serialiser->KeySeparatorLength
+		+ MeasureJsonValue(serialiser, pair->Value);
+}
+
+static ullong MeasureJsonList(Serialiser* serialiser, JsonList* list) {
+	ullong size = MeasureContainer(serialiser, list->Length);
+	serialiser->Depth++;
+
+	for (ullong i = 0; i < list->Length; i++) {
+		switch (list->Packing) {
+			case JSON_PACKED_INT:
+				size += MeasureJsonInt(serialiser, ((JsonInt*)list->Numbers)[i]);
+				break;
+			case JSON_PACKED_FLOAT:
+				size += MeasureJsonFloat(serialiser, ((JsonFloat*)list->Numbers)[i]);
+				break;
+			default:
+				size += MeasureJsonValue(serialiser, &list->Buffer[i]);
+				break;
+		}
+	}
+
+	serialiser->Depth--;
+	return size;
+}
+
+static ullong MeasureJsonExpr(Serialiser* serialiser, JsonExpr* expr) {
+	ullong size = MeasureContainer(serialiser, expr->Length);
+	serialiser->Depth++;
+
+	for (ullong i = 0; i < expr->Length; i++) {
+		size += MeasureJsonPair(serialiser, &expr->Buffer[i]);
+	}
+
+	serialiser->Depth--;
+	return size;
+}
+
+/*
+	Serialising JSON Datatypes
+
+	FUNCTIONS:
+
+	> SerialiseJsonValue()
+	Converts a JsonValue to a serialised value by serialising the JsonData inside of it
+
+	> SerialiseJsonPair()
+	Converts a JsonPair to a serialised pair.
+
+	> SerialiseJsonList()
+	Converts a JsonList to a serialised list.
+
+	> SerialiseJsonExpr()
+	Converts a JsonExpr to a serialised expr.
+
+	> SerialiseJsonExprEx()
+	Converts a JsonExpr to a serialised expr which is formatted as the JsonDumpOptions say (see JsonDumpOptions)
+
+	> SerialisedJsonExprSize()
+	Returns the exact length of the string SerialiseJsonExprEx() returns for an expr and the same options (not
+	counting the null terminator), without serialising it
+
+	> SerialiseJsonExprTo()
+	Appends a serialised expr to a StringBuilder the caller owns. With a sink StringBuilder (see
+	StringBuilderInitSink()) the expr is streamed out in chunks, so it is never held in memory as a whole. The
+	caller still has to flush the StringBuilder afterwards
+
+	NOTES:
+
+	The returned strings should be freed with JsonFree()
+
+	Passing NULL options gives the default output, which is the same as SerialiseJsonExpr()
+
+	The Serialise functions do not measure their output first. Measuring costs more than the few times the buffer
+	doubles while it is written (floats have to be formatted twice), so callers which need the output in a buffer of
+	exactly the right size can reserve SerialisedJsonExprSize() chars themselves and use SerialiseJsonExprTo()
+*/
+
+const char* SerialiseJsonValue(JsonValue* value) {
+	Serialiser serialiser;
+	SerialiserInit(&serialiser, StringBuilderInit(), NULL);
+	WriteJsonValue(&serialiser, value);
+
+	return StringBuilderFinish(serialiser.Builder);
+}
+
+const char* SerialiseJsonPair(JsonPair* pair) {
+	Serialiser serialiser;
+	SerialiserInit(&serialiser, StringBuilderInit(), NULL);
+	WriteJsonPair(&serialiser, pair);
+
+	return StringBuilderFinish(serialiser.Builder);
+}
+
+const char* SerialiseJsonList(JsonList* list) {
+	Serialiser serialiser;
+	SerialiserInit(&serialiser, StringBuilderInit(), NULL);
+	WriteJsonList(&serialiser, list);
+
+	return StringBuilderFinish(serialiser.Builder);
+}
+
+const char* SerialiseJsonExpr(JsonExpr* expr) {
+	return SerialiseJsonExprEx(expr, NULL);
+}
+
+const char* SerialiseJsonExprEx(JsonExpr* expr, const JsonDumpOptions* options) {
+	Serialiser serialiser;
+	SerialiserInit(&serialiser, StringBuilderInit(), options);
+	WriteJsonExpr(&serialiser, expr);
+
+	return StringBuilderFinish(serialiser.Builder);
+}
+
+ullong SerialisedJsonExprSize(JsonExpr* expr, const JsonDumpOptions* options) {
+	Serialiser serialiser;
+	SerialiserInit(&serialiser, NULL, options);
+
+	return MeasureJsonExpr(&serialiser, expr);
+}
+
+void SerialiseJsonExprTo(StringBuilder* builder, JsonExpr* expr, const JsonDumpOptions* options) {
+	Serialiser serialiser;
+	SerialiserInit(&serialiser, builder, options);
+	WriteJsonExpr(&serialiser, expr);
+}
+
+/*
+	Parallel Serialising
+
+	MACROS:
+
+	> JSON_PARALLEL_CHUNKS_PER_THREAD
+	Number of chunks the split container's items are cut into per thread. More chunks than threads keeps every thread
+	busy when some items are much bigger than others
+
+	> ChunkLock(), ChunkUnlock()
+	Lock and unlock the mutex which guards ParallelDump.NextChunk
+
+	STRUCTS:
+
+	> ParallelDump
+	Everything the threads of a parallel dump share: the split container and the order its items are written in,
+	the Serialiser state inside of it, the chunk builders and the index of the next chunk to write or sort. While
+	Sorting is set the chunks are blocks of Pairs to be sorted rather than written
+
+	FUNCTIONS:
+
+	> ProcessorCount()
+	Returns the number of processors which are online, used when the caller passes 0 threads
+
+	> WriteChunk()
+	Writes the items of one chunk of the split container into the chunk's own StringBuilder. The first item of every
+	chunk but the first is preceded by an item separator, so the chunks can be joined as they are
+
+	> SortChunk()
+	Fills in and sorts the SortedPairs of one block of the split JsonExpr's pairs, leaving them in Pairs
+
+	> RunChunks()
+	Writes or sorts chunks until every chunk has been taken. Run by the calling thread and every worker thread
+
+	> ChunkWorker()
+	Entry point of a worker thread, which selects the calling thread's allocator and runs RunChunks()
+
+	> RunChunksOnThreads()
+	Runs RunChunks() on up to 'threads' threads, including the calling thread, and waits for them. Falls back to
+	fewer threads if some could not be started
+
+	> DumpChunks()
+	Cuts the split container into chunks and writes them on 'threads' threads
+
+	> SortPairsParallel()
+	Same as SortPairs() for the JsonExpr which is split. Each thread sorts a block of its pairs and the sorted blocks
+	are then merged on the calling thread, so only the last few merges are not shared out
+
+	> ChooseSplit()
+	Returns the output index of the item of a container to descend into, or the container's length when the
+	container should be split itself. A container is split when it has at least as many items as there are threads,
+	otherwise its biggest JsonList or JsonExpr item is descended into if it has more items than the container
+
+	> SplitContainer()
+	Writes a JsonList or JsonExpr (one of 'list' and 'expr' is NULL) which the split container is inside of or is.
+	Everything before the split container goes to the prefix StringBuilder, its items are written by
+	DumpChunks() and everything after it goes to the suffix StringBuilder
+
+	> SerialiseJsonExprParts()
+	Serialises a JsonExpr on several threads and returns the output as SerialisedParts, which joined in order are
+	the same chars SerialiseJsonExprEx() returns
+
+	> SerialisedPartsDelete()
+	Frees a SerialisedParts object and its buffers
+
+	> SerialiseJsonExprParallel()
+	Serialises a JsonExpr on several threads and joins the parts into one string with one copy of each part
+
+	NOTES:
+
+	The document is split at one container: the top level JsonExpr, or the biggest JsonList or JsonExpr inside of it
+	when the top level has fewer items than there are threads (e.g., {"meta": {...}, "rows": [...]} is split at
+	"rows"). Only the one container is split, other big containers next to it are written by one thread. When keys
+	are sorted the split JsonExpr's pairs are sorted on the threads too, before its chunks are written
+
+	Every thread allocates with the calling thread's allocator (see JsonSelectAllocator()), which has to be safe to use
+	from several threads at once. The default allocator is, it only puts per thread node pools in front of malloc()
+*/
+
+#define JSON_PARALLEL_CHUNKS_PER_THREAD 8
+
+#ifdef _MSC_VER
+#define ChunkLock(dump) AcquireSRWLockExclusive(&(dump)->Lock)
+#define ChunkUnlock(dump) ReleaseSRWLockExclusive(&(dump)->Lock)
+#else
+#define ChunkLock(dump) pthread_mutex_lock(&(dump)->Lock)
+#define ChunkUnlock(dump) pthread_mutex_unlock(&(dump)->Lock)
+#endif
+
+typedef struct {
+	Serialiser Inner;
+	JsonList* List;
+	JsonExpr* Expr;
+	SortedPair* Pairs;
+	SortedPair* Scratch;
+	ullong Length;
+	int Threads;
+	int Sorting;
+	int Utf16;
+	StringBuilder* Prefix;
+	StringBuilder* Suffix;
+	StringBuilder** Chunks;
+	ullong ChunkCount;
+	ullong ChunkSize;
+	ullong NextChunk;
+	JsonAllocator* Allocator;
+#ifdef _MSC_VER
+	SRWLOCK Lock;
+#else
+	pthread_mutex_t Lock;
+#endif
+} ParallelDump;
+
+static int ProcessorCount() {
+#ifdef _MSC_VER
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (int)info.dwNumberOfProcessors;
+#else
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (int)count : 1;
+#endif
+}
+
+static void WriteChunk(ParallelDump* dump, ullong chunk) {
+	Serialiser serialiser = dump->Inner;
+	ullong start = chunk * dump->ChunkSize;
+	ullong end = start + dump->ChunkSize < dump->Length ? start + dump->ChunkSize : dump->Length;
+
+	serialiser.Builder = StringBuilderInit();
+
+	for (ullong i = start; i < end; i++) {
+		WriteItem(&serialiser, i);
+
+		if (dump->List != NULL) {
+			WriteListElement(&serialiser, dump->List, i);
+		}
+		else if (dump->Pairs != NULL) {
+			PrefetchSortedPairs(dump->Pairs, i, end);
+			WriteJsonPair(&serialiser, dump->Pairs[i].Pair);
+		}
+		else {
+			WriteJsonPair(&serialiser, &dump->Expr->Buffer[i]);
+		}
+	}
+
+	dump->Chunks[chunk] = serialiser.Builder;
+}
+
+static void SortChunk(ParallelDump* dump, ullong chunk) {
+	ullong start = chunk * dump->ChunkSize;
+	ullong end = start + dump->ChunkSize < dump->Length ? start + dump->ChunkSize : dump->Length;
+	SortedPair* pairs = dump->Pairs + start;
+
+	PrefixPairs(dump->Expr->Buffer + start, end - start, pairs, dump->Utf16);
+	SortedPair* sorted = MergeSortPairs(pairs, dump->Scratch + start, end - start, dump->Utf16);
+
+	if (sorted != pairs) {
+		memcpy(pairs, sorted, (end - start) * sizeof(SortedPair));
+	}
+}
+
+static void RunChunks(ParallelDump* dump) {
+	while (TRUE) {
+		ChunkLock(dump);
+		ullong chunk = dump->NextChunk++;
+		ChunkUnlock(dump);
+
+		if (chunk >= dump->ChunkCount) {
+			return;
+		}
+
+		if (dump->Sorting) {
+			SortChunk(dump, chunk);
+		}
+		else {
+			WriteChunk(dump, chunk);
+		}
+	}
+}
+
+#ifdef _MSC_VER
+static DWORD WINAPI ChunkWorker(void* data) {
+	ParallelDump* dump = data;
+	JsonSelectAllocator(dump->Allocator);
+	RunChunks(dump);
+
+	return 0;
+}
+#else
+static void* ChunkWorker(void* data) {
+	ParallelDump* dump = data;
+	JsonSelectAllocator(dump->Allocator);
+	RunChunks(dump);
+
+	return NULL;
+}
+#endif
+
+static void RunChunksOnThreads(ParallelDump* dump) {
+	ullong workers = dump->ChunkCount > 1 ? dump->ChunkCount - 1 : 0;
+	workers = workers < (ullong)dump->Threads - 1 ? workers : (ullong)dump->Threads - 1;
+
+#ifdef _MSC_VER
+	HANDLE* threads = JsonMalloc((workers > 0 ? workers : 1) * sizeof(HANDLE));
+#else
+	pthread_t* threads = JsonMalloc((workers > 0 ? workers : 1) * sizeof(pthread_t));
+#endif
+	ullong started = 0;
+
+	for (; started < workers; started++) {
+#ifdef _MSC_VER
+		threads[started] = CreateThread(NULL, 0, ChunkWorker, dump, 0, NULL);
+
+		if (threads[started] == NULL) {
+			break;
+		}
+#else
+		if (pthread_create(&threads[started], NULL, ChunkWorker, dump) != 0) {
+			break;
+		}
+#endif
+	}
+
+	RunChunks(dump);
+
+	for (ullong i = 0; i < started; i++) {
+#ifdef _MSC_VER
+		WaitForSingleObject(threads[i], INFINITE);
+		CloseHandle(threads[i]);
+#else
+		pthread_join(threads[i], NULL);
+#endif
+	}
+
+	JsonFree(threads);
+}
+
+static void DumpChunks(ParallelDump* dump) {
+	ullong chunks = (ullong)dump->Threads * JSON_PARALLEL_CHUNKS_PER_THREAD;
+
+	dump->ChunkSize = dump->Length > chunks ? (dump->Length + chunks - 1) / chunks : 1;
+	dump->ChunkCount = dump->Length > 0 ? (dump->Length + dump->ChunkSize - 1) / dump->ChunkSize : 0;
+	dump->Chunks = JsonCalloc(dump->ChunkCount > 0 ? dump->ChunkCount : 1, sizeof(StringBuilder*));
+	dump->NextChunk = 0;
+	dump->Sorting = FALSE;
+
+	RunChunksOnThreads(dump);
+}
+
+static SortedPair* SortPairsParallel(ParallelDump* dump, JsonExpr* expr, SortedPair** allocation, int utf16) {
+	*allocation = JsonMalloc(expr->Length * 2 * sizeof(SortedPair));
+
+	dump->Expr = expr;
+	dump->Pairs = *allocation;
+	dump->Scratch = *allocation + expr->Length;
+	dump->Length = expr->Length;
+	dump->Utf16 = utf16;
+	dump->ChunkSize = (expr->Length + dump->Threads - 1) / dump->Threads;
+	dump->ChunkCount = (expr->Length + dump->ChunkSize - 1) / dump->ChunkSize;
+	dump->NextChunk = 0;
+	dump->Sorting = TRUE;
+
+	RunChunksOnThreads(dump);
+
+	return MergeRuns(dump->Pairs, dump->Scratch, expr->Length, dump->ChunkSize, utf16);
+}
+
+static ullong ChooseSplit(ParallelDump* dump, JsonList* list, JsonExpr* expr, SortedPair* sorted) {
+	ullong length = list != NULL ? list->Length : expr->Length;
+	ullong split = length;
+	ullong biggest = length;
+
+	if (length >= (ullong)dump->Threads || (list != NULL && list->Packing != JSON_PACKED_NONE)) {
+		return length;
+	}
+
+	for (ullong i = 0; i < length; i++) {
+		JsonValue* value = list != NULL
+			? &list->Buffer[i]
+			: (sorted != NULL ? sorted[i].Pair : &expr->Buffer[i])->Value;
+		ullong size = 0;
+
+		if (value->Type == JSON_LIST) {
+			size = value->Data->List->Length;
+		}
+		else if (value->Type == JSON_EXPR) {
+			size = value->Data->Expr->Length;
+		}
+
+		if (size > biggest) {
+			biggest = size;
+			split = i;
+		}
+	}
+
+	return split;
+}
+
+static void SplitContainer(ParallelDump* dump, Serialiser* serialiser, JsonList* list, JsonExpr* expr) {
+	ullong length = list != NULL ? list->Length : expr->Length;
+	SortedPair stack[SORTED_PAIRS_STACK_SIZE];
+	SortedPair* allocation = NULL;
+	SortedPair* sorted = NULL;
+
+	if (expr != NULL && serialiser->SortKeys && length > 1) {
+		sorted = length < (ullong)dump->Threads
+			? SortPairs(expr, stack, &allocation, serialiser->Canonical)
+			: SortPairsParallel(dump, expr, &allocation, serialiser->Canonical);
+	}
+
+	ullong split = ChooseSplit(dump, list, expr, sorted);
+
+	StringBuilderAppendChar(serialiser->Builder, list != NULL ? '[' : '{');
+	serialiser->Depth++;
+
+	if (split == length) {
+		dump->Inner = *serialiser;
+		dump->List = list;
+		dump->Expr = expr;
+		dump->Pairs = sorted;
+		dump->Length = length;
+		DumpChunks(dump);
+
+		serialiser->Builder = dump->Suffix;
+		WriteClose(serialiser, length, list != NULL ? ']' : '}');
+		JsonFree(allocation);
+
+		return;
+	}
+
+	for (ullong i = 0; i < length; i++) {
+		WriteItem(serialiser, i);
+
+		JsonValue* value;
+
+		if (list != NULL) {
+			value = &list->Buffer[i];
+		}
+		else {
+			JsonPair* pair = sorted != NULL ? sorted[i].Pair : &expr->Buffer[i];
+			WriteJsonString(serialiser->Builder, pair->Key, pair->KeyLength, FALSE);
+			StringBuilderAppendBytes(serialiser->Builder, serialiser->KeySeparator, serialiser->KeySeparatorLength);
+			value = pair->Value;
+		}
+
+		if (i != split) {
+			WriteJsonValue(serialiser, value);
+		}
+		else if (value->Type == JSON_LIST) {
+			SplitContainer(dump, serialiser, value->Data->List, NULL);
+		}
+		else {
+			SplitContainer(dump, serialiser, NULL, value->Data->Expr);
+		}
+	}
+
+	WriteClose(serialiser, length, list != NULL ? ']' : '}');
+	JsonFree(allocation);
+}
+
+SerialisedParts* SerialiseJsonExprParts(JsonExpr* expr, const JsonDumpOptions* options, int threads) {
+	ParallelDump dump;
+	Serialiser serialiser;
+
+	dump.Threads = threads > 0 ? threads : ProcessorCount();
+	dump.Prefix = StringBuilderInit();
+	dump.Suffix = StringBuilderInit();
+	dump.Allocator = JsonGetAllocator();
+#ifdef _MSC_VER
+	InitializeSRWLock(&dump.Lock);
+#else
+	pthread_mutex_init(&dump.Lock, NULL);
+#endif
+
+	SerialiserInit(&serialiser, dump.Prefix, options);
+	SplitContainer(&dump, &serialiser, NULL, expr);
+
+#ifndef _MSC_VER
+	pthread_mutex_destroy(&dump.Lock);
+#endif
+
+	SerialisedParts* parts = JsonMalloc(sizeof(SerialisedParts));
+	parts->Count = dump.ChunkCount + 2;
+	parts->Buffers = JsonMalloc(parts->Count * sizeof(char*));
+	parts->Lengths = JsonMalloc(parts->Count * sizeof(ullong));
+
+	for (ullong i = 0; i < parts->Count; i++) {
+		StringBuilder* builder = i == 0
+			? dump.Prefix
+			: (i == parts->Count - 1 ? dump.Suffix : dump.Chunks[i - 1]);
+
+		parts->Buffers[i] = builder->Buffer;
+		parts->Lengths[i] = builder->Length;
+		JsonFree(builder);
+	}
+
+	JsonFree(dump.Chunks);
+	return parts;
+}
+
+void SerialisedPartsDelete(SerialisedParts* parts) {
+	for (ullong i = 0; i < parts->Count; i++) {
+		JsonFree(parts->Buffers[i]);
+	}
+
+	JsonFree(parts->Buffers);
+	JsonFree(parts->Lengths);
+	JsonFree(parts);
+}
+
+const char* SerialiseJsonExprParallel(JsonExpr* expr, const JsonDumpOptions* options, int threads) {
+	SerialisedParts* parts = SerialiseJsonExprParts(expr, options, threads);
+	ullong length = 0;
+
+	for (ullong i = 0; i < parts->Count; i++) {
+		length += parts->Lengths[i];
+	}
+
+	char* output = JsonMalloc(length + 1);
+	char* cursor = output;
+
+	for (ullong i = 0; i < parts->Count; i++) {
+		if (parts->Lengths[i] > 0) {
+			memcpy(cursor, parts->Buffers[i], parts->Lengths[i]);
+			cursor += parts->Lengths[i];
+		}
+	}
+
+	*cursor = '\0';
+	SerialisedPartsDelete(parts);
+
+	return output;
+}
+
+/*
+	Json Writer
+
+	MACROS:
+
+	> JSON_WRITER_BUFFER_SIZE
+	Size of the buffer a JsonWriter which writes to a sink or file descriptor collects output in before passing it on
+
+	FUNCTIONS:
+
+	> JsonWriterInit()
+	Creates a JsonWriter which writes into a buffer in memory, which JsonWriterFinish() returns
+
+	> JsonWriterInitSink()
+	Creates a JsonWriter which passes its output to a sink in chunks of JSON_WRITER_BUFFER_SIZE (see
+	StringBuilderInitSink())
+
+	> JsonWriterInitFd()
+	Creates a JsonWriter which writes to an open file descriptor (e.g., a pipe or socket), which is left open
+
+	> JsonWriterFlush()
+	Passes everything a sink JsonWriter has not passed on yet to its sink. Returns FAILURE if the sink ever failed,
+	and raises ERR_WRITE_FAILURE in the JsonWriter
+
+	> JsonWriterFinish()
+	Frees a JsonWriter made by JsonWriterInit() and returns what it wrote, which should be freed with JsonFree().
+	Returns NULL if a whole document was not written or if the JsonWriter raised an error
+
+	> InExpr()
+	Returns TRUE when the JsonWriter's current container is a JsonExpr, FALSE inside of a JsonList or at the top level
+
+	> WriterFail()
+	Raises ERR_INVALID_NESTING in a JsonWriter and returns FAILURE
+
+	> BeginValue()
+	Checks that a value may be written where the JsonWriter is and writes what goes in front of it. Returns FAILURE
+	if it may not (e.g., an expr is waiting for a key, or the document is already done)
+
+	> EndValue()
+	Updates the JsonWriter once a value has been written
+
+	> BeginContainer(), EndContainer()
+	Opens and closes a JsonList or JsonExpr, checking that EndContainer() closes the kind of container which is open
+
+	> JsonWriterBeginExpr(), JsonWriterEndExpr(), JsonWriterBeginList(), JsonWriterEndList()
+	Open and close a JsonExpr or JsonList
+
+	> JsonWriterKey(), JsonWriterKeyBytes()
+	Write the key of the next pair of a JsonExpr, a null terminated one or 'length' chars of one
+
+	> JsonWriterString(), JsonWriterStringBytes()
+	Write a string value, a null terminated one or 'length' chars of one
+
+	> JsonWriterInt(), JsonWriterFloat()
+	Write a number value
+
+	> JsonWriterTrue(), JsonWriterFalse(), JsonWriterNull()
+	Write a keyword value
+
+	> JsonWriterValue()
+	Writes a JsonValue which is already built (and everything inside of it) as one value
+
+	NOTES:
+
+	A JsonWriter writes a document one piece at a time without building JsonValues, so the only allocations are the
+	JsonWriter itself and its buffer. Everything goes through the same functions as SerialiseJsonExprEx() (strings
+	are escaped by WriteJsonString(), numbers are formatted by WriteJsonInt() and WriteJsonFloat()), so a JsonWriter
+	writes the same output as dumping the same document would
+
+	Every write function returns SUCCESS, or FAILURE without writing anything if the call does not fit where the
+	JsonWriter is in the document. The first such call raises an error in the JsonWriter, after which every call
+	fails. Check writer->Error before finishing to find out what went wrong
+
+	A JsonWriter never holds more than one pair, so it cannot sort keys. With SortKeys or Canonical set pairs are
+	still written in the order they are given, the caller has to give them in key order
+*/
+
+#define JSON_WRITER_BUFFER_SIZE (64 * 1024)
+
+static JsonWriter* WriterInit(StringBuilder* builder, const JsonDumpOptions* options) {
+	JsonWriter* writer = JsonCalloc(1, sizeof(JsonWriter));
+	SerialiserInit(&writer->Serialiser, builder, options);
+	writer->First = TRUE;
+	writer->ExpectValue = FALSE;
+	writer->Done = FALSE;
+	writer->Error = NO_ERROR;
+
+	return writer;
+}
+
+JsonWriter* JsonWriterInit(const JsonDumpOptions* options) {
+	return WriterInit(StringBuilderInit(), options);
+}
+
+JsonWriter* JsonWriterInitSink(StringBuilderSink sink, void* data, const JsonDumpOptions* options) {
+	return WriterInit(StringBuilderInitSink(sink, data, JSON_WRITER_BUFFER_SIZE), options);
+}
+
+JsonWriter* JsonWriterInitFd(int fd, const JsonDumpOptions* options) {
+	return JsonWriterInitSink(FdWriteSink, FileDescriptorData(fd), options);
+}
+
+int JsonWriterFlush(JsonWriter* writer) {
+	if (StringBuilderFlush(writer->Serialiser.Builder) == FAILURE) {
+		if (!writer->Error->Exists) {
+			RAISE_FATAL_ERROR(writer, ERR_WRITE_FAILURE);
+		}
+
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+char* JsonWriterFinish(JsonWriter* writer) {
+	StringBuilder* builder = writer->Serialiser.Builder;
+	char* result = NULL;
+
+	if (writer->Done && !writer->Error->Exists) {
+		result = StringBuilderFinish(builder);
+	}
+	else {
+		StringBuilderDelete(builder);
+	}
+
+	ErrorDelete(writer->Error);
+	JsonFree(writer);
+
+	return result;
+}
+
+static int InExpr(JsonWriter* writer) {
+	ullong depth = writer->Serialiser.Depth;
+	return depth > 0 && (writer->Nesting[(depth - 1) / 64] >> ((depth - 1) % 64) & 1);
+}
+
+static int WriterFail(JsonWriter* writer, const char* what) {
+	if (!writer->Error->Exists) {
+		RAISE_FATAL_ERROR(writer, ERR_INVALID_NESTING, what);
+	}
+
+	return FAILURE;
+}
+
+static int BeginValue(JsonWriter* writer) {
+	if (writer->Error->Exists || writer->Done) {
+		return WriterFail(writer, "a value");
+	}
+
+	if (InExpr(writer)) {
+		if (!writer->ExpectValue) {
+			return WriterFail(writer, "a value without a key");
+		}
+	}
+	else if (writer->Serialiser.Depth > 0) {
+		WriteItem(&writer->Serialiser, writer->First ? 0 : 1);
+	}
+
+	return SUCCESS;
+}
+
+static int EndValue(JsonWriter* writer) {
+	writer->First = FALSE;
+	writer->ExpectValue = FALSE;
+	writer->Done = writer->Serialiser.Depth == 0;
+
+	return SUCCESS;
+}
+
+static int BeginContainer(JsonWriter* writer, int expr) {
+	ullong depth = writer->Serialiser.Depth;
+
+	if (depth == JSON_WRITER_MAX_DEPTH) {
+		return WriterFail(writer, "a container nested this deep");
+	}
+
+	if (BeginValue(writer) == FAILURE) {
+		return FAILURE;
+	}
+
+	if (expr) {
+		writer->Nesting[depth / 64] |= 1ull << (depth % 64);
+	}
+	else {
+		writer->Nesting[depth / 64] &= ~(1ull << (depth % 64));
+	}
+
+	StringBuilderAppendChar(writer->Serialiser.Builder, expr ? '{' : '[');
+	writer->Serialiser.Depth++;
+	writer->First = TRUE;
+	writer->ExpectValue = FALSE;
+
+	return SUCCESS;
+}
+
+static int EndContainer(JsonWriter* writer, int expr) {
+	if (writer->Error->Exists || writer->Serialiser.Depth == 0 || InExpr(writer) != expr || writer->ExpectValue) {
+		return WriterFail(writer, expr ? "the end of an expr" : "the end of a list");
+	}
+
+	WriteClose(&writer->Serialiser, writer->First ? 0 : 1, expr ? '}' : ']');
+	return EndValue(writer);
+}
+
+int JsonWriterBeginExpr(JsonWriter* writer) {
+	return BeginContainer(writer, TRUE);
+}
+
+int JsonWriterEndExpr(JsonWriter* writer) {
+	return EndContainer(writer, TRUE);
+}
+
+int JsonWriterBeginList(JsonWriter* writer) {
+	return BeginContainer(writer, FALSE);
+}
+
+int JsonWriterEndList(JsonWriter* writer) {
+	return EndContainer(writer, FALSE);
+}
+
+int JsonWriterKey(JsonWriter* writer, const char* key) {
+	return JsonWriterKeyBytes(writer, key, strlen(key));
+}
+
+int JsonWriterKeyBytes(JsonWriter* writer, const char* key, ullong length) {
+	if (writer->Error->Exists || !InExpr(writer) || writer->ExpectValue) {
+		return WriterFail(writer, "a key");
+	}
+
+	Serialiser* serialiser = &writer->Serialiser;
+
+	WriteItem(serialiser, writer->First ? 0 : 1);
+	WriteJsonString(serialiser->Builder, key, length, FALSE);
+	StringBuilderAppendBytes(serialiser->Builder, serialiser->KeySeparator, serialiser->KeySeparatorLength);
+	writer->First = FALSE;
+	writer->ExpectValue = TRUE;
+
+	return SUCCESS;
+}
+
+int JsonWriterString(JsonWriter* writer, const char* string) {
+	return JsonWriterStringBytes(writer, string, strlen(string));
+}
+
+int JsonWriterStringBytes(JsonWriter* writer, const char* string, ullong length) {
+	if (BeginValue(writer) == FAILURE) {
+		return FAILURE;
+	}
+
+	WriteJsonString(writer->Serialiser.Builder, string, length, FALSE);
+	return EndValue(writer);
+}
+
+int JsonWriterInt(JsonWriter* writer, JsonInt integer) {
+	if (BeginValue(writer) == FAILURE) {
+		return FAILURE;
+	}
+
+	WriteJsonInt(&writer->Serialiser, integer);
+	return EndValue(writer);
+}
+
+int JsonWriterFloat(JsonWriter* writer, JsonFloat flt) {
+	if (BeginValue(writer) == FAILURE) {
+		return FAILURE;
+	}
+
+	WriteJsonFloat(&writer->Serialiser, flt);
+	return EndValue(writer);
+}
+
+int JsonWriterTrue(JsonWriter* writer) {
+	if (BeginValue(writer) == FAILURE) {
+		return FAILURE;
+	}
+
+	WriteKeyword(writer->Serialiser.Builder, JSON_TRUE);
+	return EndValue(writer);
+}
+
+int JsonWriterFalse(JsonWriter* writer) {
+	if (BeginValue(writer) == FAILURE) {
+		return FAILURE;
+	}
+
+	WriteKeyword(writer->Serialiser.Builder, JSON_FALSE);
+	return EndValue(writer);
+}
+
+int JsonWriterNull(JsonWriter* writer) {
+	if (BeginValue(writer) == FAILURE) {
+		return FAILURE;
+	}
+
+	WriteKeyword(writer->Serialiser.Builder, JSON_NULL);
+	return EndValue(writer);
+}
+
+int JsonWriterValue(JsonWriter* writer, JsonValue* value) {
+	if (BeginValue(writer) == FAILURE) {
+		return FAILURE;
+	}
+
+	WriteJsonValue(&writer->Serialiser, value);
+	return EndValue(writer);
+}
@@ -0,0 +1,267 @@
+#include <stdlib.h>
+#include <string.h>
+#include "include/shapes.h"
+#include "include/interning.h"
+
+#define TRUE 1
+#define FALSE 0
+
+/*
+	Json Shapes
+
+	FUNCTIONS:
+
+	> JsonShapeInit()
+	Creates a shape from the keys of a JsonExpr and makes the JsonExpr use it. The shape takes over the key strings
+	of the JsonExpr, so nothing is copied. The keys have to be either all interned or all owned by the JsonExpr, the
+	way the Parser creates them
+
+	> JsonShapeRetain()
+	Adds a reference to a shape and returns it
+
+	> JsonShapeRelease()
+	Removes a reference from a shape. The shape and its keys are freed once no JsonExpr uses it. 'shape' may be NULL
+
+	> JsonShapeGetSlot()
+	Gets the index of a key in a shape, which is also the index of its JsonPair in every JsonExpr using the shape
+	Returns SHAPE_SLOT_NOT_FOUND if the key is not part of the shape
+
+	> LastSlot
+	The shape, key hash and slot of the calling thread's last JsonShapeGetSlot() hit. Reading the same field from
+	many JsonExprs with the same shape only searches the keys once. The slot is checked against the key before it
+	is used, so a stale entry (e.g., the shape was freed and another one took its address) only costs a search
+
+	NOTES:
+
+	A JsonExpr which uses a shape (expr->Shape is set) keeps its pairs in the order of the shape's keys. Changing
+	the values is fine, but anything which adds or removes a pair first gives the JsonExpr its own copy of the keys
+	(see JsonPairArrayUnshape())
+
+	Only the key strings are shared. Every JsonPair keeps its Key pointer, KeyLength and KeyHash, so code which
+	reads JsonExpr.Buffer does not have to know about shapes
+
+	The reference counts are not atomic, JsonExprs which share a shape should be used from the same thread. Looking
+	keys up never writes to the shape, so several threads can read JsonExprs which share one
+*/
+
+typedef struct {
+	JsonShape* Shape;
+	ullong Hash;
+	ullong Slot;
+} ShapeSlotHint;
+
+static JSON_THREAD_LOCAL ShapeSlotHint LastSlot = { NULL, 0, 0 };
+
+static ullong ShapeHash(JsonExpr* expr) {
+	ullong hash = JSON_HASH_OFFSET;
+
+	for (ullong i = 0; i < expr->Length; i++) {
+		hash = (hash ^ expr->Buffer[i].KeyHash) * JSON_HASH_PRIME;
+	}
+
+	return (hash ^ expr->Length) * JSON_HASH_PRIME;
+}
+
+JsonShape* JsonShapeInit(JsonExpr* expr) {
+	JsonShape* shape = JsonCalloc(1, sizeof(JsonShape));
+	shape->RefCount = 1;
+	shape->Length = expr->Length;
+	shape->Keys = JsonMalloc(sizeof(JsonString) * expr->Length);
+	shape->KeyLengths = JsonMalloc(sizeof(ullong) * expr->Length);
+	shape->KeyHashes = JsonMalloc(sizeof(ullong) * expr->Length);
+	shape->KeysInterned = expr->Length > 0 && expr->Buffer[0].KeyInterned;
+	shape->Hash = ShapeHash(expr);
+
+	for (ullong i = 0; i < expr->Length; i++) {
+		shape->Keys[i] = expr->Buffer[i].Key;
+		shape->KeyLengths[i] = expr->Buffer[i].KeyLength;
+		shape->KeyHashes[i] = expr->Buffer[i].KeyHash;
+	}
+
+	expr->Shape = shape;
+	return shape;
+}
+
+JsonShape* JsonShapeRetain(JsonShape* shape) {
+	shape->RefCount++;
+	return shape;
+}
+
+void JsonShapeRelease(JsonShape* shape) {
+	if (shape == NULL || --shape->RefCount > 0) {
+		return;
+	}
+
+	for (ullong i = 0; i < shape->Length; i++) {
+		if (shape->KeysInterned) {
+			JsonStringRelease(shape->Keys[i]);
+		}
+		else {
+			JsonFree((char*)shape->Keys[i]);
+		}
+	}
+
+	JsonFree(shape->Keys);
+	JsonFree(shape->KeyLengths);
+	JsonFree(shape->KeyHashes);
+	JsonFree(shape);
+}
+
+ullong JsonShapeGetSlot(JsonShape* shape, const char* key, ullong length, ullong hash) {
+	ullong slot = LastSlot.Slot;
+
+	if (LastSlot.Shape == shape && LastSlot.Hash == hash && slot < shape->Length &&
+		shape->KeyLengths[slot] == length && memcmp(shape->Keys[slot], key, length) == 0) {
+		return slot;
+	}
+
+	for (ullong i = 0; i < shape->Length; i++) {
+		if (shape->KeyHashes[i] == hash && shape->KeyLengths[i] == length &&
+			memcmp(shape->Keys[i], key, length) == 0) {
+			LastSlot.Shape = shape;
+			LastSlot.Hash = hash;
+			LastSlot.Slot = i;
+			return i;
+		}
+	}
+
+	return SHAPE_SLOT_NOT_FOUND;
+}
+
+/*
+	Sharing Shapes
+
+	FUNCTIONS:
+
+	> JsonShapeTableInit()
+	Initialize a JsonShapeTable object
+
+	> JsonShapeTableDelete()
+	Deletes a JsonShapeTable object. The shapes in it stay alive for as long as JsonExprs use them
+
+	> JsonShapeTableShare()
+	Looks up the key sequence of a JsonExpr in the table. The first JsonExpr with a key sequence is only remembered,
+	the second one creates a shape from the first (see JsonShapeInit()) and every JsonExpr after that frees its own
+	keys and uses the shape. JsonExprs with a unique key sequence never get a shape
+
+	> ShapeKeysMatch()
+	Checks that two JsonExprs have the same keys in the same order, and that both or neither have interned keys
+
+	> ShapeAttach()
+	Makes a JsonExpr with the same keys as a shape use the shape and frees the JsonExpr's own key strings, or releases
+	them if they are interned
+
+	> ShapeTableGrow()
+	Doubles the capacity of a JsonShapeTable and reinserts its entries
+
+	NOTES:
+
+	The Parser keeps a JsonShapeTable while it parses when JsonHandler.ShareShapes is set. The table is an open
+	addressing hash table keyed on the hash of the key sequence, kept at most half full
+*/
+
+static int ShapeKeysMatch(JsonExpr* expr1, JsonExpr* expr2) {
+	if (expr1->Length != expr2->Length) {
+		return FALSE;
+	}
+
+	for (ullong i = 0; i < expr1->Length; i++) {
+		JsonPair* pair1 = &expr1->Buffer[i];
+		JsonPair* pair2 = &expr2->Buffer[i];
+
+		if (pair1->KeyHash != pair2->KeyHash || pair1->KeyLength != pair2->KeyLength ||
+			pair1->KeyInterned != pair2->KeyInterned || memcmp(pair1->Key, pair2->Key, pair1->KeyLength) != 0) {
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+static void ShapeAttach(JsonShape* shape, JsonExpr* expr) {
+	for (ullong i = 0; i < expr->Length; i++) {
+		JsonPair* pair = &expr->Buffer[i];
+
+		if (pair->KeyInterned) {
+			JsonStringRelease(pair->Key);
+		}
+		else {
+			JsonFree((char*)pair->Key);
+		}
+
+		pair->Key = shape->Keys[i];
+	}
+
+	expr->Shape = JsonShapeRetain(shape);
+}
+
+static void ShapeTableGrow(JsonShapeTable* table) {
+	JsonShapeEntry* entries = table->Buffer;
+	ullong capacity = table->Capacity;
+
+	table->Capacity = capacity > 0 ? capacity * 2 : 64;
+	table->Buffer = JsonCalloc(table->Capacity, sizeof(JsonShapeEntry));
+
+	for (ullong i = 0; i < capacity; i++) {
+		if (entries[i].First == NULL) {
+			continue;
+		}
+
+		ullong index = entries[i].Hash & (table->Capacity - 1);
+
+		while (table->Buffer[index].First != NULL) {
+			index = (index + 1) & (table->Capacity - 1);
+		}
+
+		table->Buffer[index] = entries[i];
+	}
+
+	JsonFree(entries);
+}
+
+JsonShapeTable* JsonShapeTableInit() {
+	JsonShapeTable* table = JsonCalloc(1, sizeof(JsonShapeTable));
+	table->Buffer = NULL;
+	table->Length = 0;
+	table->Capacity = 0;
+
+	return table;
+}
+
+void JsonShapeTableDelete(JsonShapeTable* table) {
+	JsonFree(table->Buffer);
+	JsonFree(table);
+}
+
+void JsonShapeTableShare(JsonShapeTable* table, JsonExpr* expr) {
+	if (expr->Length == 0 || expr->Shape != NULL) {
+		return;
+	}
+
+	if ((table->Length + 1) * 2 > table->Capacity) {
+		ShapeTableGrow(table);
+	}
+
+	ullong hash = ShapeHash(expr);
+	ullong index = hash & (table->Capacity - 1);
+
+	while (table->Buffer[index].First != NULL) {
+		JsonShapeEntry* entry = &table->Buffer[index];
+
+		if (entry->Hash == hash && ShapeKeysMatch(entry->First, expr)) {
+			if (entry->Shape == NULL) {
+				entry->Shape = JsonShapeInit(entry->First);
+			}
+
+			ShapeAttach(entry->Shape, expr);
+			return;
+		}
+
+		index = (index + 1) & (table->Capacity - 1);
+	}
+
+	table->Buffer[index].Hash = hash;
+	table->Buffer[index].First = expr;
+	table->Buffer[index].Shape = NULL;
+	table->Length++;
+}